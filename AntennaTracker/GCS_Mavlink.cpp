@@ -264,6 +264,13 @@ const AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
     // @Increment: 1
     // @User: Advanced
     AP_GROUPINFO("PARAMS",   8, GCS_MAVLINK_Parameters, streamRates[8],  10),
+
+    // @Param: PRIO
+    // @DisplayName: Priority streams
+    // @Description: Bitmask of streams which are slowed down last when the link does not have the bandwidth for all of the streams. The other streams are slowed down first, and the priority streams are the first to speed up again once bandwidth is available
+    // @Bitmask: 0:RAW_SENS,1:EXT_STAT,2:RC_CHAN,3:RAW_CTRL,4:POSITION,5:EXTRA1,6:EXTRA2,7:EXTRA3,8:PARAMS,9:ADSB
+    // @User: Advanced
+    AP_GROUPINFO("PRIO",    10, GCS_MAVLINK_Parameters, priority_streams,  50),
     AP_GROUPEND
 };
 
@@ -2,6 +2,8 @@
 
 #include <fcntl.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -29,22 +31,242 @@ AP_LoggerFileReader::~AP_LoggerFileReader()
     const uint64_t delta = micros - start_micros;
     ::printf("Replay counts: %" PRIu64 " bytes  %u entries\n", bytes_read, message_count);
     ::printf("Replay rates: %" PRIu64 " bytes/second  %" PRIu64 " messages/second\n", bytes_read*1000000/delta, message_count*1000000/delta);
+
+    if (log_data != nullptr) {
+        munmap((void *)log_data, log_size);
+    }
+    for (uint16_t i=0; i<LOGREADER_MAX_FORMATS; i++) {
+        free(type_indexes[i].offsets);
+    }
+    free(time_index);
 }
 
 bool AP_LoggerFileReader::open_log(const char *logfile)
 {
-    fd = ::open(logfile, O_RDONLY|O_CLOEXEC);
+    const int fd = ::open(logfile, O_RDONLY|O_CLOEXEC);
     if (fd == -1) {
         return false;
     }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void *data = nullptr;
+    if (st.st_size > 0) {
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (data != nullptr) {
+        // most reads are sequential, seeks are rare
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+    }
+    log_data = (const uint8_t *)data;
+    log_size = st.st_size;
+    log_offset = 0;
+    return true;
+}
+
+/*
+  record a format, noting whether its messages start with a TimeUS
+  field which can be used for the time index
+ */
+void AP_LoggerFileReader::add_format(const struct log_Format &f)
+{
+    memcpy(&formats[f.type], &f, sizeof(formats[f.type]));
+
+    const size_t len = strlen("TimeUS");
+    has_time_us[f.type] = (f.format[0] == 'Q' &&
+                           f.length >= 3 + sizeof(uint64_t) &&
+                           strncmp(f.labels, "TimeUS", len) == 0 &&
+                           (f.labels[len] == ',' || f.labels[len] == 0));
+}
+
+/*
+  get the length of the message at an offset, returning false at the
+  end of the log or if the message is bad
+ */
+bool AP_LoggerFileReader::message_length(size_t ofs, uint8_t &length) const
+{
+    if (ofs + 3 > log_size) {
+        return false;
+    }
+    const uint8_t *hdr = &log_data[ofs];
+    if (hdr[0] != HEAD_BYTE1 || hdr[1] != HEAD_BYTE2) {
+        printf("bad log header\n");
+        return false;
+    }
+    if (hdr[2] == LOG_FORMAT_MSG) {
+        length = sizeof(struct log_Format);
+    } else {
+        length = formats[hdr[2]].length;
+        if (length == 0) {
+            // can't just throw these away as the format specifies the
+            // number of bytes in the message
+            ::printf("No format defined for type (%d)\n", hdr[2]);
+            exit(1);
+        }
+    }
+    return ofs + length <= log_size;
+}
+
+bool AP_LoggerFileReader::add_to_type_index(uint8_t type, uint32_t ofs)
+{
+    type_index &idx = type_indexes[type];
+    if (idx.count == idx.allocated) {
+        const uint32_t new_allocated = MAX(idx.allocated * 2, 1024U);
+        uint32_t *offsets = (uint32_t *)realloc(idx.offsets, new_allocated * sizeof(uint32_t));
+        if (offsets == nullptr) {
+            return false;
+        }
+        idx.offsets = offsets;
+        idx.allocated = new_allocated;
+    }
+    idx.offsets[idx.count++] = ofs;
+    return true;
+}
+
+bool AP_LoggerFileReader::add_to_time_index(uint64_t time_us, uint32_t ofs)
+{
+    if (time_index_count == time_index_allocated) {
+        const uint32_t new_allocated = MAX(time_index_allocated * 2, 1024U);
+        time_index_entry *entries = (time_index_entry *)realloc(time_index, new_allocated * sizeof(time_index_entry));
+        if (entries == nullptr) {
+            return false;
+        }
+        time_index = entries;
+        time_index_allocated = new_allocated;
+    }
+    time_index[time_index_count++] = { time_us, ofs };
+    return true;
+}
+
+/*
+  make a pass over the whole log recording where each message is
+ */
+bool AP_LoggerFileReader::build_index()
+{
+    if (indexed) {
+        return true;
+    }
+    if (log_size > UINT32_MAX) {
+        ::printf("Log too large to index\n");
+        return false;
+    }
+
+    const uint64_t start_us = now();
+    uint64_t last_time_us = 0;
+    uint32_t count = 0;
+    size_t ofs = 0;
+    uint8_t length;
+    while (message_length(ofs, length)) {
+        const uint8_t *msg = &log_data[ofs];
+        const uint8_t type = msg[2];
+        if (type == LOG_FORMAT_MSG) {
+            struct log_Format f;
+            memcpy(&f, msg, sizeof(f));
+            add_format(f);
+        } else if (has_time_us[type]) {
+            // TimeUS follows the 3 byte header
+            uint64_t time_us;
+            memcpy(&time_us, &msg[3], sizeof(time_us));
+            // only ever move forward so the index can be searched
+            if (time_index_count == 0 || time_us >= last_time_us + LOGREADER_TIME_INDEX_INTERVAL_US) {
+                if (!add_to_time_index(time_us, ofs)) {
+                    return false;
+                }
+                last_time_us = time_us;
+            }
+        }
+        if (!add_to_type_index(type, ofs)) {
+            return false;
+        }
+        count++;
+        ofs += length;
+    }
+    indexed = true;
+
+    ::printf("Indexed %u messages in %.2f seconds\n", (unsigned)count, (now() - start_us)*1.0e-6f);
+    return true;
+}
+
+uint32_t AP_LoggerFileReader::indexed_count(uint8_t type) const
+{
+    return type_indexes[type].count;
+}
+
+const uint8_t *AP_LoggerFileReader::indexed_message(uint8_t type, uint32_t n) const
+{
+    if (n >= type_indexes[type].count) {
+        return nullptr;
+    }
+    return &log_data[type_indexes[type].offsets[n]];
+}
+
+bool AP_LoggerFileReader::indexed_time_range(uint64_t &start_us, uint64_t &end_us) const
+{
+    if (time_index_count == 0) {
+        return false;
+    }
+    start_us = time_index[0].time_us;
+    end_us = time_index[time_index_count-1].time_us;
     return true;
 }
 
-ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
+bool AP_LoggerFileReader::seek_time(uint64_t time_us, const char *const keep_types[])
 {
-    uint64_t ret = ::read(fd, buffer, count);
-    bytes_read += ret;
-    return ret;
+    if (!build_index() || time_index_count == 0) {
+        return false;
+    }
+
+    // find the first index entry at or after time_us
+    uint32_t lo = 0;
+    uint32_t hi = time_index_count;
+    while (lo < hi) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (time_index[mid].time_us < time_us) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == time_index_count) {
+        return false;
+    }
+    const size_t target = time_index[lo].offset;
+
+    if (target > log_offset) {
+        // all formats are known once the log is indexed
+        bool keep[LOGREADER_MAX_FORMATS] {};
+        keep[LOG_FORMAT_MSG] = true;
+        for (uint16_t i=0; i<LOGREADER_MAX_FORMATS; i++) {
+            for (uint8_t k=0; keep_types != nullptr && keep_types[k] != nullptr; k++) {
+                if (formats[i].length != 0 && strncmp(formats[i].name, keep_types[k], 4) == 0) {
+                    keep[i] = true;
+                }
+            }
+        }
+        for (size_t ofs = log_offset; ofs < target; ) {
+            uint8_t length;
+            if (!message_length(ofs, length)) {
+                return false;
+            }
+            if (keep[log_data[ofs+2]]) {
+                char type[5];
+                uint8_t core;
+                if (!process_message(ofs, type, core)) {
+                    return false;
+                }
+            }
+            ofs += length;
+        }
+    }
+
+    log_offset = target;
+    return true;
 }
 
 void AP_LoggerFileReader::format_type(uint16_t type, char dest[5])
@@ -63,49 +285,45 @@ void AP_LoggerFileReader::get_packet_counts(uint64_t dest[])
 
 bool AP_LoggerFileReader::update(char type[5], uint8_t &core)
 {
-    uint8_t hdr[3];
-    if (read_input(hdr, 3) != 3) {
-        return false;
-    }
-    if (hdr[0] != HEAD_BYTE1 || hdr[1] != HEAD_BYTE2) {
-        printf("bad log header\n");
+    const size_t ofs = log_offset;
+    uint8_t length;
+    if (!message_length(ofs, length)) {
         return false;
     }
+    log_offset += length;
+    bytes_read += length;
 
-    packet_counts[hdr[2]]++;
+    return process_message(ofs, type, core);
+}
 
-    if (hdr[2] == LOG_FORMAT_MSG) {
+/*
+  pass the message at an offset to the handlers
+ */
+bool AP_LoggerFileReader::process_message(size_t ofs, char type[5], uint8_t &core)
+{
+    const uint8_t *data = &log_data[ofs];
+
+    packet_counts[data[2]]++;
+    message_count++;
+
+    if (data[2] == LOG_FORMAT_MSG) {
         struct log_Format f;
-        memcpy(&f, hdr, 3);
-        if (read_input(&f.type, sizeof(f)-3) != sizeof(f)-3) {
-            return false;
-        }
-        memcpy(&formats[f.type], &f, sizeof(formats[f.type]));
+        memcpy(&f, data, sizeof(f));
+        add_format(f);
         strncpy(type, "FMT", 3);
         type[3] = 0;
 
-        message_count++;
         return handle_log_format_msg(f);
     }
 
-    const struct log_Format &f = formats[hdr[2]];
-    if (f.length == 0) {
-        // can't just throw these away as the format specifies the
-        // number of bytes in the message
-        ::printf("No format defined for type (%d)\n", hdr[2]);
-        exit(1);
-    }
+    const struct log_Format &f = formats[data[2]];
 
+    // the handlers may modify the message, the mapping is read-only
     uint8_t msg[f.length];
-
-    memcpy(msg, hdr, 3);
-    if (read_input(&msg[3], f.length-3) != f.length-3) {
-        return false;
-    }
+    memcpy(msg, data, f.length);
 
     strncpy(type, f.name, 4);
     type[4] = 0;
 
-    message_count++;
     return handle_msg(f, msg, core);
 }
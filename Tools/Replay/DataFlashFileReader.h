@@ -4,6 +4,15 @@
 
 #define LOGREADER_MAX_FORMATS 255 // must be >= highest MESSAGE
 
+// log time between entries in the time index
+#define LOGREADER_TIME_INDEX_INTERVAL_US 100000
+
+/*
+  the log is memory mapped and read in place. build_index() makes a
+  first pass over the log recording the offset of every message by
+  type and a sparse timestamp index, allowing random access to
+  messages and seeking to a time without reparsing the log.
+ */
 class AP_LoggerFileReader
 {
 public:
@@ -20,17 +29,61 @@ public:
     void format_type(uint16_t type, char dest[5]);
     void get_packet_counts(uint64_t dest[]);
 
-protected:
-    int fd = -1;
+    // index the offsets of all messages by type and by time
+    bool build_index();
+
+    // number of messages of a type in the index
+    uint32_t indexed_count(uint8_t type) const;
+
+    // return the n'th message of a type from the index, nullptr if
+    // out of range
+    const uint8_t *indexed_message(uint8_t type, uint32_t n) const;
+
+    // move the read position to the first indexed message at or
+    // after time_us. The formats and any messages of the keep_types
+    // ahead of that point are passed to the handlers first, so
+    // e.g. parameters are set before replay resumes
+    bool seek_time(uint64_t time_us, const char *const keep_types[]);
+
+    // time of first and last entries in the time index
+    bool indexed_time_range(uint64_t &start_us, uint64_t &end_us) const;
 
+protected:
     struct log_Format formats[LOGREADER_MAX_FORMATS] {};
 
 private:
-    ssize_t read_input(void *buf, size_t count);
+    const uint8_t *log_data = nullptr;
+    size_t log_size = 0;
+    size_t log_offset = 0;
 
     uint64_t bytes_read = 0;
     uint32_t message_count = 0;
     uint64_t start_micros;
 
     uint64_t packet_counts[LOGREADER_MAX_FORMATS] = {};
+
+    // formats whose first field is TimeUS, set as the FMT is seen
+    bool has_time_us[LOGREADER_MAX_FORMATS] {};
+
+    // offsets of each message of a type. Offsets are 32 bit as logs
+    // are limited to 4GB by FAT filesystems
+    struct type_index {
+        uint32_t *offsets;
+        uint32_t count;
+        uint32_t allocated;
+    } type_indexes[LOGREADER_MAX_FORMATS] {};
+
+    struct time_index_entry {
+        uint64_t time_us;
+        uint32_t offset;
+    } *time_index = nullptr;
+    uint32_t time_index_count = 0;
+    uint32_t time_index_allocated = 0;
+    bool indexed = false;
+
+    void add_format(const struct log_Format &f);
+    bool message_length(size_t ofs, uint8_t &length) const;
+    bool add_to_type_index(uint8_t type, uint32_t ofs);
+    bool add_to_time_index(uint64_t time_us, uint32_t ofs);
+    bool process_message(size_t ofs, char type[5], uint8_t &core);
 };
@@ -67,15 +67,22 @@ void MsgHandler::init_field_types()
 
 struct MsgHandler::format_field_info *MsgHandler::find_field_info(const char *label)
 {
+    const uint8_t slot = (uintptr_t(label) >> 2) % ARRAY_SIZE(label_cache);
+    if (label_cache[slot].label == label &&
+        streq(label_cache[slot].info->label, label)) {
+        return label_cache[slot].info;
+    }
     for(uint8_t i=0; i<next_field; i++) {
         if (streq(field_info[i].label, label)) {
+            label_cache[slot].label = label;
+            label_cache[slot].info = &field_info[i];
             return &field_info[i];
         }
     }
     return NULL;
 }
 
-MsgHandler::MsgHandler(const struct log_Format &_f) : next_field(0), f(_f)
+MsgHandler::MsgHandler(const struct log_Format &_f) : next_field(0), label_cache{}, f(_f)
 {
     init_field_types();
     parse_format_fields();
@@ -66,6 +66,13 @@ private:
 
     struct format_field_info *find_field_info(const char *label);
 
+    // field lookups by label address, labels are nearly always
+    // string literals so this avoids a search per field per message
+    struct {
+        const char *label;
+        struct format_field_info *info;
+    } label_cache[16];
+
     void parse_format_fields();
     void init_field_types();
     void add_field_type(char type, size_t size);
@@ -31,6 +31,12 @@
 
 #include <AP_Camera/AP_Camera.h>
 
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 #include <SITL/SITL.h>
 #endif
@@ -177,6 +183,16 @@ void Replay::usage(void)
     ::printf("\t--no-params        don't use parameters from the log\n");
     ::printf("\t--no-fpe           do not generate floating point exceptions\n");
     ::printf("\t--packet-counts    print packet counts at end of processing\n");
+    ::printf("\t--start-time SECS  start replay at SECS seconds into the log\n");
+    ::printf("\t--summary FILE     write innovation and lane switch summary to FILE\n");
+    ::printf("\t--output-dir DIR   write all output into DIR\n");
+    ::printf("\t--batch-list FILE  replay the logs listed in FILE, one per line\n");
+    ::printf("\t--batch-dir DIR    output directory for batch replays (default replay_batch)\n");
+    ::printf("\t--jobs N           number of logs to replay in parallel (default one per CPU)\n");
+    ::printf("\nIf more than one log is given they are replayed in parallel, each in\n");
+    ::printf("its own process, with the output and summary for each log in a\n");
+    ::printf("subdirectory of the batch directory. At most 255 arguments can be\n");
+    ::printf("given, so list the logs of large batches in a file with --batch-list\n");
 }
 
 
@@ -193,6 +209,12 @@ enum {
     OPT_PARAM_FILE,
     OPT_NO_FPE,
     OPT_PACKET_COUNTS,
+    OPT_START_TIME,
+    OPT_SUMMARY,
+    OPT_OUTPUT_DIR,
+    OPT_BATCH_LIST,
+    OPT_BATCH_DIR,
+    OPT_JOBS,
 };
 
 void Replay::flush_logger(void) {
@@ -250,13 +272,23 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"no-params",       false,  0, OPT_NOPARAMS},
         {"no-fpe",          false,  0, OPT_NO_FPE},
         {"packet-counts",   false,  0, OPT_PACKET_COUNTS},
+        {"start-time",      true,   0, OPT_START_TIME},
+        {"summary",         true,   0, OPT_SUMMARY},
+        {"output-dir",      true,   0, OPT_OUTPUT_DIR},
+        {"batch-list",      true,   0, OPT_BATCH_LIST},
+        {"batch-dir",       true,   0, OPT_BATCH_DIR},
+        {"jobs",            true,   0, OPT_JOBS},
         {0, false, 0, 0}
     };
 
     GetOptLong gopt(argc, argv, "r:p:ha:g:A:n", options);
 
+    batch_options = new const char *[argc];
+
     int opt;
+    uint8_t opt_start = gopt.optind;
     while ((opt = gopt.getoption()) != -1) {
+        bool batch_forward = true;
 		switch (opt) {
         case 'g':
             logreader.set_gyro_mask(strtol(gopt.optarg, NULL, 0));
@@ -337,18 +369,58 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             packet_counts = true;
             break;
 
+        case OPT_START_TIME:
+            start_time_s = atof(gopt.optarg);
+            break;
+
+        case OPT_SUMMARY:
+            summary_filename = gopt.optarg;
+            batch_forward = false;
+            break;
+
+        case OPT_OUTPUT_DIR:
+            output_dir = gopt.optarg;
+            batch_forward = false;
+            break;
+
+        case OPT_BATCH_LIST:
+            load_batch_list(gopt.optarg);
+            batch_forward = false;
+            break;
+
+        case OPT_BATCH_DIR:
+            batch_dir = gopt.optarg;
+            batch_forward = false;
+            break;
+
+        case OPT_JOBS:
+            batch_jobs = constrain_int32(atoi(gopt.optarg), 1, 255);
+            batch_forward = false;
+            break;
+
         case 'h':
         default:
             usage();
             exit(0);
         }
+
+        // remember the options to pass on to each log of a batch
+        if (batch_forward) {
+            for (uint8_t i=opt_start; i<gopt.optind; i++) {
+                batch_options[num_batch_options++] = argv[i];
+            }
+        }
+        opt_start = gopt.optind;
     }
 
 	argv += gopt.optind;
 	argc -= gopt.optind;
 
-    if (argc > 0) {
-        filename = argv[0];
+    for (uint8_t i=0; i<argc; i++) {
+        add_batch_log(argv[i]);
+    }
+    if (num_batch_logs > 0) {
+        filename = batch_logs[0];
     }
 }
 
@@ -528,12 +600,28 @@ void Replay::setup()
     ::printf("Starting\n");
 
     uint8_t argc;
-    char * const *argv;
+    char * const *argv = nullptr;
 
     hal.util->commandline_arguments(argc, argv);
 
+    // the HAL passes argc as a uint8_t, which wraps with more than 255
+    // arguments. argv is always terminated by a nullptr, so a wrapped
+    // count shows up as a non-null argv[argc]
+    if (argv != nullptr && argv[argc] != nullptr) {
+        ::printf("Too many arguments, use --batch-list for large batches\n");
+        exit(1);
+    }
+
     _parse_command_line(argc, argv);
 
+    if (num_batch_logs > 1) {
+        run_batch();
+    }
+
+    if (output_dir != nullptr) {
+        enter_output_dir();
+    }
+
     if (!check_generate) {
         logreader.set_save_chek_messages(true);
     }
@@ -577,6 +665,20 @@ void Replay::setup()
     }
     
     set_ins_update_rate(log_info.update_rate);
+
+    if (start_time_s > 0) {
+        // parameters and units from before the start are still needed
+        const char *keep_types[] = { "PARM", "UNIT", "MULT", "FMTU", nullptr };
+        // the start time is relative to the first timestamp in the log
+        uint64_t log_start_us, log_end_us;
+        if (!logreader.build_index() ||
+            !logreader.indexed_time_range(log_start_us, log_end_us) ||
+            !logreader.seek_time(log_start_us + uint64_t(start_time_s * 1.0e6), keep_types)) {
+            ::printf("Failed to seek to %.1f seconds\n", start_time_s);
+            exit(1);
+        }
+        ::printf("Starting at %.1f seconds\n", start_time_s);
+    }
 }
 
 void Replay::set_ins_update_rate(uint16_t _update_rate) {
@@ -734,6 +836,9 @@ void Replay::read_sensors(const char *type, uint8_t core)
                    (unsigned)ahrs_healthy,
                    (unsigned long)AP_HAL::millis());
         }
+        if (summary_filename != nullptr) {
+            update_summary();
+        }
         if (check_generate) {
             log_check_generate();
         } else if (check_solution) {
@@ -815,6 +920,10 @@ void Replay::flush_and_exit()
 {
     flush_logger();
 
+    if (summary_filename != nullptr) {
+        write_summary();
+    }
+
     if (check_solution) {
         report_checks();
     }
@@ -1002,6 +1111,367 @@ bool Replay::check_user_param(const char *name)
     return false;
 }
 
+/*
+  add a log to the list of logs to replay
+ */
+void Replay::add_batch_log(const char *log)
+{
+    char **logs = (char **)realloc(batch_logs, (num_batch_logs+1) * sizeof(char *));
+    if (logs == nullptr) {
+        ::printf("Out of memory adding log %s\n", log);
+        exit(1);
+    }
+    batch_logs = logs;
+    batch_logs[num_batch_logs++] = strdup(log);
+}
+
+/*
+  load a list of logs to replay from a file, one per line
+ */
+void Replay::load_batch_list(const char *list_filename)
+{
+    FILE *f = fopen(list_filename, "r");
+    if (f == NULL) {
+        printf("Failed to open batch list: %s\n", list_filename);
+        exit(1);
+    }
+    char line[PATH_MAX];
+
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (line[0] == '#' || line[0] == 0) {
+            continue;
+        }
+        add_batch_log(line);
+    }
+    fclose(f);
+}
+
+// monotonic wall clock time, the HAL clock is stopped in Replay
+static uint64_t wallclock_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000ULL + ts.tv_nsec/1000U;
+}
+
+/*
+  output directory for one log of a batch
+ */
+void Replay::batch_job_dir(uint16_t idx, char *dir, size_t len) const
+{
+    const char *log = batch_logs[idx];
+    const char *base = strrchr(log, '/');
+    snprintf(dir, len, "%s/%04u-%s", batch_dir, (unsigned)idx, base?base+1:log);
+}
+
+/*
+  start a child process replaying one log of a batch
+ */
+bool Replay::start_batch_job(uint16_t idx, pid_t &pid)
+{
+    char dir[PATH_MAX];
+    batch_job_dir(idx, dir, sizeof(dir));
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        ::printf("Failed to create %s: %s\n", dir, strerror(errno));
+        return false;
+    }
+    char out_path[PATH_MAX];
+    snprintf(out_path, sizeof(out_path), "%s/replay.out", dir);
+
+    // the "--" ends the HAL options
+    const char **args = new const char *[num_batch_options + 8];
+    uint16_t n = 0;
+    args[n++] = "Replay";
+    args[n++] = "--";
+    for (uint16_t i=0; i<num_batch_options; i++) {
+        args[n++] = batch_options[i];
+    }
+    args[n++] = "--output-dir";
+    args[n++] = dir;
+    args[n++] = "--summary";
+    args[n++] = "summary.txt";
+    args[n++] = batch_logs[idx];
+    args[n] = nullptr;
+
+    pid = fork();
+    if (pid == 0) {
+        // the HAL threads are not running in the child, so do no
+        // more than redirect the output before exec
+        const int fd = open(out_path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+        if (fd != -1) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execv("/proc/self/exe", (char * const *)args);
+        _exit(127);
+    }
+    delete[] args;
+
+    if (pid == -1) {
+        ::printf("Failed to start replay of %s: %s\n", batch_logs[idx], strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/*
+  replay all logs of a batch, running up to batch_jobs child processes
+  at once. Processes are used rather than threads as the vehicle,
+  AHRS and sensors are singletons. Each child runs with a stopped
+  clock so replays run as fast as the CPU allows
+ */
+void Replay::run_batch()
+{
+    if (batch_jobs == 0) {
+        batch_jobs = constrain_int32(sysconf(_SC_NPROCESSORS_ONLN), 1, 255);
+    }
+    if (mkdir(batch_dir, 0755) != 0 && errno != EEXIST) {
+        ::printf("Failed to create %s: %s\n", batch_dir, strerror(errno));
+        exit(1);
+    }
+
+    ::printf("Replaying %u logs, %u at a time, into %s\n",
+             (unsigned)num_batch_logs, (unsigned)batch_jobs, batch_dir);
+
+    int *status = new int[num_batch_logs];
+    float *elapsed = new float[num_batch_logs];
+    uint64_t *start_us = new uint64_t[num_batch_logs];
+    pid_t *pids = new pid_t[num_batch_logs];
+
+    const uint64_t batch_start_us = wallclock_us();
+    uint16_t next = 0;
+    uint16_t running = 0;
+    uint16_t finished = 0;
+    uint16_t failures = 0;
+
+    while (finished < num_batch_logs) {
+        while (running < batch_jobs && next < num_batch_logs) {
+            start_us[next] = wallclock_us();
+            if (start_batch_job(next, pids[next])) {
+                running++;
+            } else {
+                pids[next] = 0;
+                status[next] = -1;
+                elapsed[next] = 0;
+                finished++;
+                failures++;
+            }
+            next++;
+        }
+        if (running == 0) {
+            continue;
+        }
+
+        int wstatus;
+        const pid_t pid = wait(&wstatus);
+        if (pid == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::printf("wait failed: %s\n", strerror(errno));
+            exit(1);
+        }
+        for (uint16_t i=0; i<next; i++) {
+            if (pids[i] != pid) {
+                continue;
+            }
+            pids[i] = 0;
+            status[i] = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 128 + WTERMSIG(wstatus);
+            elapsed[i] = (wallclock_us() - start_us[i]) * 1.0e-6f;
+            running--;
+            finished++;
+            if (status[i] != 0) {
+                failures++;
+            }
+            ::printf("[%u/%u] %s %s (%.1fs)\n",
+                     (unsigned)finished, (unsigned)num_batch_logs,
+                     batch_logs[i],
+                     status[i] == 0 ? "OK" : "FAILED",
+                     elapsed[i]);
+            break;
+        }
+    }
+
+    const float total_elapsed = (wallclock_us() - batch_start_us) * 1.0e-6f;
+    write_batch_summary(status, elapsed, total_elapsed);
+
+    ::printf("Replayed %u logs in %.1fs, %u failed\n",
+             (unsigned)num_batch_logs, total_elapsed, (unsigned)failures);
+
+    delete[] status;
+    delete[] elapsed;
+    delete[] start_us;
+    delete[] pids;
+
+    ((Linux::Scheduler*)hal.scheduler)->teardown();
+
+    exit(failures == 0 ? 0 : 1);
+}
+
+/*
+  combine the summaries of each log of a batch into one file
+ */
+void Replay::write_batch_summary(const int *status, const float *elapsed, float total_elapsed)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/summary.txt", batch_dir);
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        ::printf("Failed to open %s: %s\n", path, strerror(errno));
+        return;
+    }
+    fprintf(f, "batch %u logs %.1fs\n", (unsigned)num_batch_logs, total_elapsed);
+    for (uint16_t i=0; i<num_batch_logs; i++) {
+        char dir[PATH_MAX];
+        batch_job_dir(i, dir, sizeof(dir));
+        fprintf(f, "\nreplay %s status %d time %.1fs output %s\n",
+                batch_logs[i], status[i], elapsed[i], dir);
+
+        snprintf(path, sizeof(path), "%s/summary.txt", dir);
+        FILE *s = fopen(path, "r");
+        if (s == NULL) {
+            continue;
+        }
+        char line[200];
+        while (fgets(line, sizeof(line), s)) {
+            fputs(line, f);
+        }
+        fclose(s);
+    }
+    fclose(f);
+}
+
+/*
+  move into the output directory, keeping the full path of the log
+ */
+void Replay::enter_output_dir()
+{
+    char *path = realpath(filename, nullptr);
+    if (path == nullptr) {
+        perror(filename);
+        exit(1);
+    }
+    filename = path;
+    if (mkdir(output_dir, 0755) != 0 && errno != EEXIST) {
+        ::printf("Failed to create %s: %s\n", output_dir, strerror(errno));
+        exit(1);
+    }
+    if (chdir(output_dir) != 0) {
+        ::printf("Failed to change to %s: %s\n", output_dir, strerror(errno));
+        exit(1);
+    }
+}
+
+/*
+  accumulate innovation statistics and lane switches for the summary
+ */
+void Replay::update_summary(void)
+{
+    update_ekf_summary(_vehicle.ahrs.EKF2, ekf2_summary);
+    update_ekf_summary(_vehicle.ahrs.EKF3, ekf3_summary);
+}
+
+template <typename EKF>
+void Replay::update_ekf_summary(const EKF &ekf, struct ekf_summary &summary)
+{
+    const uint8_t num_cores = MIN(ekf.activeCores(), REPLAY_SUMMARY_MAX_CORES);
+    if (num_cores == 0) {
+        return;
+    }
+    summary.num_cores = MAX(summary.num_cores, num_cores);
+
+    const int8_t primary = ekf.getPrimaryCoreIndex();
+    if (summary.have_primary && primary != summary.primary) {
+        if (summary.lane_switches < ARRAY_SIZE(summary.switches)) {
+            auto &sw = summary.switches[summary.lane_switches];
+            sw.time_ms = AP_HAL::millis();
+            sw.from = summary.primary;
+            sw.to = primary;
+        }
+        summary.lane_switches++;
+    }
+    summary.primary = primary;
+    summary.have_primary = true;
+
+    for (uint8_t i=0; i<num_cores; i++) {
+        Vector3f vel_innov, pos_innov, mag_innov;
+        float tas_innov, yaw_innov;
+        ekf.getInnovations(i, vel_innov, pos_innov, mag_innov, tas_innov, yaw_innov);
+
+        // the variances are returned as normalised test ratios
+        float vel_ratio, pos_ratio, hgt_ratio, tas_ratio;
+        Vector3f mag_ratio;
+        Vector2f offset;
+        ekf.getVariances(i, vel_ratio, pos_ratio, hgt_ratio, mag_ratio, tas_ratio, offset);
+
+        innovation_summary &c = summary.core[i];
+        c.count++;
+        c.sum_sq_vel += vel_innov.length_squared();
+        c.sum_sq_pos += sq(pos_innov.x) + sq(pos_innov.y);
+        c.sum_sq_hgt += sq(pos_innov.z);
+        c.sum_sq_mag += mag_innov.length_squared();
+        c.max_vel_ratio = MAX(c.max_vel_ratio, vel_ratio);
+        c.max_pos_ratio = MAX(c.max_pos_ratio, pos_ratio);
+        c.max_hgt_ratio = MAX(c.max_hgt_ratio, hgt_ratio);
+        c.max_mag_ratio = MAX(c.max_mag_ratio, mag_ratio.length());
+        c.max_tas_ratio = MAX(c.max_tas_ratio, tas_ratio);
+    }
+}
+
+void Replay::write_ekf_summary(FILE *f, const char *name, const struct ekf_summary &summary)
+{
+    if (summary.num_cores == 0) {
+        return;
+    }
+    fprintf(f, "%s cores %u lane_switches %u\n",
+            name, (unsigned)summary.num_cores, (unsigned)summary.lane_switches);
+    for (uint16_t i=0; i<MIN(summary.lane_switches, ARRAY_SIZE(summary.switches)); i++) {
+        fprintf(f, "%s switch %.3f %d %d\n",
+                name,
+                summary.switches[i].time_ms*0.001f,
+                summary.switches[i].from,
+                summary.switches[i].to);
+    }
+    for (uint8_t i=0; i<summary.num_cores; i++) {
+        const innovation_summary &c = summary.core[i];
+        if (c.count == 0) {
+            continue;
+        }
+        // RMS innovations and maximum test ratios
+        fprintf(f, "%s core %u n %u vel %.3f pos %.3f hgt %.3f mag %.4f"
+                " vel_tr %.2f pos_tr %.2f hgt_tr %.2f mag_tr %.2f tas_tr %.2f\n",
+                name, (unsigned)i, (unsigned)c.count,
+                sqrt(c.sum_sq_vel / c.count),
+                sqrt(c.sum_sq_pos / c.count),
+                sqrt(c.sum_sq_hgt / c.count),
+                sqrt(c.sum_sq_mag / c.count),
+                c.max_vel_ratio,
+                c.max_pos_ratio,
+                c.max_hgt_ratio,
+                c.max_mag_ratio,
+                c.max_tas_ratio);
+    }
+}
+
+/*
+  write the per-log summary of EKF innovations and lane switches
+ */
+void Replay::write_summary(void)
+{
+    FILE *f = fopen(summary_filename, "w");
+    if (f == NULL) {
+        ::printf("Failed to open %s: %s\n", summary_filename, strerror(errno));
+        return;
+    }
+    fprintf(f, "log %s\n", log_filename);
+    fprintf(f, "duration %.1f\n", AP_HAL::millis()*0.001f);
+    write_ekf_summary(f, "EKF2", ekf2_summary);
+    write_ekf_summary(f, "EKF3", ekf3_summary);
+    fclose(f);
+}
+
 const struct AP_Param::GroupInfo        GCS_MAVLINK_Parameters::var_info[] = {
     AP_GROUPEND
 };
@@ -49,6 +49,12 @@
 #include <unistd.h>
 #include <AP_HAL/utility/getopt_cpp.h>
 
+// maximum number of EKF cores tracked in the per-log summary
+#define REPLAY_SUMMARY_MAX_CORES 6
+
+// number of lane switches recorded individually in the per-log summary
+#define REPLAY_SUMMARY_MAX_SWITCHES 16
+
 class ReplayVehicle : public AP_Vehicle {
 public:
     friend class Replay;
@@ -156,6 +162,47 @@ private:
     uint32_t output_counter = 0;
     uint64_t last_timestamp = 0;
     bool packet_counts = false;
+    float start_time_s;
+
+    // batch mode, each log is replayed by a child process with its
+    // own output directory
+    char **batch_logs;
+    uint16_t num_batch_logs;
+    const char **batch_options;
+    uint16_t num_batch_options;
+    uint8_t batch_jobs;
+    const char *batch_dir = "replay_batch";
+
+    // directory to run in and file to write the per-log summary to
+    const char *output_dir;
+    const char *summary_filename;
+
+    // innovation statistics for one EKF core
+    struct innovation_summary {
+        uint32_t count;
+        double sum_sq_vel;
+        double sum_sq_pos;
+        double sum_sq_hgt;
+        double sum_sq_mag;
+        float max_vel_ratio;
+        float max_pos_ratio;
+        float max_hgt_ratio;
+        float max_mag_ratio;
+        float max_tas_ratio;
+    };
+
+    struct ekf_summary {
+        innovation_summary core[REPLAY_SUMMARY_MAX_CORES];
+        uint8_t num_cores;
+        int8_t primary;
+        bool have_primary;
+        uint16_t lane_switches;
+        struct {
+            uint32_t time_ms;
+            int8_t from;
+            int8_t to;
+        } switches[REPLAY_SUMMARY_MAX_SWITCHES];
+    } ekf2_summary, ekf3_summary;
 
     struct {
         float max_roll_error;
@@ -192,6 +239,18 @@ private:
     void load_param_file(const char *filename);
     void set_signal_handlers(void);
     void flush_and_exit();
+    void add_batch_log(const char *log);
+    void load_batch_list(const char *filename);
+    void run_batch();
+    bool start_batch_job(uint16_t idx, pid_t &pid);
+    void batch_job_dir(uint16_t idx, char *dir, size_t len) const;
+    void write_batch_summary(const int *status, const float *elapsed, float total_elapsed);
+    void enter_output_dir();
+    void update_summary();
+    template <typename EKF>
+    void update_ekf_summary(const EKF &ekf, struct ekf_summary &summary);
+    void write_summary();
+    void write_ekf_summary(FILE *f, const char *name, const struct ekf_summary &summary);
 
     FILE *xfopen(const char *f, const char *mode);
 
@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+'''
+decode the files written by IMU continuous capture (INS_LOG_BAT_OPT
+bit 2) into CSV, one line per sample
+
+The file format is described in libraries/AP_InertialSensor/BatchStream.h
+'''
+
+from __future__ import print_function
+
+import struct
+import sys
+from argparse import ArgumentParser
+
+FILE_MAGIC = 0x53425349
+FILE_VERSION = 1
+BLOCK_MAGIC = 0x4b42
+
+FILE_HEADER = struct.Struct("<IHH")
+BLOCK_HEADER = struct.Struct("<HBBBHQQH")
+FIRST_SAMPLE = struct.Struct("<hhh")
+
+SENSOR_TYPES = {0: "accel", 1: "gyro"}
+
+
+def decode_delta(data, ofs):
+    '''decode a zigzag encoded LEB128 varint, returning the value and the new offset'''
+    v = 0
+    shift = 0
+    while True:
+        if ofs >= len(data):
+            raise ValueError("truncated sample data")
+        b = data[ofs]
+        ofs += 1
+        v |= (b & 0x7f) << shift
+        shift += 7
+        if not b & 0x80:
+            break
+    return (v >> 1) ^ -(v & 1), ofs
+
+
+def decode_block(hdr, data):
+    '''return the samples in a block as a list of (time_us, x, y, z)'''
+    (magic, instance, stype, count, multiplier, first_us, last_us, data_len) = hdr
+    xyz = list(FIRST_SAMPLE.unpack_from(data, 0))
+    ofs = FIRST_SAMPLE.size
+    samples = [xyz[:]]
+    for i in range(1, count):
+        for axis in range(3):
+            delta, ofs = decode_delta(data, ofs)
+            xyz[axis] += delta
+        samples.append(xyz[:])
+    if ofs != data_len:
+        raise ValueError("block data length mismatch")
+
+    # samples are evenly spaced between the first and last sample times
+    ret = []
+    for i, s in enumerate(samples):
+        if count > 1:
+            t = first_us + (last_us - first_us) * i // (count - 1)
+        else:
+            t = first_us
+        ret.append((t, s[0] / float(multiplier), s[1] / float(multiplier), s[2] / float(multiplier)))
+    return ret
+
+
+def decode_file(filename, out, sensor_type=None, instance=None):
+    f = open(filename, 'rb')
+    data = bytearray(f.read())
+    f.close()
+
+    if len(data) < FILE_HEADER.size:
+        print("%s: too short" % filename, file=sys.stderr)
+        return
+    (magic, version, reserved) = FILE_HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC or version != FILE_VERSION:
+        print("%s: not an ISB file (magic 0x%08x version %u)" % (filename, magic, version), file=sys.stderr)
+        return
+
+    ofs = FILE_HEADER.size
+    while ofs + BLOCK_HEADER.size <= len(data):
+        hdr = BLOCK_HEADER.unpack_from(data, ofs)
+        if hdr[0] != BLOCK_MAGIC:
+            print("%s: bad block magic at offset %u" % (filename, ofs), file=sys.stderr)
+            return
+        ofs += BLOCK_HEADER.size
+        data_len = hdr[7]
+        block_data = data[ofs:ofs+data_len]
+        ofs += data_len
+        if len(block_data) < data_len:
+            # the file was cut short while being written
+            print("%s: truncated block at end of file" % filename, file=sys.stderr)
+            return
+        stype = SENSOR_TYPES.get(hdr[2], str(hdr[2]))
+        if sensor_type is not None and stype != sensor_type:
+            continue
+        if instance is not None and hdr[1] != instance:
+            continue
+        for (t, x, y, z) in decode_block(hdr, block_data):
+            out.write("%u,%s,%u,%f,%f,%f\n" % (t, stype, hdr[1], x, y, z))
+
+
+parser = ArgumentParser(description=__doc__)
+parser.add_argument("--type", choices=sorted(SENSOR_TYPES.values()), default=None, help="only output this sensor type")
+parser.add_argument("--instance", type=int, default=None, help="only output this IMU instance")
+parser.add_argument("--output", default=None, help="CSV file to write, default stdout")
+parser.add_argument("files", nargs='+', help="ISB files, in order")
+args = parser.parse_args()
+
+out = sys.stdout
+if args.output is not None:
+    out = open(args.output, 'w')
+
+out.write("TimeUS,Type,Instance,X,Y,Z\n")
+for filename in args.files:
+    decode_file(filename, out, sensor_type=args.type, instance=args.instance)
+
+if out is not sys.stdout:
+    out.close()
@@ -3,7 +3,7 @@
 unpack a param.pck file from @PARAM/param.pck via mavlink FTP
 '''
 
-import struct, sys
+import struct, sys, zlib
 
 from argparse import ArgumentParser
 parser = ArgumentParser(description=__doc__)
@@ -15,14 +15,25 @@ data = open(args.file,'rb').read()
 last_name = ""
 
 magic = 0x671b
+magic_compressed = 0x671c
 
 # header of 6 bytes
 magic2,num_params,total_params = struct.unpack("<HHH", data[0:6])
-if magic != magic2:
-    print("Bad magic 0x%x expected 0x%x" % (magic2, magic))
+if magic2 not in [magic, magic_compressed]:
+    print("Bad magic 0x%x expected 0x%x or 0x%x" % (magic2, magic, magic_compressed))
     sys.exit(1)
-
-data = data[6:]
+compressed = magic2 == magic_compressed
+
+if compressed:
+    # compressed files end with a CRC32 of the rest of the file
+    crc, = struct.unpack("<I", data[-4:])
+    crc2 = (~zlib.crc32(data[:-4], 0xFFFFFFFF)) & 0xFFFFFFFF
+    if crc != crc2:
+        print("Bad CRC 0x%08x expected 0x%08x" % (crc2, crc))
+        sys.exit(1)
+    data = data[6:-4]
+else:
+    data = data[6:]
 
 # mapping of data type to type length and format
 data_types = {
@@ -62,10 +73,16 @@ while True:
     name_len = ((plen>>4) & 0x0F) + 1
     common_len = (plen & 0x0F)
     name = last_name[0:common_len] + data[2:2+name_len].decode('utf-8')
+    if compressed and flags != 0:
+        # flags gives the length of the value
+        (type_len, type_format) = [(0, ''), (1, 'b'), (2, 'h')][flags-1]
     vdata = data[2+name_len:2+name_len+type_len]
     last_name = name
     data = data[2+name_len+type_len:]
-    v, = struct.unpack("<" + type_format, vdata)
+    if type_len == 0:
+        v = 0
+    else:
+        v, = struct.unpack("<" + type_format, vdata)
     count += 1
     print("%-16s %f" % (name, float(v)))
 
@@ -1,5 +1,6 @@
 #include "AC_AttitudeControl_Heli.h"
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Trace/AP_Trace.h>
 
 // table of user settable parameters
 const AP_Param::GroupInfo AC_AttitudeControl_Heli::var_info[] = {
@@ -317,6 +318,8 @@ void AC_AttitudeControl_Heli::input_rate_bf_roll_pitch_yaw(float roll_rate_bf_cd
 // should be called at 100hz or more
 void AC_AttitudeControl_Heli::rate_controller_run()
 {	
+    AP_TRACE_SCOPE("AC_RateController");
+
     _rate_target_ang_vel += _rate_sysid_ang_vel;
 
     Vector3f gyro_latest = _ahrs.get_gyro_latest();
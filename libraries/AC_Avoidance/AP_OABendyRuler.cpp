@@ -659,23 +659,6 @@ bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, co
         return false;
     }
 
-    // check each obstacle's distance from segment
-    float smallest_margin = FLT_MAX;
-    for (uint16_t i=0; i<oaDb->database_count(); i++) {
-        const AP_OADatabase::OA_DbItem& item = oaDb->get_item(i);
-        const Vector3f point_cm = item.pos * 100.0f;
-        // margin is distance between line segment and obstacle minus obstacle's radius
-        const float m = Vector3f::closest_distance_between_line_and_point(start_NEU, end_NEU, point_cm) * 0.01f - item.radius;
-        if (m < smallest_margin) {
-            smallest_margin = m;
-        }
-    }
-
-    // return smallest margin
-    if (smallest_margin < FLT_MAX) {
-        margin = smallest_margin;
-        return true;
-    }
-
-    return false;
+    // find smallest margin between segment and obstacles (in meters)
+    return oaDb->get_margin_to_segment(start_NEU * 0.01f, end_NEU * 0.01f, margin);
 }
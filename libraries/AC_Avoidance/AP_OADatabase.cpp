@@ -127,6 +127,9 @@ void AP_OADatabase::init()
         gcs().send_text(MAV_SEVERITY_INFO, "DB init failed . Sizes queue:%u, db:%u", (unsigned int)_queue.size, (unsigned int)_database.size);
         delete _queue.items;
         delete[] _database.items;
+        _database.grid.release();
+        _queue.items = nullptr;
+        _database.items = nullptr;
         return;
     }
 }
@@ -174,10 +177,7 @@ void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float
     }
 
     const OA_DbItem item = {pos, timestamp_ms, MAX(_radius_min, distance * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
-    {
-        WITH_SEMAPHORE(_queue.sem);
-        _queue.items->push(item);
-    }
+    _queue.items->push(item);
 }
 
 void AP_OADatabase::init_queue()
@@ -187,7 +187,7 @@ void AP_OADatabase::init_queue()
         return;
     }
 
-    _queue.items = new ObjectBuffer<OA_DbItem>(_queue.size);
+    _queue.items = new ObjectBuffer_LF<OA_DbItem>(_queue.size);
 }
 
 void AP_OADatabase::init_database()
@@ -198,6 +198,7 @@ void AP_OADatabase::init_database()
     }
 
     _database.items = new OA_DbItem[_database.size];
+    _database.grid.init(_database.size);
 }
 
 // get bitmask of gcs channels item should be sent to based on its importance
@@ -246,24 +247,23 @@ bool AP_OADatabase::process_queue()
     for (uint16_t queue_index=0; queue_index<queue_available; queue_index++) {
         OA_DbItem item;
 
-        bool pop_success;
-        {
-            WITH_SEMAPHORE(_queue.sem);
-            pop_success = _queue.items->pop(item);
-        }
-        if (!pop_success) {
+        if (!_queue.items->pop(item)) {
             return false;
         }
 
         item.send_to_gcs = get_send_to_gcs_flags(item.importance);
 
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
+        // compare item to nearby items in database. If found a similar item, update the existing, else add it as a new one
         bool found = false;
-        for (uint16_t i=0; i<_database.count; i++) {
-            if (is_close_to_item_in_database(i, item)) {
-                database_item_refresh(i, item.timestamp_ms, item.radius);
-                found = true;
-                break;
+        AP_OADatabaseGrid::Search search;
+        if (_database.grid.search_start(search, item.pos, item.pos, MAX(item.radius, _database.radius_max), _database.count)) {
+            uint16_t i;
+            while (!found && _database.grid.search_next(search, i)) {
+                found = refresh_if_close(i, item);
+            }
+        } else {
+            for (uint16_t i=0; i<_database.count && !found; i++) {
+                found = refresh_if_close(i, item);
             }
         }
 
@@ -281,6 +281,8 @@ void AP_OADatabase::database_item_add(const OA_DbItem &item)
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    _database.grid.insert(_database.count, item.pos);
+    _database.radius_max = MAX(_database.radius_max, item.radius);
     _database.count++;
 }
 
@@ -291,6 +293,8 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
         return;
     }
 
+    _database.grid.remove(index, _database.items[index].pos);
+
     // radius of 0 tells the GCS we don't care about it any more (aka it expired)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
@@ -302,8 +306,10 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
 
     if (index != _database.count) {
         // copy last object in array over expired object
+        _database.grid.remove(_database.count, _database.items[_database.count].pos);
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        _database.grid.insert(index, _database.items[index].pos);
     }
 }
 
@@ -324,6 +330,7 @@ void AP_OADatabase::database_item_refresh(const uint16_t index, const uint32_t t
         _database.items[index].timestamp_ms = timestamp_ms;
         _database.items[index].radius = radius;
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        _database.radius_max = MAX(_database.radius_max, radius);
     }
 }
 
@@ -340,13 +347,18 @@ void AP_OADatabase::database_items_remove_all_expired()
     const uint32_t now_ms = AP_HAL::millis();
     const uint32_t expiry_ms = (uint32_t)_database_expiry_seconds * 1000;
     uint16_t index = 0;
+    float radius_max = 0.0f;
     while (index < _database.count) {
         if (now_ms - _database.items[index].timestamp_ms > expiry_ms) {
             database_item_remove(index);
         } else {
+            radius_max = MAX(radius_max, _database.items[index].radius);
             index++;
         }
     }
+
+    // shrink the search range used by the grid as large objects expire
+    _database.radius_max = radius_max;
 }
 
 // returns true if a similar object already exists in database. When true, the object timer is also reset
@@ -361,6 +373,60 @@ bool AP_OADatabase::is_close_to_item_in_database(const uint16_t index, const OA_
     return ((distance_sq < sq(item.radius)) || (distance_sq < sq(_database.items[index].radius)));
 }
 
+// refresh database item "index" from "item" if they are close.  returns true if they are close
+bool AP_OADatabase::refresh_if_close(const uint16_t index, const OA_DbItem &item)
+{
+    if (!is_close_to_item_in_database(index, item)) {
+        return false;
+    }
+    database_item_refresh(index, item.timestamp_ms, item.radius);
+    return true;
+}
+
+// margin between the line segment from start to end and database item "index"
+float AP_OADatabase::margin_to_item(const uint16_t index, const Vector3f &start, const Vector3f &end) const
+{
+    const OA_DbItem &item = _database.items[index];
+    return Vector3f::closest_distance_between_line_and_point(start, end, item.pos) - item.radius;
+}
+
+// calculate the smallest margin between a line segment and the objects in the database.  start and end are offsets
+// in meters from the EKF origin.  The margin is the distance from the segment to the object's position less its radius
+// returns false if there are no objects
+bool AP_OADatabase::get_margin_to_segment(const Vector3f &start, const Vector3f &end, float &margin) const
+{
+    if (!healthy() || (_database.count == 0)) {
+        return false;
+    }
+
+    // search the cells near the segment, widening the search until no object
+    // outside the searched area could have a smaller margin
+    float smallest_margin;
+    float range = AP_OADATABASE_GRID_CELL_SIZE;
+    while (true) {
+        smallest_margin = FLT_MAX;
+        AP_OADatabaseGrid::Search search;
+        if (!_database.grid.search_start(search, start, end, range, _database.count)) {
+            for (uint16_t i=0; i<_database.count; i++) {
+                smallest_margin = MIN(smallest_margin, margin_to_item(i, start, end));
+            }
+            break;
+        }
+        uint16_t i;
+        while (_database.grid.search_next(search, i)) {
+            smallest_margin = MIN(smallest_margin, margin_to_item(i, start, end));
+        }
+        // objects outside the searched area have a margin of at least range - radius_max
+        if (smallest_margin <= range - _database.radius_max) {
+            break;
+        }
+        range *= 2.0f;
+    }
+
+    margin = smallest_margin;
+    return true;
+}
+
 // send ADSB_VEHICLE mavlink messages
 void AP_OADatabase::send_adsb_vehicle(mavlink_channel_t chan, uint16_t interval_ms)
 {
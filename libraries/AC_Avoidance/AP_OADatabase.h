@@ -4,6 +4,7 @@
 #include <AP_Math/AP_Math.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_Param/AP_Param.h>
+#include "AP_OADatabaseGrid.h"
 
 class AP_OADatabase {
 public:
@@ -38,7 +39,7 @@ public:
     void queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance);
 
     // returns true if database is healthy
-    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr); }
+    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr) && _database.grid.allocated(); }
 
     // fetch an item in database. Undefined result when i >= _database.count.
     const OA_DbItem& get_item(uint32_t i) const { return _database.items[i]; }
@@ -46,6 +47,11 @@ public:
     // get number of items in the database
     uint16_t database_count() const { return _database.count; }
 
+    // calculate the smallest margin between a line segment and the objects in the database.  start and end are offsets
+    // in meters from the EKF origin.  The margin is the distance from the segment to the object's position less its radius
+    // returns false if there are no objects
+    bool get_margin_to_segment(const Vector3f &start, const Vector3f &end, float &margin) const;
+
     // empty queue and try and put into database. Return true if there's more work to do
     bool process_queue();
 
@@ -73,6 +79,12 @@ private:
     // returns true if database item "index" is close to "item"
     bool is_close_to_item_in_database(const uint16_t index, const OA_DbItem &item) const;
 
+    // refresh database item "index" from "item" if they are close.  returns true if they are close
+    bool refresh_if_close(const uint16_t index, const OA_DbItem &item);
+
+    // margin between the line segment from start to end and database item "index"
+    float margin_to_item(const uint16_t index, const Vector3f &start, const Vector3f &end) const;
+
     // enum for use with _OUTPUT parameter
     enum class OA_DbOutputLevel {
         OUTPUT_LEVEL_DISABLED = 0,
@@ -92,9 +104,8 @@ private:
     AP_Float        _min_alt;                               // OADatabase minimum vehicle height check (in meters)
 
     struct {
-        ObjectBuffer<OA_DbItem> *items;                     // thread safe incoming queue of points from proximity sensor to be put into database
+        ObjectBuffer_LF<OA_DbItem> *items;                  // lock free incoming queue of points from proximity sensors to be put into database
         uint16_t        size;                               // cached value of _queue_size_param.
-        HAL_Semaphore   sem;                                // semaphore for multi-thread use of queue
     } _queue;
     float dist_to_radius_scalar;                            // scalar to convert the distance and beam width to an object radius
 
@@ -102,6 +113,8 @@ private:
         OA_DbItem       *items;                             // array of objects in the database
         uint16_t        count;                              // number of objects in the items array
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
+        AP_OADatabaseGrid grid;                             // grid index of the objects, used to find objects near a position
+        float           radius_max;                         // largest radius of the objects in the database (in meters)
     } _database;
 
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
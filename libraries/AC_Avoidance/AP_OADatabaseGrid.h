@@ -0,0 +1,147 @@
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+#ifndef AP_OADATABASE_GRID_CELL_SIZE
+    #define AP_OADATABASE_GRID_CELL_SIZE    2.0f    // size in meters of the grid cells used to find objects near a position
+#endif
+
+/*
+ * grid index of the AP_OADatabase items in the horizontal plane.  Each
+ * grid cell is hashed to a bucket holding a list of the items in it,
+ * linked through _next and ending in NONE
+ */
+
+class AP_OADatabaseGrid {
+public:
+
+    enum : uint16_t { NONE = UINT16_MAX };
+
+    // a search for the items near a line segment
+    struct Search {
+        Vector2f start;         // segment start in the horizontal plane
+        Vector2f end;           // segment end in the horizontal plane
+        float cell_range;       // largest distance from the segment to the center of a searched cell
+        int32_t x_min, x_max;   // range of cells searched
+        int32_t y_min, y_max;
+        int32_t x, y;           // cell being searched
+        uint16_t item;          // next item in the cell being searched or NONE
+    };
+
+    AP_OADatabaseGrid() {}
+
+    /* Do not allow copies */
+    AP_OADatabaseGrid(const AP_OADatabaseGrid &other) = delete;
+    AP_OADatabaseGrid &operator=(const AP_OADatabaseGrid&) = delete;
+
+    // allocate a grid for up to size items, returns false on failure
+    bool init(uint16_t size) {
+        // at least one bucket per item
+        uint32_t num_buckets = 1;
+        while (num_buckets < size) {
+            num_buckets *= 2;
+        }
+        _head = new uint16_t[num_buckets];
+        _next = new uint16_t[size];
+        if (!allocated()) {
+            release();
+            return false;
+        }
+        for (uint32_t i=0; i<num_buckets; i++) {
+            _head[i] = NONE;
+        }
+        _mask = num_buckets - 1;
+        return true;
+    }
+
+    void release() {
+        delete[] _head;
+        delete[] _next;
+        _head = nullptr;
+        _next = nullptr;
+    }
+
+    bool allocated() const { return (_head != nullptr) && (_next != nullptr); }
+
+    // add an item at pos (offset in meters from the EKF origin)
+    void insert(uint16_t index, const Vector3f &pos) {
+        const uint16_t b = bucket(pos);
+        _next[index] = _head[b];
+        _head[b] = index;
+    }
+
+    // remove an item, pos must be the position it was added at
+    void remove(uint16_t index, const Vector3f &pos) {
+        for (uint16_t *p = &_head[bucket(pos)]; *p != NONE; p = &_next[*p]) {
+            if (*p == index) {
+                *p = _next[index];
+                return;
+            }
+        }
+    }
+
+    // start a search for the items in grid cells within range (in meters) of the line segment from start to end
+    // in the horizontal plane.  returns false if the area covers more than max_cells cells, in which case it is
+    // quicker for the caller to check every item
+    bool search_start(Search &s, const Vector3f &start, const Vector3f &end, float range, uint16_t max_cells) const {
+        const float cell_size = AP_OADATABASE_GRID_CELL_SIZE;
+        const float x_min = floorf((MIN(start.x, end.x) - range) / cell_size);
+        const float x_max = floorf((MAX(start.x, end.x) + range) / cell_size);
+        const float y_min = floorf((MIN(start.y, end.y) - range) / cell_size);
+        const float y_max = floorf((MAX(start.y, end.y) + range) / cell_size);
+        if ((x_max - x_min + 1) * (y_max - y_min + 1) > max_cells) {
+            return false;
+        }
+        s.start = Vector2f{start.x, start.y};
+        s.end = Vector2f{end.x, end.y};
+        // a cell is within range if its center is within range plus half the cell's diagonal
+        s.cell_range = range + cell_size * M_SQRT1_2;
+        s.x_min = x_min;
+        s.x_max = x_max;
+        s.y_min = y_min;
+        s.y_max = y_max;
+        s.x = s.x_min;
+        s.y = s.y_min - 1;
+        s.item = NONE;
+        return true;
+    }
+
+    // get the next item found by a search.  Items may be found more than once.  returns false when there are no more
+    bool search_next(Search &s, uint16_t &index) const {
+        const float cell_size = AP_OADATABASE_GRID_CELL_SIZE;
+        while (s.item == NONE) {
+            // move on to the next cell within range of the segment
+            if (++s.y > s.y_max) {
+                s.y = s.y_min;
+                if (++s.x > s.x_max) {
+                    s.x = s.x_max;
+                    s.y = s.y_max;
+                    return false;
+                }
+            }
+            const Vector2f center{(s.x + 0.5f) * cell_size, (s.y + 0.5f) * cell_size};
+            if (Vector2f::closest_distance_between_line_and_point(s.start, s.end, center) <= s.cell_range) {
+                s.item = _head[cell_bucket(s.x, s.y)];
+            }
+        }
+        index = s.item;
+        s.item = _next[index];
+        return true;
+    }
+
+private:
+
+    // return the bucket for the cell with integer coordinates x, y
+    uint16_t cell_bucket(int32_t x, int32_t y) const {
+        return (((uint32_t)x * 73856093U) ^ ((uint32_t)y * 19349663U)) & _mask;
+    }
+
+    // return the bucket for a position (offset in meters from the EKF origin)
+    uint16_t bucket(const Vector3f &pos) const {
+        return cell_bucket(floorf(pos.x / AP_OADATABASE_GRID_CELL_SIZE), floorf(pos.y / AP_OADATABASE_GRID_CELL_SIZE));
+    }
+
+    uint16_t _mask;
+    uint16_t *_head = nullptr;      // first item in each bucket or NONE
+    uint16_t *_next = nullptr;      // next item in the same bucket or NONE
+};
@@ -18,10 +18,12 @@
 #include <AC_Fence/AC_Fence.h>
 #include <AP_AHRS/AP_AHRS.h>
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Math/crc.h>
 
 #define OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK  32      // expanding arrays for fence points and paths to destination will grow in increments of 20 elements
 #define OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX        255     // index use to indicate we do not have a tentative short path for a node
 #define OA_DIJKSTRA_ERROR_REPORTING_INTERVAL_MS         5000    // failure messages sent to GCS every 5 seconds
+#define OA_DIJKSTRA_EXCLUSION_CIRCLE_NUM_POINTS         6       // number of points created around each exclusion circle
 
 /// Constructor
 AP_OADijkstra::AP_OADijkstra() :
@@ -105,6 +107,7 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
 
     // create visgraph for all fence (with margin) points
     if (!_polyfence_visgraph_ok) {
+        _shortest_path_tree_ok = false;
         _polyfence_visgraph_ok = create_fence_visgraph(error_id);
         if (!_polyfence_visgraph_ok) {
             _shortest_path_ok = false;
@@ -452,6 +455,7 @@ bool AP_OADijkstra::create_exclusion_circle_with_margin(float margin_cm, AP_OADi
             {cosf(radians(330)), cosf(radians(330-90))},// north-west
     };
     const uint8_t num_points_per_circle = ARRAY_SIZE(unit_offsets);
+    static_assert(ARRAY_SIZE(unit_offsets) == OA_DIJKSTRA_EXCLUSION_CIRCLE_NUM_POINTS, "exclusion circle points mismatch");
 
     // expand polygon point array if required
     const uint8_t num_exclusion_circles = fence->polyfence().get_exclusion_circle_count();
@@ -530,33 +534,64 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
     }
 
     // determine if segment crosses any of the inclusion polygons
-    uint16_t num_points = 0;
     for (uint8_t i = 0; i < fence->polyfence().get_inclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
-        if (boundary != nullptr) {
-            Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
-                return true;
-            }
+        if (intersects_fence_item({FenceItemType::INCLUSION_POLYGON, i}, seg_start, seg_end)) {
+            return true;
         }
     }
 
     // determine if segment crosses any of the exclusion polygons
     for (uint8_t i = 0; i < fence->polyfence().get_exclusion_polygon_count(); i++) {
-        const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
-        if (boundary != nullptr) {
-            Vector2f intersection;
-            if (Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection)) {
-                return true;
-            }
+        if (intersects_fence_item({FenceItemType::EXCLUSION_POLYGON, i}, seg_start, seg_end)) {
+            return true;
         }
     }
 
     // determine if segment crosses any of the inclusion circles
     for (uint8_t i = 0; i < fence->polyfence().get_inclusion_circle_count(); i++) {
+        if (intersects_fence_item({FenceItemType::INCLUSION_CIRCLE, i}, seg_start, seg_end)) {
+            return true;
+        }
+    }
+
+    // determine if segment crosses any of the exclusion circles
+    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_circle_count(); i++) {
+        if (intersects_fence_item({FenceItemType::EXCLUSION_CIRCLE, i}, seg_start, seg_end)) {
+            return true;
+        }
+    }
+
+    // if we got this far then no intersection
+    return false;
+}
+
+// returns true if line segment intersects the fence item
+bool AP_OADijkstra::intersects_fence_item(const FenceItem &item, const Vector2f &seg_start, const Vector2f &seg_end) const
+{
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return false;
+    }
+
+    switch (item.type) {
+    case FenceItemType::INCLUSION_POLYGON:
+    case FenceItemType::EXCLUSION_POLYGON: {
+        // determine if segment crosses the polygon
+        uint16_t num_points = 0;
+        const Vector2f* boundary = (item.type == FenceItemType::INCLUSION_POLYGON) ?
+                                   fence->polyfence().get_inclusion_polygon(item.index, num_points) :
+                                   fence->polyfence().get_exclusion_polygon(item.index, num_points);
+        if (boundary != nullptr) {
+            Vector2f intersection;
+            return Polygon_intersects(boundary, num_points, seg_start, seg_end, intersection);
+        }
+        return false;
+    }
+
+    case FenceItemType::INCLUSION_CIRCLE: {
         Vector2f center_pos_cm;
         float radius;
-        if (fence->polyfence().get_inclusion_circle(i, center_pos_cm, radius)) {
+        if (fence->polyfence().get_inclusion_circle(item.index, center_pos_cm, radius)) {
             // intersects circle if either start or end is further from the center than the radius
             const float radius_cm_sq = sq(radius * 100.0f) ;
             if ((seg_start - center_pos_cm).length_squared() > radius_cm_sq) {
@@ -566,13 +601,13 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
                 return true;
             }
         }
+        return false;
     }
 
-    // determine if segment crosses any of the exclusion circles
-    for (uint8_t i = 0; i < fence->polyfence().get_exclusion_circle_count(); i++) {
+    case FenceItemType::EXCLUSION_CIRCLE: {
         Vector2f center_pos_cm;
         float radius;
-        if (fence->polyfence().get_exclusion_circle(i, center_pos_cm, radius)) {
+        if (fence->polyfence().get_exclusion_circle(item.index, center_pos_cm, radius)) {
             // calculate distance between circle's center and segment
             const float dist_cm = Vector2f::closest_distance_between_line_and_point(seg_start, seg_end, center_pos_cm);
 
@@ -581,15 +616,106 @@ bool AP_OADijkstra::intersects_fence(const Vector2f &seg_start, const Vector2f &
                 return true;
             }
         }
+        return false;
+    }
     }
 
-    // if we got this far then no intersection
+    // we should never reach here but just in case
     return false;
 }
 
+// returns index of the first fence item (of those where changed[i] is true, or all if changed is nullptr)
+// intersected by the line segment, or AP_OAFencePairs::VISIBLE if none
+uint8_t AP_OADijkstra::intersecting_fence_item(const FenceItem *items, uint16_t num_items, const bool *changed, const Vector2f &seg_start, const Vector2f &seg_end) const
+{
+    for (uint16_t i = 0; i < num_items; i++) {
+        if ((changed == nullptr || changed[i]) && intersects_fence_item(items[i], seg_start, seg_end)) {
+            return AP_OAFencePairs::blocker(i);
+        }
+    }
+    return AP_OAFencePairs::VISIBLE;
+}
+
+// create the list of fence items from the current fence.  returns false if out of memory
+// items are listed in the same order as their points are returned by get_point
+bool AP_OADijkstra::create_fence_items(FenceItem *&items, uint16_t &num_items) const
+{
+    items = nullptr;
+    num_items = 0;
+
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return true;
+    }
+    const AC_PolyFence_loader &polyfence = fence->polyfence();
+    const uint16_t total_items = polyfence.get_inclusion_polygon_count() +
+                                 polyfence.get_exclusion_polygon_count() +
+                                 polyfence.get_inclusion_circle_count() +
+                                 polyfence.get_exclusion_circle_count();
+    if (total_items == 0) {
+        return true;
+    }
+    items = new FenceItem[total_items];
+    if (items == nullptr) {
+        return false;
+    }
+
+    // the margin changes the points so is included in every item's crc
+    const float margin_cm = _polyfence_margin * 100.0f;
+    const uint32_t margin_crc = crc32_small(0, (const uint8_t *)&margin_cm, sizeof(margin_cm));
+    uint16_t first_point = 0;
+
+    for (uint8_t i = 0; i < polyfence.get_inclusion_polygon_count(); i++) {
+        uint16_t num_points = 0;
+        const Vector2f* boundary = polyfence.get_inclusion_polygon(i, num_points);
+        if (boundary == nullptr) {
+            num_points = 0;
+        }
+        const uint32_t crc = crc32_small(margin_crc, (const uint8_t *)boundary, num_points * sizeof(Vector2f));
+        items[num_items++] = {FenceItemType::INCLUSION_POLYGON, i, first_point, num_points, crc};
+        first_point += num_points;
+    }
+
+    for (uint8_t i = 0; i < polyfence.get_exclusion_polygon_count(); i++) {
+        uint16_t num_points = 0;
+        const Vector2f* boundary = polyfence.get_exclusion_polygon(i, num_points);
+        if (boundary == nullptr) {
+            num_points = 0;
+        }
+        const uint32_t crc = crc32_small(margin_crc, (const uint8_t *)boundary, num_points * sizeof(Vector2f));
+        items[num_items++] = {FenceItemType::EXCLUSION_POLYGON, i, first_point, num_points, crc};
+        first_point += num_points;
+    }
+
+    for (uint8_t i = 0; i < polyfence.get_inclusion_circle_count(); i++) {
+        struct {
+            Vector2f center_pos_cm;
+            float radius;
+        } circle {};
+        polyfence.get_inclusion_circle(i, circle.center_pos_cm, circle.radius);
+        const uint32_t crc = crc32_small(margin_crc, (const uint8_t *)&circle, sizeof(circle));
+        // inclusion circles do not create any points
+        items[num_items++] = {FenceItemType::INCLUSION_CIRCLE, i, first_point, 0, crc};
+    }
+
+    for (uint8_t i = 0; i < polyfence.get_exclusion_circle_count(); i++) {
+        struct {
+            Vector2f center_pos_cm;
+            float radius;
+        } circle {};
+        const uint16_t num_points = polyfence.get_exclusion_circle(i, circle.center_pos_cm, circle.radius) ? OA_DIJKSTRA_EXCLUSION_CIRCLE_NUM_POINTS : 0;
+        const uint32_t crc = crc32_small(margin_crc, (const uint8_t *)&circle, sizeof(circle));
+        items[num_items++] = {FenceItemType::EXCLUSION_CIRCLE, i, first_point, num_points, crc};
+        first_point += num_points;
+    }
+
+    return true;
+}
+
 // create visibility graph for all fence (with margin) points
 // returns true on success.  returns false on failure and err_id is updated
 // requires these functions to have been run create_inclusion_polygon_with_margin, create_exclusion_polygon_with_margin, create_exclusion_circle_with_margin
+// lines between points of fence items which have not changed since the last call are only checked against the changed fence items
 bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
 {
     // exit immediately if fence is not enabled
@@ -600,37 +726,129 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
     }
 
     // fail if more fence points than algorithm can handle
-    if (total_numpoints() >= OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
+    const uint16_t numpoints = total_numpoints();
+    if (numpoints >= OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_TOO_MANY_FENCE_POINTS;
         return false;
     }
 
+    // create list of fence items and working arrays
+    FenceItem *items;
+    uint16_t num_items;
+    const bool items_ok = create_fence_items(items, num_items);
+    const uint32_t num_pairs = AP_OAFencePairs::num_pairs(numpoints);
+    uint8_t *pairs = (num_pairs > 0) ? new uint8_t[num_pairs] : nullptr;
+    bool *changed = (num_items > 0) ? new bool[num_items] : nullptr;
+    uint16_t *old_point = (numpoints > 0) ? new uint16_t[numpoints] : nullptr;
+    uint16_t *old_to_new = (_fence_items_num > 0) ? new uint16_t[_fence_items_num] : nullptr;
+    if (!items_ok ||
+        (num_pairs > 0 && pairs == nullptr) ||
+        (num_items > 0 && changed == nullptr) ||
+        (numpoints > 0 && old_point == nullptr) ||
+        (_fence_items_num > 0 && old_to_new == nullptr)) {
+        delete[] items;
+        delete[] pairs;
+        delete[] changed;
+        delete[] old_point;
+        delete[] old_to_new;
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
+    // match fence items with unchanged items from the last call, and their points with the old points
+    for (uint16_t i = 0; i < _fence_items_num; i++) {
+        old_to_new[i] = UINT16_MAX;
+    }
+    for (uint16_t i = 0; i < numpoints; i++) {
+        old_point[i] = UINT16_MAX;
+    }
+    for (uint16_t n = 0; n < num_items; n++) {
+        const FenceItem &item = items[n];
+        changed[n] = true;
+        for (uint16_t o = 0; o < _fence_items_num; o++) {
+            const FenceItem &old_item = _fence_items[o];
+            if ((old_to_new[o] == UINT16_MAX) &&
+                (old_item.type == item.type) &&
+                (old_item.crc == item.crc) &&
+                (old_item.num_points == item.num_points)) {
+                changed[n] = false;
+                old_to_new[o] = n;
+                for (uint16_t k = 0; k < item.num_points; k++) {
+                    old_point[item.first_point + k] = old_item.first_point + k;
+                }
+                break;
+            }
+        }
+    }
+
     // clear fence points visibility graph
     _fence_visgraph.clear();
 
     // calculate distance from each point to all other points
-    for (uint8_t i = 0; i < total_numpoints() - 1; i++) {
+    bool ret = true;
+    for (uint8_t i = 0; (i + 1 < numpoints) && ret; i++) {
         Vector2f start_seg;
-        if (get_point(i, start_seg)) {
-            for (uint8_t j = i + 1; j < total_numpoints(); j++) {
-                Vector2f end_seg;
-                if (get_point(j, end_seg)) {
-                    // if line segment does not intersect with any inclusion or exclusion zones add to visgraph
-                    if (!intersects_fence(start_seg, end_seg)) {
-                        if (!_fence_visgraph.add_item({AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i},
-                                                      {AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, j},
-                                                      (start_seg - end_seg).length())) {
-                            // failure to add a point can only be caused by out-of-memory
-                            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
-                            return false;
-                        }
-                    }
+        if (!get_point(i, start_seg)) {
+            continue;
+        }
+        for (uint8_t j = i + 1; j < numpoints; j++) {
+            Vector2f end_seg;
+            if (!get_point(j, end_seg)) {
+                continue;
+            }
+            uint8_t blocker = AP_OAFencePairs::VISIBLE;
+            AP_OAFencePairs::Check check = AP_OAFencePairs::Check::ALL_ITEMS;
+            const uint16_t oi = old_point[i];
+            const uint16_t oj = old_point[j];
+            if ((_fence_pairs != nullptr) && (oi != UINT16_MAX) && (oj != UINT16_MAX)) {
+                // both points are unchanged
+                const uint8_t old_blocker = _fence_pairs[AP_OAFencePairs::index(MIN(oi, oj), MAX(oi, oj), _fence_pairs_numpoints)];
+                check = AP_OAFencePairs::recheck(old_blocker, old_to_new, _fence_items_num, blocker);
+            }
+            switch (check) {
+            case AP_OAFencePairs::Check::NONE:
+                break;
+            case AP_OAFencePairs::Check::CHANGED_ITEMS:
+                blocker = intersecting_fence_item(items, num_items, changed, start_seg, end_seg);
+                break;
+            case AP_OAFencePairs::Check::ALL_ITEMS:
+                blocker = intersecting_fence_item(items, num_items, nullptr, start_seg, end_seg);
+                break;
+            }
+            pairs[AP_OAFencePairs::index(i, j, numpoints)] = blocker;
+
+            // if line segment does not intersect with any inclusion or exclusion zones add to visgraph
+            if (blocker == AP_OAFencePairs::VISIBLE) {
+                if (!_fence_visgraph.add_item({AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i},
+                                              {AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, j},
+                                              (start_seg - end_seg).length())) {
+                    // failure to add a point can only be caused by out-of-memory
+                    err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+                    ret = false;
+                    break;
                 }
             }
         }
     }
 
-    return true;
+    delete[] changed;
+    delete[] old_point;
+    delete[] old_to_new;
+
+    // keep the items and pairs for the next call
+    if (ret) {
+        delete[] _fence_items;
+        delete[] _fence_pairs;
+        _fence_items = items;
+        _fence_items_num = num_items;
+        _fence_pairs = pairs;
+        _fence_pairs_numpoints = numpoints;
+    } else {
+        delete[] items;
+        delete[] pairs;
+    }
+
+    return ret;
 }
 
 // updates visibility graph for a given position which is an offset (in cm) from the ekf origin
@@ -771,24 +989,13 @@ bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
     return false;
 }
 
-// calculate shortest path from origin to destination
-// returns true on success.  returns false on failure and err_id is updated
-// requires these functions to have been run: create_inclusion_polygon_with_margin, create_exclusion_polygon_with_margin, create_exclusion_circle_with_margin, create_polygon_fence_visgraph
-// resulting path is stored in _shortest_path array as vector offsets from EKF origin
-bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id)
+// calculate distances from all fence points to the destination, leaving the tree of shortest
+// paths to the destination in _short_path_data.  Each node's distance_from_idx is the next node on its
+// way to the destination.  returns true on success.  returns false on failure and err_id is updated
+// requires create_fence_visgraph to have been run
+bool AP_OADijkstra::calc_shortest_path_tree(const Vector2f &destination_NE, AP_OADijkstra_Error &err_id)
 {
-    // convert origin and destination to offsets from EKF origin
-    Vector2f origin_NE, destination_NE;
-    if (!origin.get_vector_xy_from_origin_NE(origin_NE) || !destination.get_vector_xy_from_origin_NE(destination_NE)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_NO_POSITION_ESTIMATE;
-        return false;
-    }
-
-    // create visgraphs of origin and destination to fence points
-    if (!update_visgraph(_source_visgraph, {AP_OAVisGraph::OATYPE_SOURCE, 0}, origin_NE, true, destination_NE)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
-        return false;
-    }
+    // create visgraph of destination to fence points
     if (!update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, destination_NE)) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
@@ -801,8 +1008,9 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     }
 
     // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // the origin is not part of the tree so is marked as visited
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, true, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, 0};
     _short_path_data_numpoints = 2;
 
     // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
@@ -810,24 +1018,8 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
     }
 
-    // start algorithm from source point
-    node_index current_node_idx = 0;
-
-    // update nodes visible from source point
-    for (uint16_t i = 0; i < _source_visgraph.num_items(); i++) {
-        node_index node_idx;
-        if (find_node_from_id(_source_visgraph[i].id2, node_idx)) {
-            _short_path_data[node_idx].distance_cm = _source_visgraph[i].distance_cm;
-            _short_path_data[node_idx].distance_from_idx = current_node_idx;
-        } else {
-            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
-            return false;
-        }
-    }
-    // mark source node as visited
-    _short_path_data[current_node_idx].visited = true;
-
-    // move current_node_idx to node with lowest distance
+    // start algorithm from destination point, moving current_node_idx to node with lowest distance
+    node_index current_node_idx;
     while (find_closest_node_idx(current_node_idx)) {
         // update distances to all neighbours of current node
         update_visible_node_distances(current_node_idx);
@@ -836,47 +1028,97 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         _short_path_data[current_node_idx].visited = true;
     }
 
-    // extract path starting from destination
-    bool success = false;
-    node_index nidx;
-    if (!find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, nidx)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+    _shortest_path_tree_destination = destination_NE;
+    return true;
+}
+
+// calculate shortest path from origin to destination
+// returns true on success.  returns false on failure and err_id is updated
+// requires these functions to have been run: create_inclusion_polygon_with_margin, create_exclusion_polygon_with_margin, create_exclusion_circle_with_margin, create_polygon_fence_visgraph
+// resulting path is stored in _shortest_path array as vector offsets from EKF origin
+// the shortest path tree to the destination is reused while the destination and fence are unchanged
+bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id)
+{
+    // convert origin and destination to offsets from EKF origin
+    Vector2f origin_NE, destination_NE;
+    if (!origin.get_vector_xy_from_origin_NE(origin_NE) || !destination.get_vector_xy_from_origin_NE(destination_NE)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_NO_POSITION_ESTIMATE;
         return false;
     }
-    _path_numpoints = 0;
-    while (true) {
-        if (!_path.expand_to_hold(_path_numpoints + 1)) {
-            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+
+    // calculate distances from all fence points to the destination
+    if (!_shortest_path_tree_ok || (destination_NE != _shortest_path_tree_destination)) {
+        _shortest_path_tree_ok = calc_shortest_path_tree(destination_NE, err_id);
+        if (!_shortest_path_tree_ok) {
             return false;
         }
-        // fail if newest node has invalid distance_from_index
-        if ((_short_path_data[nidx].distance_from_idx == OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) ||
-            (_short_path_data[nidx].distance_cm >= FLT_MAX)) {
-            break;
-        } else {
-            // add node's id to path array
-            _path[_path_numpoints] = _short_path_data[nidx].id;
-            _path_numpoints++;
+    }
 
-            // we are done if node is the source
-            if (_short_path_data[nidx].id.id_type == AP_OAVisGraph::OATYPE_SOURCE) {
-                success = true;
-                break;
-            } else {
-                // follow node's "distance_from_idx" to previous node on path
-                nidx = _short_path_data[nidx].distance_from_idx;
-            }
+    // create visgraph of origin to fence points and destination
+    if (!update_visgraph(_source_visgraph, {AP_OAVisGraph::OATYPE_SOURCE, 0}, origin_NE, true, destination_NE)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
+    // find the node visible from the origin with the shortest total distance to the destination
+    node_index first_idx = OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX;
+    float first_dist = FLT_MAX;
+    for (uint16_t i = 0; i < _source_visgraph.num_items(); i++) {
+        node_index node_idx;
+        if (!find_node_from_id(_source_visgraph[i].id2, node_idx)) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+            return false;
+        }
+        if (_short_path_data[node_idx].distance_cm >= FLT_MAX) {
+            // no path from this node to the destination
+            continue;
+        }
+        const float dist = _source_visgraph[i].distance_cm + _short_path_data[node_idx].distance_cm;
+        if (dist < first_dist) {
+            first_idx = node_idx;
+            first_dist = dist;
         }
     }
-    // update source and destination for by get_shortest_path_point
-    if (success) {
-        _path_source = origin_NE;
-        _path_destination = destination_NE;
-    } else {
+    if (first_idx == OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+        return false;
+    }
+
+    // count the points on the path by following the tree to the destination
+    node_index destination_idx;
+    if (!find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, destination_idx)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+        return false;
+    }
+    uint16_t numpoints = 2;
+    for (node_index nidx = first_idx; nidx != destination_idx; nidx = _short_path_data[nidx].distance_from_idx) {
+        // fail if node has invalid distance_from_index or path is longer than number of nodes
+        if ((_short_path_data[nidx].distance_from_idx == OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) ||
+            (numpoints > _short_path_data_numpoints)) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+            return false;
+        }
+        numpoints++;
+    }
+    if (!_path.expand_to_hold(numpoints)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
     }
 
-    return success;
+    // add ids to path array in reverse order (i.e. destination is first element)
+    _path_numpoints = numpoints;
+    _path[numpoints - 1] = {AP_OAVisGraph::OATYPE_SOURCE, 0};
+    node_index nidx = first_idx;
+    for (uint16_t i = numpoints - 1; i > 0; i--) {
+        _path[i - 1] = _short_path_data[nidx].id;
+        nidx = _short_path_data[nidx].distance_from_idx;
+    }
+
+    // update source and destination for by get_shortest_path_point
+    _path_source = origin_NE;
+    _path_destination = destination_NE;
+
+    return true;
 }
 
 // return point from final path as an offset (in cm) from the ekf origin
@@ -5,6 +5,7 @@
 #include <AP_Math/AP_Math.h>
 #include <AP_HAL/AP_HAL.h>
 #include "AP_OAVisGraph.h"
+#include "AP_OAFencePairs.h"
 
 /*
  * Dijkstra's algorithm for path planning around polygon fence
@@ -109,6 +110,37 @@ private:
     // returns true if line segment intersects polygon or circular fence
     bool intersects_fence(const Vector2f &seg_start, const Vector2f &seg_end) const;
 
+    //
+    // fence items are the individual polygons and circles of the fence.  The visgraph
+    // between fence points is updated incrementally by only re-checking lines against
+    // the fence items that have changed since it was last created
+    //
+
+    enum class FenceItemType : uint8_t {
+        INCLUSION_POLYGON = 0,
+        EXCLUSION_POLYGON,
+        INCLUSION_CIRCLE,
+        EXCLUSION_CIRCLE
+    };
+
+    struct FenceItem {
+        FenceItemType type;     // type of fence item
+        uint8_t index;          // index of polygon or circle within AC_PolyFence_loader
+        uint16_t first_point;   // index of the item's first point (with margin) as used by get_point
+        uint16_t num_points;    // number of points (with margin) created for this item
+        uint32_t crc;           // crc of the item's boundary and margin, used to detect changes
+    };
+
+    // create the list of fence items from the current fence.  returns false if out of memory
+    bool create_fence_items(FenceItem *&items, uint16_t &num_items) const;
+
+    // returns true if line segment intersects the fence item
+    bool intersects_fence_item(const FenceItem &item, const Vector2f &seg_start, const Vector2f &seg_end) const;
+
+    // returns index of the first fence item (of those where changed[i] is true, or all if changed is nullptr)
+    // intersected by the line segment, or AP_OAFencePairs::VISIBLE if none
+    uint8_t intersecting_fence_item(const FenceItem *items, uint16_t num_items, const bool *changed, const Vector2f &seg_start, const Vector2f &seg_end) const;
+
     // create visibility graph for all fence (with margin) points
     // returns true on success.  returns false on failure and err_id is updated
     bool create_fence_visgraph(AP_OADijkstra_Error &err_id);
@@ -119,12 +151,19 @@ private:
     // resulting path is stored in _shortest_path array as vector offsets from EKF origin
     bool calc_shortest_path(const Location &origin, const Location &destination, AP_OADijkstra_Error &err_id);
 
+    // calculate distances from all fence points to the destination, leaving the tree of shortest
+    // paths to the destination in _short_path_data.  Each node's distance_from_idx is the next node on its
+    // way to the destination.  returns true on success.  returns false on failure and err_id is updated
+    bool calc_shortest_path_tree(const Vector2f &destination_NE, AP_OADijkstra_Error &err_id);
+
     // shortest path state variables
     bool _inclusion_polygon_with_margin_ok;
     bool _exclusion_polygon_with_margin_ok;
     bool _exclusion_circle_with_margin_ok;
     bool _polyfence_visgraph_ok;
+    bool _shortest_path_tree_ok;    // true if _short_path_data holds the shortest path tree to _shortest_path_tree_destination
     bool _shortest_path_ok;
+    Vector2f _shortest_path_tree_destination;   // destination (offset in cm from EKF origin) of the shortest path tree
 
     Location _destination_prev;     // destination of previous iterations (used to determine if path should be re-calculated)
     uint8_t _path_idx_returned;     // index into _path array which gives location vehicle should be currently moving towards
@@ -150,6 +189,12 @@ private:
     AP_OAVisGraph _source_visgraph;         // holds distances from source point to all other nodes
     AP_OAVisGraph _destination_visgraph;    // holds distances from the destination to all other nodes
 
+    // fence items and line of sight between fence points from when _fence_visgraph was last created
+    FenceItem *_fence_items;                // fence items
+    uint16_t _fence_items_num;              // number of fence items
+    uint8_t *_fence_pairs;                  // index of a fence item blocking each pair of points (i < j) or AP_OAFencePairs::VISIBLE
+    uint16_t _fence_pairs_numpoints;        // number of fence points when _fence_pairs was created
+
     // updates visibility graph for a given position which is an offset (in cm) from the ekf origin
     // to add an additional position (i.e. the destination) set add_extra_position = true and provide the position in the extra_position argument
     // requires create_polygon_fence_with_margin to have been run
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+/*
+ * line of sight between each pair of fence points, as the index of a
+ * fence item blocking them.  Kept by AP_OADijkstra between updates of
+ * the fence visibility graph so pairs of unchanged points are only
+ * checked against the fence items which have changed
+ */
+
+class AP_OAFencePairs {
+public:
+
+    enum : uint8_t {
+        BLOCKED = 254,      // blocked by an item whose index is too large to store
+        VISIBLE = 255,      // points are visible from each other
+    };
+
+    // number of pairs of numpoints points
+    static uint32_t num_pairs(uint16_t numpoints) {
+        return (numpoints > 1) ? index(numpoints - 2, numpoints - 1, numpoints) + 1 : 0;
+    }
+
+    // index into the pairs array for points i and j (i < j) out of numpoints points
+    static uint32_t index(uint16_t i, uint16_t j, uint16_t numpoints) {
+        return (uint32_t)i * numpoints - ((uint32_t)i * (i + 1)) / 2 + (j - i - 1);
+    }
+
+    // value stored for a pair blocked by fence item item
+    static uint8_t blocker(uint16_t item) {
+        return MIN(item, BLOCKED);
+    }
+
+    // fence items a pair of unchanged points must be checked against
+    enum class Check : uint8_t {
+        NONE = 0,           // still blocked by the same unchanged item
+        CHANGED_ITEMS,      // visible unless blocked by a changed item
+        ALL_ITEMS,          // blocking item changed or unknown
+    };
+
+    // decide how to recheck a pair of unchanged points from its old blocker.
+    // old_to_new maps each of the old_num_items old items to its new index or UINT16_MAX if changed.
+    // new_blocker is set when NONE is returned
+    static Check recheck(uint8_t old_blocker, const uint16_t *old_to_new, uint16_t old_num_items, uint8_t &new_blocker) {
+        if (old_blocker == VISIBLE) {
+            return Check::CHANGED_ITEMS;
+        }
+        // BLOCKED does not say which item blocked the pair
+        if ((old_blocker == BLOCKED) || (old_blocker >= old_num_items) || (old_to_new[old_blocker] == UINT16_MAX)) {
+            return Check::ALL_ITEMS;
+        }
+        new_blocker = blocker(old_to_new[old_blocker]);
+        return Check::NONE;
+    }
+};
@@ -0,0 +1,84 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AC_Avoidance/AP_OAFencePairs.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(AP_OAFencePairs, IndexCoversEachPairOnce)
+{
+    const uint16_t numpoints = 20;
+    const uint32_t num_pairs = AP_OAFencePairs::num_pairs(numpoints);
+    EXPECT_EQ(uint32_t(numpoints * (numpoints - 1) / 2), num_pairs);
+
+    // pairs are numbered consecutively from zero
+    uint32_t expected = 0;
+    for (uint16_t i = 0; i + 1 < numpoints; i++) {
+        for (uint16_t j = i + 1; j < numpoints; j++) {
+            EXPECT_EQ(expected, AP_OAFencePairs::index(i, j, numpoints));
+            expected++;
+        }
+    }
+    EXPECT_EQ(num_pairs, expected);
+
+    EXPECT_EQ(0U, AP_OAFencePairs::num_pairs(0));
+    EXPECT_EQ(0U, AP_OAFencePairs::num_pairs(1));
+    EXPECT_EQ(1U, AP_OAFencePairs::num_pairs(2));
+}
+
+TEST(AP_OAFencePairs, BlockerSaturates)
+{
+    EXPECT_EQ(0, AP_OAFencePairs::blocker(0));
+    EXPECT_EQ(253, AP_OAFencePairs::blocker(253));
+    EXPECT_EQ(AP_OAFencePairs::BLOCKED, AP_OAFencePairs::blocker(254));
+    EXPECT_EQ(AP_OAFencePairs::BLOCKED, AP_OAFencePairs::blocker(1000));
+    EXPECT_NE(AP_OAFencePairs::VISIBLE, AP_OAFencePairs::blocker(UINT16_MAX));
+}
+
+TEST(AP_OAFencePairs, VisiblePairChecksChangedItems)
+{
+    const uint16_t old_to_new[] { 0, UINT16_MAX };
+    uint8_t blocker = 7;
+    EXPECT_EQ(AP_OAFencePairs::Check::CHANGED_ITEMS, AP_OAFencePairs::recheck(AP_OAFencePairs::VISIBLE, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+    EXPECT_EQ(7, blocker);
+}
+
+TEST(AP_OAFencePairs, UnchangedBlockerIsKept)
+{
+    // item 1 was removed so item 2 moved down
+    const uint16_t old_to_new[] { 0, UINT16_MAX, 1 };
+    uint8_t blocker;
+    EXPECT_EQ(AP_OAFencePairs::Check::NONE, AP_OAFencePairs::recheck(2, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+    EXPECT_EQ(1, blocker);
+    EXPECT_EQ(AP_OAFencePairs::Check::NONE, AP_OAFencePairs::recheck(0, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+    EXPECT_EQ(0, blocker);
+}
+
+TEST(AP_OAFencePairs, ChangedBlockerChecksAllItems)
+{
+    const uint16_t old_to_new[] { 0, UINT16_MAX, 1 };
+    uint8_t blocker;
+    EXPECT_EQ(AP_OAFencePairs::Check::ALL_ITEMS, AP_OAFencePairs::recheck(1, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+    // blocker index from a fence with more items than now
+    EXPECT_EQ(AP_OAFencePairs::Check::ALL_ITEMS, AP_OAFencePairs::recheck(3, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+}
+
+TEST(AP_OAFencePairs, SaturatedBlockerChecksAllItems)
+{
+    // with more than 254 items, BLOCKED does not say which item blocked the
+    // pair, so it must not be taken to be item 254 even if that is unchanged
+    uint16_t old_to_new[300];
+    for (uint16_t i = 0; i < ARRAY_SIZE(old_to_new); i++) {
+        old_to_new[i] = i;
+    }
+    old_to_new[280] = UINT16_MAX;
+    uint8_t blocker;
+    EXPECT_EQ(AP_OAFencePairs::Check::ALL_ITEMS, AP_OAFencePairs::recheck(AP_OAFencePairs::BLOCKED, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+
+    // an unchanged item moved to an index too large to store stays blocked
+    old_to_new[10] = 260;
+    EXPECT_EQ(AP_OAFencePairs::Check::NONE, AP_OAFencePairs::recheck(10, old_to_new, ARRAY_SIZE(old_to_new), blocker));
+    EXPECT_EQ(AP_OAFencePairs::BLOCKED, blocker);
+}
+
+AP_GTEST_MAIN()
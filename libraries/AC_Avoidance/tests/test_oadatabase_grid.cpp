@@ -0,0 +1,156 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AC_Avoidance/AP_OADatabaseGrid.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  items placed in a grid as AP_OADatabase does, checked against a
+  search of every item
+ */
+class OADatabaseGridTest : public ::testing::Test {
+protected:
+    ~OADatabaseGridTest() {
+        grid.release();
+    }
+
+    void init(uint16_t size) {
+        ASSERT_TRUE(grid.init(size));
+        count = 0;
+    }
+
+    void add(const Vector3f &item_pos) {
+        pos[count] = item_pos;
+        grid.insert(count, item_pos);
+        count++;
+    }
+
+    // number of times each item is found by a search, returns false if the search covers too many cells
+    bool search(const Vector3f &start, const Vector3f &end, float range, uint16_t max_cells) {
+        memset(found, 0, sizeof(found));
+        AP_OADatabaseGrid::Search s;
+        if (!grid.search_start(s, start, end, range, max_cells)) {
+            return false;
+        }
+        uint16_t i;
+        while (grid.search_next(s, i)) {
+            EXPECT_LT(i, count);
+            found[i]++;
+        }
+        // searches stay finished
+        EXPECT_FALSE(grid.search_next(s, i));
+        return true;
+    }
+
+    // every item within range of the segment must be found
+    void check_found_in_range(const Vector3f &start, const Vector3f &end, float range) {
+        const Vector2f start_xy{start.x, start.y};
+        const Vector2f end_xy{end.x, end.y};
+        for (uint16_t i = 0; i < count; i++) {
+            if (Vector2f::closest_distance_between_line_and_point(start_xy, end_xy, Vector2f{pos[i].x, pos[i].y}) <= range) {
+                EXPECT_GT(found[i], 0U);
+            }
+        }
+    }
+
+    static float random_m(float range) {
+        return (float(random()) / RAND_MAX - 0.5f) * 2.0f * range;
+    }
+
+    AP_OADatabaseGrid grid;
+    Vector3f pos[200];
+    uint8_t found[200];
+    uint16_t count;
+};
+
+TEST_F(OADatabaseGridTest, EmptyFindsNothing)
+{
+    init(10);
+    EXPECT_TRUE(search(Vector3f{}, Vector3f{}, 1.0f, 10));
+    for (uint16_t i = 0; i < ARRAY_SIZE(found); i++) {
+        EXPECT_EQ(0U, found[i]);
+    }
+}
+
+TEST_F(OADatabaseGridTest, FindsNearPoint)
+{
+    init(10);
+    add(Vector3f{0.5f, 0.5f, 0.0f});
+    add(Vector3f{-0.5f, 1.5f, 10.0f});
+    add(Vector3f{50.0f, 50.0f, 0.0f});
+
+    // items in other cells may share a bucket, so only the items which
+    // must be found are checked
+    EXPECT_TRUE(search(Vector3f{0.0f, 0.0f, 0.0f}, Vector3f{0.0f, 0.0f, 0.0f}, 2.0f, 100));
+    EXPECT_GT(found[0], 0U);
+    // the grid is horizontal so altitude makes no difference
+    EXPECT_GT(found[1], 0U);
+    EXPECT_TRUE(search(Vector3f{50.0f, 50.0f, 0.0f}, Vector3f{50.0f, 50.0f, 0.0f}, 0.0f, 100));
+    EXPECT_GT(found[2], 0U);
+}
+
+TEST_F(OADatabaseGridTest, TooManyCells)
+{
+    init(10);
+    add(Vector3f{0.5f, 0.5f, 0.0f});
+    // a 2m range around a point covers 3x3 cells
+    EXPECT_FALSE(search(Vector3f{0.5f, 0.5f, 0.0f}, Vector3f{0.5f, 0.5f, 0.0f}, 2.0f, 8));
+    EXPECT_TRUE(search(Vector3f{0.5f, 0.5f, 0.0f}, Vector3f{0.5f, 0.5f, 0.0f}, 2.0f, 9));
+    EXPECT_EQ(1U, found[0]);
+    // as does a long segment
+    EXPECT_FALSE(search(Vector3f{0.0f, 0.0f, 0.0f}, Vector3f{100.0f, 100.0f, 0.0f}, 2.0f, 100));
+}
+
+TEST_F(OADatabaseGridTest, RemoveAndMove)
+{
+    init(10);
+    add(Vector3f{0.5f, 0.5f, 0.0f});
+    add(Vector3f{1.0f, 1.0f, 0.0f});
+    add(Vector3f{20.0f, 20.0f, 0.0f});
+
+    // remove item 0 and move the last item into its place, as AP_OADatabase::database_item_remove
+    grid.remove(0, pos[0]);
+    grid.remove(2, pos[2]);
+    pos[0] = pos[2];
+    grid.insert(0, pos[0]);
+    count = 2;
+
+    // index 2 is gone from the grid, and index 0 is found at its new position
+    EXPECT_TRUE(search(Vector3f{20.0f, 20.0f, 0.0f}, Vector3f{0.0f, 0.0f, 0.0f}, 2.0f, 1000));
+    EXPECT_GT(found[0], 0U);
+    EXPECT_GT(found[1], 0U);
+    EXPECT_EQ(0U, found[2]);
+
+    // removing an item from a position it is not at changes nothing
+    grid.remove(1, pos[0]);
+    EXPECT_TRUE(search(Vector3f{20.0f, 20.0f, 0.0f}, Vector3f{0.0f, 0.0f, 0.0f}, 2.0f, 1000));
+    EXPECT_GT(found[0], 0U);
+    EXPECT_GT(found[1], 0U);
+
+    grid.remove(1, pos[1]);
+    grid.remove(0, pos[0]);
+    count = 0;
+    EXPECT_TRUE(search(Vector3f{20.0f, 20.0f, 0.0f}, Vector3f{0.0f, 0.0f, 0.0f}, 2.0f, 1000));
+    for (uint16_t i = 0; i < ARRAY_SIZE(found); i++) {
+        EXPECT_EQ(0U, found[i]);
+    }
+}
+
+TEST_F(OADatabaseGridTest, SegmentSearchMatchesFullScan)
+{
+    init(ARRAY_SIZE(pos));
+    srandom(1);
+    while (count < ARRAY_SIZE(pos)) {
+        add(Vector3f{random_m(40.0f), random_m(40.0f), random_m(5.0f)});
+    }
+    for (uint16_t n = 0; n < 500; n++) {
+        const Vector3f start{random_m(30.0f), random_m(30.0f), 0.0f};
+        const Vector3f end = start + Vector3f{random_m(10.0f), random_m(10.0f), 0.0f};
+        const float range = fabsf(random_m(6.0f));
+        ASSERT_TRUE(search(start, end, range, UINT16_MAX));
+        check_found_in_range(start, end, range);
+    }
+}
+
+AP_GTEST_MAIN()
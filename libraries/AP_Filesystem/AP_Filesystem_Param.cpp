@@ -19,6 +19,7 @@
 #include "AP_Filesystem_Param.h"
 #include <AP_Param/AP_Param.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
 
 #define PACKED_NAME "param.pck"
 
@@ -54,9 +55,11 @@ int AP_Filesystem_Param::open(const char *fname, int flags)
     r.open = true;
     r.start = 0;
     r.count = 0;
+    r.compress = false;
+    r.have_header = false;
 
     /*
-      allow for URI style arguments param.pck?start=N&count=C
+      allow for URI style arguments param.pck?start=N&count=C&compress=1
      */
     const char *c = strchr(fname, '?');
     while (c && *c) {
@@ -81,6 +84,12 @@ int AP_Filesystem_Param::open(const char *fname, int flags)
             c = strchr(c, '&');
             continue;
         }
+        if (strncmp(c, "compress=", 9) == 0) {
+            r.compress = strtoul(c+9, nullptr, 10) != 0;
+            c += 9;
+            c = strchr(c, '&');
+            continue;
+        }
     }
 
     return idx;
@@ -123,8 +132,102 @@ int AP_Filesystem_Param::close(int fd)
     Any leading zero bytes after the header should be discarded as pad
     bytes. Pad bytes are used to ensure that a parameter data[] field
     does not cross a read packet boundary
+
+  compressed format, opened with param.pck?compress=1:
+    file header is as above with magic = 0x671c
+
+    per-parameter entries are as above except that flags gives the
+    length of data[]:
+      0: full length given by variable type
+      1: value is zero, no data bytes
+      2: int8_t holding the value
+      3: int16_t holding the value
+    for FLOAT parameters codes 1 to 3 are only used for whole numbers
+
+    the file ends with a uint32_t CRC32 (crc_crc32) of all preceding
+    bytes of the file, including the header and pad bytes. This lets
+    the GCS verify that the full parameter set was assembled correctly
+    in one transfer, even if parameters changed while filling in
+    lost packets
  */
 
+/*
+  fill in the file header, this is done once per open so that all
+  reads see the same parameter counts
+ */
+bool AP_Filesystem_Param::fill_header(struct rfile &r)
+{
+    if (r.have_header) {
+        return true;
+    }
+    struct header &hdr = r.hdr;
+    hdr.magic = r.compress ? pack_magic_compressed : pack_magic;
+    hdr.total_params = AP_Param::count_parameters();
+    if (hdr.total_params <= r.start) {
+        return false;
+    }
+    hdr.num_params = hdr.total_params - r.start;
+    if (r.count > 0 && hdr.num_params > r.count) {
+        hdr.num_params = r.count;
+    }
+    r.have_header = true;
+    return true;
+}
+
+/*
+  pack a parameter value for the compressed format, setting the value
+  length code in flags. Returns the number of data bytes
+ */
+uint8_t AP_Filesystem_Param::pack_value(const AP_Param *ap, enum ap_var_type ptype, uint8_t *buf, uint8_t &flags) const
+{
+    int32_t v;
+    switch (ptype) {
+    case AP_PARAM_INT8:
+        v = ((const AP_Int8 *)ap)->get();
+        break;
+    case AP_PARAM_INT16:
+        v = ((const AP_Int16 *)ap)->get();
+        break;
+    case AP_PARAM_INT32:
+        v = ((const AP_Int32 *)ap)->get();
+        break;
+    case AP_PARAM_FLOAT: {
+        const float f = ((const AP_Float *)ap)->get();
+        if (!(fabsf(f) <= INT16_MAX) || f != float(int16_t(f)) || (f == 0 && signbit(f))) {
+            // not a whole number, send the full float
+            flags = uint8_t(ValueLen::FULL);
+            memcpy(buf, ap, sizeof(float));
+            return sizeof(float);
+        }
+        v = int16_t(f);
+        break;
+    }
+    default:
+        flags = uint8_t(ValueLen::FULL);
+        return 0;
+    }
+
+    const uint8_t type_len = AP_Param::type_size(ptype);
+    if (v == 0) {
+        flags = uint8_t(ValueLen::ZERO);
+        return 0;
+    }
+    if (type_len > 1 && v >= INT8_MIN && v <= INT8_MAX) {
+        flags = uint8_t(ValueLen::INT8);
+        buf[0] = uint8_t(int8_t(v));
+        return 1;
+    }
+    if (type_len > 2 && v >= INT16_MIN && v <= INT16_MAX) {
+        flags = uint8_t(ValueLen::INT16);
+        const int16_t v16 = v;
+        memcpy(buf, &v16, sizeof(v16));
+        return 2;
+    }
+    flags = uint8_t(ValueLen::FULL);
+    memcpy(buf, ap, type_len);
+    return type_len;
+}
+
 /*
   pack a single parameter. The buffer must be at least of size max_pack_len
  */
@@ -135,8 +238,12 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
     enum ap_var_type ptype;
     AP_Param *ap;
 
+    if (c.eof) {
+        return 0;
+    }
     if (c.token_ofs == 0) {
         c.idx = 0;
+        c.crc = crc_crc32(0, (const uint8_t *)&r.hdr, sizeof(r.hdr));
         ap = AP_Param::first(&c.token, &ptype);
         uint16_t idx = 0;
         while (idx < r.start && ap) {
@@ -148,6 +255,12 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
         ap = AP_Param::next_scalar(&c.token, &ptype);
     }
     if (ap == nullptr || (r.count && c.idx >= r.count)) {
+        if (r.compress) {
+            // finish the compressed file with the CRC trailer
+            c.eof = true;
+            memcpy(buf, &c.crc, crc_len);
+            return crc_len;
+        }
         return 0;
     }
     ap->copy_name_token(c.token, name, AP_MAX_NAME_SIZE, true);
@@ -161,20 +274,28 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
         last_name++;
     }
     const uint8_t name_len = strlen(pname);
-    const uint8_t type_len = AP_Param::type_size(ptype);
-    uint8_t packed_len = type_len + name_len + 2;
-    const uint8_t flags = 0;
+    uint8_t flags = 0;
+    uint8_t data[4];
+    uint8_t data_len;
+    if (r.compress) {
+        data_len = pack_value(ap, ptype, data, flags);
+    } else {
+        data_len = AP_Param::type_size(ptype);
+        memcpy(data, ap, data_len);
+    }
+    uint8_t packed_len = data_len + name_len + 2;
+    uint8_t *pbuf = buf;
 
     /*
       see if we need to add padding to ensure that a data field never
       crosses a block boundary. This ensures that re-reading a block
       won't get a corrupt value for a parameter
      */
-    if (type_len > 1) {
+    if (data_len > 1) {
         const uint32_t ofs = c.token_ofs + sizeof(struct header) + packed_len;
         const uint32_t ofs_mod = ofs % r.read_size;
-        if (ofs_mod > 0 && ofs_mod < type_len) {
-            const uint8_t pad = type_len - ofs_mod;
+        if (ofs_mod > 0 && ofs_mod < data_len) {
+            const uint8_t pad = data_len - ofs_mod;
             memset(buf, 0, pad);
             buf += pad;
             packed_len += pad;
@@ -184,10 +305,14 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
     buf[0] = uint8_t(ptype) | (flags<<4);
     buf[1] = common_len | ((name_len-1)<<4);
     memcpy(&buf[2], pname, name_len);
-    memcpy(&buf[2+name_len], ap, type_len);
+    memcpy(&buf[2+name_len], data, data_len);
 
     strcpy(c.last_name, name);
 
+    if (r.compress) {
+        c.crc = crc_crc32(c.crc, pbuf, packed_len);
+    }
+
     return packed_len;
 }
 
@@ -254,18 +379,13 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         return -1;
     }
 
+    if (!fill_header(r)) {
+        errno = EINVAL;
+        return -1;
+    }
 
     if (r.file_ofs < sizeof(struct header)) {
-        struct header hdr;
-        hdr.total_params = AP_Param::count_parameters();
-        if (hdr.total_params <= r.start) {
-            errno = EINVAL;
-            return -1;
-        }
-        hdr.num_params = hdr.total_params - r.start;
-        if (r.count > 0 && hdr.num_params > r.count) {
-            hdr.num_params = r.count;
-        }
+        const struct header &hdr = r.hdr;
         uint8_t n = MIN(sizeof(hdr) - r.file_ofs, count);
         const uint8_t *b = (const uint8_t *)&hdr;
         memcpy(buf, &b[r.file_ofs], n);
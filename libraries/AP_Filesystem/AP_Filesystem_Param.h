@@ -40,13 +40,28 @@ private:
     // maximum size of one packed parameter
     static constexpr uint8_t max_pack_len = AP_MAX_NAME_SIZE + 2 + 4 + 3;
 
+    // header magic for the plain and compressed formats
+    static constexpr uint16_t pack_magic = 0x671b;
+    static constexpr uint16_t pack_magic_compressed = 0x671c;
+
+    // length of the CRC trailer on the compressed format
+    static constexpr uint8_t crc_len = 4;
+
     // header at front of the file
     struct header {
-        uint16_t magic = 0x671b;
+        uint16_t magic = pack_magic;
         uint16_t num_params;
         uint16_t total_params;
     };
 
+    // value length codes held in the flags field of the compressed format
+    enum class ValueLen : uint8_t {
+        FULL  = 0, // full length of the parameter type
+        ZERO  = 1, // value is zero, no data bytes
+        INT8  = 2, // value fits in an int8_t
+        INT16 = 3, // value fits in an int16_t
+    };
+
     struct cursor {
         AP_Param::ParamToken token;
         uint32_t token_ofs;
@@ -54,6 +69,8 @@ private:
         uint8_t trailer_len;
         uint8_t trailer[max_pack_len];
         uint16_t idx;
+        uint32_t crc;       // running CRC32 of the file up to token_ofs (compressed format)
+        bool eof;           // CRC trailer has been generated
     };
 
     struct rfile {
@@ -61,10 +78,16 @@ private:
         uint16_t read_size;
         uint16_t start;
         uint16_t count;
+        bool compress;
+        bool have_header;
+        struct header hdr;
         uint32_t file_ofs;
         struct cursor *cursors;
     } file[max_open_file];
 
+    bool fill_header(struct rfile &r);
+    uint8_t pack_value(const AP_Param *ap, enum ap_var_type ptype, uint8_t *buf, uint8_t &flags) const;
+
     bool token_seek(const struct rfile &r, const uint32_t data_ofs, struct cursor &c);
     uint8_t pack_param(const struct rfile &r, struct cursor &c, uint8_t *buf);
     bool check_file_name(const char *fname);
@@ -65,6 +65,17 @@ int AP_Filesystem_Sys::open(const char *fname, int flags)
             }
         }
     }
+    if (strcmp(fname, "taskhist.txt") == 0) {
+        const uint32_t max_size = 8192;
+        r.data->data = (char *)malloc(max_size);
+        if (r.data->data) {
+            r.data->length = AP::scheduler().task_histograms(r.data->data, max_size);
+            if (r.data->length == 0) {
+                free(r.data->data);
+                r.data->data = nullptr;
+            }
+        }
+    }
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     int8_t can_stats_num = -1;
     if (strcmp(fname, "can_log.txt") == 0) {
@@ -16,6 +16,7 @@
  */
 
 #include "AP_GyroFFT.h"
+#include "AP_GyroFFT_Peaks.h"
 
 #if HAL_GYROFFT_ENABLED
 
@@ -255,6 +256,10 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
             _harmonics++;
         }
     }
+    // with dynamic harmonics each peak has its own set of notches, so track as many as we can
+    if (_ins->has_harmonic_option(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
+        _harmonics = FrequencyPeak::MAX_TRACKED_PEAKS;
+    }
     _harmonics = constrain_int16(_harmonics, 1, FrequencyPeak::MAX_TRACKED_PEAKS);
 
     // calculate harmonic multiplier. this assumes the harmonics configured on the 
@@ -371,11 +376,7 @@ void AP_GyroFFT::update()
     _rpy_health.y = (now - _global_state._health_ms.y <= output_delay);
     _rpy_health.z = (now - _global_state._health_ms.z <= output_delay);
 
-    if (!_rpy_health.x && !_rpy_health.y) {
-        _health = 0;
-    } else {
-        _health = MIN(_global_state._health, _harmonics);
-    }
+    _health = AP_GyroFFT_Peaks::health(_global_state._health, _rpy_health.x, _rpy_health.y, _harmonics);
 }
 
 // analyse gyro data using FFT, returns number of samples still held
@@ -392,7 +393,7 @@ uint16_t AP_GyroFFT::run_cycle()
 
     // do we have enough samples for another pass?
     if (!start_analysis()) {
-        uint16_t new_sample_count =  get_available_samples(_update_axis);
+        uint16_t new_sample_count = get_available_samples();
         _sem.give();
         return new_sample_count;
     }
@@ -404,37 +405,44 @@ uint16_t AP_GyroFFT::run_cycle()
 
     uint32_t now = AP_HAL::micros();
 
-    // get the appropriate gyro buffer
-    FloatBuffer& gyro_buffer = (_sample_mode == 0 ?_ins->get_raw_gyro_window(_update_axis) : _downsampled_gyro_data[_update_axis]);
-    // if we have many more samples than the window size then we are struggling to 
-    // stay ahead of the gyro loop so drop samples so that this cycle will use all available samples
-    if (gyro_buffer.available() > uint32_t(_state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
-        gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
-    }
-    // let's go!
-    hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
+    // analyse all of the axes in one pass, sharing the FFT state, so that every axis is updated
+    // from a window ending at the same sample rather than waiting for the other axes to have a turn
+    uint8_t num_peaks[XYZ_AXIS_COUNT];
+    for (_update_axis = 0; _update_axis < XYZ_AXIS_COUNT; _update_axis++) {
+        // get the appropriate gyro buffer
+        FloatBuffer& gyro_buffer = (_sample_mode == 0 ?_ins->get_raw_gyro_window(_update_axis) : _downsampled_gyro_data[_update_axis]);
+        // if we have many more samples than the window size then we are struggling to
+        // stay ahead of the gyro loop so drop samples so that this cycle will use all available samples
+        if (gyro_buffer.available() > uint32_t(_state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
+            gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
+        }
+        // let's go!
+        hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
 
-    // calculate FFT and update filters outside the semaphore
-    uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+        // calculate FFT and update filters outside the semaphore
+        uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
 
-    // something has been detected, update the peak frequency and associated metrics
-    update_ref_energy(bin_max);
-    calculate_noise(false, config);
+        // something has been detected, update the peak frequency and associated metrics
+        update_ref_energy(bin_max);
+        num_peaks[_update_axis] = calculate_noise(false, config);
 
-    // record how we are doing
-    _thread_state._last_output_us[_update_axis] = AP_HAL::micros();
-    _output_cycle_micros = _thread_state._last_output_us[_update_axis] - now;
+        _thread_state._last_output_us[_update_axis] = AP_HAL::micros();
+    }
+    _update_axis = 0;
 
-    // move onto the next axis
-    _update_axis = (_update_axis + 1) % XYZ_AXIS_COUNT;
+    // health is the number of peaks on roll or pitch, yaw is not used for tracking
+    _thread_state._health = AP_GyroFFT_Peaks::tracked_peaks(num_peaks[0], num_peaks[1]);
+
+    // record how we are doing
+    _output_cycle_micros = AP_HAL::micros() - now;
 
     // ready to receive another frame, because lock contention is so expensive we don't lock
     // around this flag but rather rely on the semaphore at the beginning of the loop to
     // ensure eventual visibility to the main loop
     _thread_state._analysis_started = false;
 
-    // samples remaining in the next axis
-    return get_available_samples(_update_axis);
+    // samples remaining for the next frame
+    return get_available_samples();
 }
 
 // whether analysis can be run again or not
@@ -448,13 +456,23 @@ bool AP_GyroFFT::start_analysis() {
         return false;
     }
 
-    if (get_available_samples(_update_axis) >= _state->_window_size) {
+    if (get_available_samples() >= _state->_window_size) {
         _thread_state._analysis_started = true;
         return true;
     }
     return false;
 }
 
+// return the samples available on every axis
+uint16_t AP_GyroFFT::get_available_samples()
+{
+    uint16_t available = get_available_samples(0);
+    for (uint8_t axis = 1; axis < XYZ_AXIS_COUNT; axis++) {
+        available = MIN(available, get_available_samples(axis));
+    }
+    return available;
+}
+
 // update calculated values of dynamic parameters - runs at 1Hz
 void AP_GyroFFT::update_parameters()
 {
@@ -667,11 +685,7 @@ float AP_GyroFFT::get_slewed_weighted_freq_hz(FrequencyPeak peak) const
     const float freq_x = get_slewed_noise_center_freq_hz(peak, 0);
     const float freq_y = get_slewed_noise_center_freq_hz(peak, 1);
 
-    if (!energy.is_nan() && !is_zero(energy.x) && !is_zero(energy.y)) {
-        return (freq_x * energy.x + freq_y * energy.y) / (energy.x + energy.y);
-    } else {
-        return (freq_x + freq_y) * 0.5f;
-    }
+    return AP_GyroFFT_Peaks::weighted_freq_hz(freq_x, freq_y, energy.x, energy.y);
 }
 
 // return an average center frequency weighted by bin energy
@@ -725,7 +739,7 @@ uint8_t AP_GyroFFT::get_weighted_noise_center_frequencies_hz(uint8_t num_freqs,
 #endif
     }
 
-    const uint8_t tracked_peaks = MIN(_health, num_freqs);
+    uint8_t tracked_peaks = MIN(_health, num_freqs);
     // pitch was good or required, roll was not, use pitch only
     if (!_rpy_health.x || _harmonic_peak == FFT_HARMONIC_FIT_TRACK_PITCH) {
         for (uint8_t i = 0; i < tracked_peaks; i++) {
@@ -741,8 +755,15 @@ uint8_t AP_GyroFFT::get_weighted_noise_center_frequencies_hz(uint8_t num_freqs,
         return tracked_peaks;
     }
 
-    for (uint8_t i = 0; i < tracked_peaks; i++) {
-        freqs[i] = get_slewed_weighted_freq_hz(FrequencyPeak(i));
+    // each peak has its own notches. If roll and pitch disagree about where a peak is then
+    // they are probably seeing different sources, so give each axis its own notches
+    tracked_peaks = 0;
+    for (uint8_t i = 0; i < _health && tracked_peaks < num_freqs; i++) {
+        const Vector3f& energy = get_center_freq_energy(FrequencyPeak(i));
+        tracked_peaks += AP_GyroFFT_Peaks::select_freqs(get_slewed_noise_center_freq_hz(FrequencyPeak(i), 0),
+                                                        get_slewed_noise_center_freq_hz(FrequencyPeak(i), 1),
+                                                        energy.x, energy.y, _state->_bin_resolution,
+                                                        num_freqs - tracked_peaks, &freqs[tracked_peaks]);
     }
     return tracked_peaks;
 }
@@ -871,9 +892,9 @@ float AP_GyroFFT::get_weighted_noise_center_bandwidth_hz() const
     return calculate_weighted_freq_hz(get_center_freq_energy(peak), get_noise_center_bandwidth_hz(peak));
 }
 
-// calculate noise frequencies from FFT data provided by the HAL subsystem
+// calculate noise frequencies from FFT data provided by the HAL subsystem, returns the number of peaks found
 // called from FFT thread
-void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
+uint8_t AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
 {
     // calculate the SNR and center frequency energy
     float weighted_center_freq_hz = 0.0f;
@@ -890,7 +911,6 @@ void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
     } else {
         _thread_state._health_ms[_update_axis] = 0;
     }
-    _thread_state._health = num_peaks;
     FrequencyPeak tracked_peak = FrequencyPeak::CENTER;
 
     // record the tracked peak for harmonic fit, but only if we have more than one noise peak
@@ -932,6 +952,7 @@ void AP_GyroFFT::calculate_noise(bool calibrating, const EngineConfig& config)
     _debug_snr = snr;
     _debug_max_bin = _state->_peak_data[FrequencyPeak::CENTER]._bin;
 #endif
+    return num_peaks;
 }
 
 
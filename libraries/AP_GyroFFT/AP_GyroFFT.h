@@ -177,8 +177,8 @@ private:
     }
     // write single log mesages
     void log_noise_peak(uint8_t id, FrequencyPeak peak, float notch_freq);
-    // calculate the peak noise frequency
-    void calculate_noise(bool calibrating, const EngineConfig& config);
+    // calculate the peak noise frequency, returning the number of peaks
+    uint8_t calculate_noise(bool calibrating, const EngineConfig& config);
     // calculate noise peaks based on energy and history
     uint8_t calculate_tracking_peaks(float& weighted_peak_freq_hz, float& snr, bool calibrating, const EngineConfig& config);
     // calculate noise peak frequency characteristics
@@ -207,6 +207,8 @@ private:
     uint16_t get_available_samples(uint8_t axis) {
         return _sample_mode == 0 ?_ins->get_raw_gyro_window(axis).available() : _downsampled_gyro_data[axis].available();
     }
+    // return samples available on all of the axes
+    uint16_t get_available_samples();
     // semaphore for access to shared FFT data
     HAL_Semaphore _sem;
 
@@ -265,7 +267,7 @@ private:
 
     // state of the FFT engine
     AP_HAL::DSP::FFTWindowState* _state;
-    // update state machine step information
+    // axis currently being analysed
     uint8_t _update_axis;
     // noise base of the gyros
     Vector3f* _ref_energy;
@@ -0,0 +1,73 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  choice of the notch frequencies for the peaks detected on roll and pitch
+ */
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+class AP_GyroFFT_Peaks {
+public:
+    // number of peaks tracked in a frame, yaw is not used for tracking
+    static uint8_t tracked_peaks(uint8_t roll_peaks, uint8_t pitch_peaks) {
+        return MAX(roll_peaks, pitch_peaks);
+    }
+
+    // number of peaks to notch, none if neither roll nor pitch has recently seen a peak
+    static uint8_t health(uint8_t peaks, bool roll_healthy, bool pitch_healthy, uint8_t harmonics) {
+        if (!roll_healthy && !pitch_healthy) {
+            return 0;
+        }
+        return MIN(peaks, harmonics);
+    }
+
+    // frequency of a peak weighted by its energy on roll and pitch, the
+    // average if either axis has no energy
+    static float weighted_freq_hz(float freq_x, float freq_y, float energy_x, float energy_y) {
+        if (has_energy(energy_x) && has_energy(energy_y)) {
+            return (freq_x * energy_x + freq_y * energy_y) / (energy_x + energy_y);
+        }
+        return (freq_x + freq_y) * 0.5f;
+    }
+
+    // write the frequencies to notch for one peak to freqs, which has
+    // room for at least one, returning the number written. A peak is
+    // only given a notch on each axis if both axes have energy at it and
+    // they disagree about where it is by more than a bin
+    static uint8_t select_freqs(float freq_x, float freq_y, float energy_x, float energy_y,
+                                float bin_resolution, uint8_t room, float* freqs) {
+        const bool has_x = has_energy(energy_x);
+        const bool has_y = has_energy(energy_y);
+        if (has_x && has_y && fabsf(freq_x - freq_y) > bin_resolution && room > 1) {
+            freqs[0] = freq_x;
+            freqs[1] = freq_y;
+            return 2;
+        }
+        if (has_x && !has_y) {
+            freqs[0] = freq_x;
+        } else if (has_y && !has_x) {
+            freqs[0] = freq_y;
+        } else {
+            freqs[0] = weighted_freq_hz(freq_x, freq_y, energy_x, energy_y);
+        }
+        return 1;
+    }
+
+private:
+    static bool has_energy(float energy) {
+        return !isnan(energy) && !is_zero(energy);
+    }
+};
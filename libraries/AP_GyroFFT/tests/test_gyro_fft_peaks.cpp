@@ -0,0 +1,66 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_GyroFFT/AP_GyroFFT_Peaks.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+typedef AP_GyroFFT_Peaks Peaks;
+
+TEST(AP_GyroFFT_Peaks, SplitWhenAxesDisagree)
+{
+    float freqs[2] {};
+    // both axes see the peak, more than a bin apart
+    EXPECT_EQ(2, Peaks::select_freqs(100.0f, 140.0f, 1.0f, 2.0f, 10.0f, 2, freqs));
+    EXPECT_FLOAT_EQ(100.0f, freqs[0]);
+    EXPECT_FLOAT_EQ(140.0f, freqs[1]);
+}
+
+TEST(AP_GyroFFT_Peaks, NoSplitWhenAxesAgree)
+{
+    float freqs[2] {};
+    // within a bin of each other, so one energy weighted notch
+    EXPECT_EQ(1, Peaks::select_freqs(100.0f, 105.0f, 1.0f, 3.0f, 10.0f, 2, freqs));
+    EXPECT_FLOAT_EQ(103.75f, freqs[0]);
+}
+
+TEST(AP_GyroFFT_Peaks, NoSplitWithoutRoom)
+{
+    float freqs[1] {};
+    EXPECT_EQ(1, Peaks::select_freqs(100.0f, 140.0f, 1.0f, 1.0f, 10.0f, 1, freqs));
+    EXPECT_FLOAT_EQ(120.0f, freqs[0]);
+}
+
+TEST(AP_GyroFFT_Peaks, SingleAxisEnergy)
+{
+    float freqs[2] {};
+    // only roll has energy at this peak, the pitch frequency is meaningless
+    EXPECT_EQ(1, Peaks::select_freqs(100.0f, 300.0f, 1.0f, 0.0f, 10.0f, 2, freqs));
+    EXPECT_FLOAT_EQ(100.0f, freqs[0]);
+    // only pitch
+    EXPECT_EQ(1, Peaks::select_freqs(100.0f, 300.0f, 0.0f, 1.0f, 10.0f, 2, freqs));
+    EXPECT_FLOAT_EQ(300.0f, freqs[0]);
+    // a NaN energy counts as none
+    EXPECT_EQ(1, Peaks::select_freqs(100.0f, 300.0f, nanf(""), 1.0f, 10.0f, 2, freqs));
+    EXPECT_FLOAT_EQ(300.0f, freqs[0]);
+    // neither axis has energy, use the average
+    EXPECT_EQ(1, Peaks::select_freqs(100.0f, 300.0f, 0.0f, 0.0f, 10.0f, 2, freqs));
+    EXPECT_FLOAT_EQ(200.0f, freqs[0]);
+}
+
+TEST(AP_GyroFFT_Peaks, Health)
+{
+    EXPECT_EQ(3, Peaks::tracked_peaks(3, 1));
+    EXPECT_EQ(2, Peaks::tracked_peaks(0, 2));
+
+    // no peaks if neither roll nor pitch is healthy
+    EXPECT_EQ(0, Peaks::health(3, false, false, 3));
+    // either axis is enough
+    EXPECT_EQ(3, Peaks::health(3, true, false, 3));
+    EXPECT_EQ(3, Peaks::health(3, false, true, 3));
+    // no more peaks than harmonics
+    EXPECT_EQ(2, Peaks::health(3, true, true, 2));
+    EXPECT_EQ(1, Peaks::health(1, true, true, 2));
+}
+
+AP_GTEST_MAIN()
@@ -184,7 +184,7 @@
 #endif
 
 #ifndef HAL_WITH_DSP
-#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || defined(HAL_BOOTLOADER_BUILD) || defined(HAL_BUILD_AP_PERIPH) || BOARD_FLASH_SIZE <= 1024
+#if defined(HAL_BOOTLOADER_BUILD) || defined(HAL_BUILD_AP_PERIPH) || BOARD_FLASH_SIZE <= 1024
 #define HAL_WITH_DSP 0
 #else
 #define HAL_WITH_DSP !HAL_MINIMIZE_FEATURES
@@ -0,0 +1,52 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/utility/RingBuffer.h>
+
+/*
+  every thread pushes and then pops one object, so with more than one
+  thread the producers and consumers contend for the same buffer
+ */
+struct Sample {
+    uint64_t timestamp_us;
+    float value[3];
+};
+
+static ObjectBuffer_TS<Sample> buf_ts(64);
+static ObjectBuffer_LF<Sample> buf_lf(64);
+static ObjectBuffer_LF<Sample> buf_lf_spsc(64, RingBufferProducers::SINGLE);
+
+template <class Buffer>
+static void push_pop(benchmark::State& state, Buffer &buf)
+{
+    Sample s {};
+    while (state.KeepRunning()) {
+        s.timestamp_us++;
+        gbenchmark_escape(&s);
+        bool ok = buf.push(s);
+        gbenchmark_escape(&ok);
+        ok = buf.pop(s);
+        gbenchmark_escape(&ok);
+    }
+}
+
+static void BM_ObjectBuffer_TS(benchmark::State& state)
+{
+    push_pop(state, buf_ts);
+}
+
+static void BM_ObjectBuffer_LF(benchmark::State& state)
+{
+    push_pop(state, buf_lf);
+}
+
+// uncontended: a single producer is the only thread using the buffer
+static void BM_ObjectBuffer_LF_SingleProducer(benchmark::State& state)
+{
+    push_pop(state, buf_lf_spsc);
+}
+
+BENCHMARK(BM_ObjectBuffer_TS)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ObjectBuffer_LF)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ObjectBuffer_LF_SingleProducer);
+
+BENCHMARK_MAIN();
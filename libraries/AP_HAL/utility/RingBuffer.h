@@ -426,6 +426,292 @@ private:
     HAL_Semaphore sem;
 };
 
+/*
+  Lock free ring buffer class for objects of fixed size
+
+  This is a drop-in alternative to ObjectBuffer_TS for queues that are
+  pushed to from time critical threads. Instead of a semaphore each
+  slot carries a sequence number which tells producers and consumers
+  whether it is free or holds an object, so a thread which is
+  preempted mid-operation never blocks the others and there is no
+  priority inversion between, for example, a sensor thread pushing
+  and the IO thread popping.
+
+  Producers can be declared SINGLE at construction, which removes the
+  compare-and-swap from push(). Consumers always use a compare-and-swap
+  so that push_force() can discard objects from a producer thread.
+
+  Differences from ObjectBuffer_TS:
+   - the number of objects is rounded up to a power of two
+   - pushing N objects is not atomic with respect to other producers,
+     the objects may be interleaved with theirs
+   - readptr() is not available as objects are not stored contiguously
+   - peek(), update() and clear() must only be called from the consumer
+ */
+enum class RingBufferProducers : uint8_t {
+    SINGLE,
+    MULTIPLE,
+};
+
+template <class T>
+class ObjectBuffer_LF {
+public:
+    ObjectBuffer_LF(uint32_t _size = 0, RingBufferProducers _producers = RingBufferProducers::MULTIPLE) :
+        multiple_producers(_producers == RingBufferProducers::MULTIPLE) {
+        set_size(_size);
+    }
+    ~ObjectBuffer_LF(void) {
+        delete[] cells;
+    }
+
+    // return size of ringbuffer
+    uint32_t get_size(void) const {
+        return cells != nullptr ? mask + 1 : 0;
+    }
+
+    // set size of ringbuffer, caller responsible for locking
+    bool set_size(uint32_t size) {
+        delete[] cells;
+        cells = nullptr;
+        mask = 0;
+        head.store(0);
+        tail.store(0);
+        if (size == 0) {
+            return true;
+        }
+        uint32_t n = 1;
+        while (n < size) {
+            n <<= 1;
+        }
+        cells = new Cell[n];
+        if (cells == nullptr) {
+            return false;
+        }
+        for (uint32_t i=0; i<n; i++) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        mask = n - 1;
+        return true;
+    }
+
+    // read len objects without advancing the read pointer, consumer only
+    uint32_t peek(T *data, uint32_t len) {
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        uint32_t i;
+        for (i=0; i<len && cells != nullptr; i++, pos++) {
+            const Cell &cell = cells[pos & mask];
+            if (cell.seq.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            data[i] = cell.object;
+        }
+        return i;
+    }
+
+    // Discards the buffer content, emptying it. Consumer only
+    void clear(void) {
+        while (pop()) {}
+    }
+
+    // return number of objects available to be read from the front of the queue
+    uint32_t available(void) const {
+        const uint32_t h = head.load(std::memory_order_acquire);
+        const uint32_t t = tail.load(std::memory_order_acquire);
+        // the two loads are not atomic together, so clamp
+        if ((int32_t)(t - h) <= 0) {
+            return 0;
+        }
+        return (t - h) < get_size() ? (t - h) : get_size();
+    }
+
+    // return number of objects that could be written to the back of the queue
+    uint32_t space(void) const {
+        return get_size() - available();
+    }
+
+    // true is available() == 0
+    bool is_empty(void) const WARN_IF_UNUSED {
+        return available() == 0;
+    }
+
+    // push one object onto the back of the queue
+    bool push(const T &object) {
+        if (cells == nullptr) {
+            return false;
+        }
+        uint32_t pos = tail.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            const int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - pos);
+            if (diff < 0) {
+                // slot still holds an object from the previous lap: full
+                return false;
+            }
+            if (diff > 0) {
+                // another producer has taken this slot
+                pos = tail.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (!multiple_producers) {
+                tail.store(pos + 1, std::memory_order_relaxed);
+                break;
+            }
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        cell->object = object;
+        // publish the object to the consumer
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // push N objects onto the back of the queue
+    bool push(const T *object, uint32_t n) {
+        if (space() < n) {
+            return false;
+        }
+        for (uint32_t i=0; i<n; i++) {
+            if (!push(object[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+      throw away an object from the front of the queue
+     */
+    bool pop(void) {
+        T object;
+        return pop(object);
+    }
+
+    /*
+      pop earliest object off the front of the queue
+     */
+    bool pop(T &object) WARN_IF_UNUSED {
+        if (cells == nullptr) {
+            return false;
+        }
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            const int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff < 0) {
+                // nothing published in this slot yet: empty
+                return false;
+            }
+            if (diff > 0) {
+                // a push_force() discarded this object
+                pos = head.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        object = cell->object;
+        // hand the slot back to the producers for the next lap
+        cell->seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * push_force() discards the oldest object if the buffer is full:
+     *   if (!push(t)) { pop(); push(t); }
+     * The slot freed by pop() may be taken by another producer, and
+     * pop() fails while the oldest slot is still being written by a
+     * producer which may not get to run again before we give up, so
+     * this retries a bounded number of times and may return false
+     */
+    bool push_force(const T &object) {
+        if (cells == nullptr) {
+            return false;
+        }
+        for (uint8_t i=0; i<push_force_attempts; i++) {
+            if (push(object)) {
+                return true;
+            }
+            UNUSED_RESULT(pop());
+        }
+        return false;
+    }
+
+    /*
+     * push_force() N objects
+     */
+    bool push_force(const T *object, uint32_t n) {
+        if (n > get_size()) {
+            return false;
+        }
+        for (uint32_t i=0; i<n; i++) {
+            if (!push_force(object[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+      peek copies an object out from the front of the queue without
+      advancing the read pointer. Consumer only
+     */
+    bool peek(T &object) WARN_IF_UNUSED {
+        return peek(&object, 1) == 1;
+    }
+
+    // advance the read pointer (discarding objects)
+    bool advance(uint32_t n) {
+        if (available() < n) {
+            return false;
+        }
+        for (uint32_t i=0; i<n; i++) {
+            if (!pop()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* update the object at the front of the queue (the one that would
+       be fetched by pop()). Consumer only */
+    bool update(const T &object) {
+        if (cells == nullptr) {
+            return false;
+        }
+        const uint32_t pos = head.load(std::memory_order_relaxed);
+        Cell &cell = cells[pos & mask];
+        if (cell.seq.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        cell.object = object;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T object;
+    };
+    Cell *cells = nullptr;
+    uint32_t mask;
+    const bool multiple_producers;
+
+    // number of times push_force() tries to make room before giving up
+    static const uint8_t push_force_attempts = 4;
+
+    // keep the producer and consumer positions apart so they don't
+    // share a cache line and bounce between CPUs. This is done with
+    // padding rather than alignas as operator new does not honour
+    // over-alignment
+    std::atomic<uint32_t> head{0}; // next object to pop
+    uint8_t pad[64 - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> tail{0}; // next slot to push into
+};
+
 /*
   ring buffer class for objects of fixed size with pointer
   access. Note that this is not thread safe, buf offers efficient
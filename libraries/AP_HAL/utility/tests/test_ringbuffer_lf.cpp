@@ -0,0 +1,150 @@
+#include <AP_gtest.h>
+
+#include <thread>
+#include <AP_HAL/utility/RingBuffer.h>
+
+TEST(ObjectBuffer_LF, RoundsUpSize)
+{
+    ObjectBuffer_LF<uint32_t> buf(5);
+    EXPECT_EQ(8U, buf.get_size());
+    EXPECT_EQ(8U, buf.space());
+    EXPECT_TRUE(buf.is_empty());
+}
+
+TEST(ObjectBuffer_LF, PushPop)
+{
+    ObjectBuffer_LF<uint32_t> buf(4, RingBufferProducers::SINGLE);
+    for (uint32_t i=0; i<4; i++) {
+        EXPECT_TRUE(buf.push(i));
+    }
+    EXPECT_FALSE(buf.push(99U));
+    EXPECT_EQ(4U, buf.available());
+
+    uint32_t v;
+    EXPECT_TRUE(buf.peek(v));
+    EXPECT_EQ(0U, v);
+    EXPECT_TRUE(buf.update(10U));
+    for (uint32_t i=0; i<4; i++) {
+        EXPECT_TRUE(buf.pop(v));
+        EXPECT_EQ(i == 0 ? 10U : i, v);
+    }
+    EXPECT_FALSE(buf.pop(v));
+    EXPECT_FALSE(buf.update(1U));
+}
+
+TEST(ObjectBuffer_LF, Wraps)
+{
+    ObjectBuffer_LF<uint32_t> buf(4);
+    uint32_t v;
+    for (uint32_t i=0; i<1000; i++) {
+        EXPECT_TRUE(buf.push(i));
+        EXPECT_TRUE(buf.push(i+1));
+        EXPECT_TRUE(buf.pop(v));
+        EXPECT_EQ(i, v);
+        EXPECT_TRUE(buf.pop(v));
+        EXPECT_EQ(i+1, v);
+    }
+}
+
+TEST(ObjectBuffer_LF, PushForce)
+{
+    ObjectBuffer_LF<uint32_t> buf(4);
+    for (uint32_t i=0; i<6; i++) {
+        EXPECT_TRUE(buf.push_force(i));
+    }
+    EXPECT_EQ(4U, buf.available());
+    uint32_t out[4];
+    EXPECT_EQ(4U, buf.peek(out, 4));
+    EXPECT_EQ(2U, out[0]);
+    EXPECT_EQ(5U, out[3]);
+
+    const uint32_t more[] { 6, 7, 8 };
+    EXPECT_TRUE(buf.push_force(more, 3));
+    EXPECT_TRUE(buf.advance(3));
+    uint32_t v;
+    EXPECT_TRUE(buf.pop(v));
+    EXPECT_EQ(8U, v);
+    buf.push(9U);
+    buf.clear();
+    EXPECT_TRUE(buf.is_empty());
+}
+
+/*
+  each producer pushes an increasing sequence; the consumer must see
+  every object exactly once and each producer's objects in order
+ */
+TEST(ObjectBuffer_LF, MultipleProducers)
+{
+    const uint8_t num_producers = 3;
+    const uint32_t count = 5000;
+    ObjectBuffer_LF<uint32_t> buf(64);
+
+    std::thread producers[num_producers];
+    for (uint8_t p=0; p<num_producers; p++) {
+        producers[p] = std::thread([&buf, p, count]() {
+            for (uint32_t i=0; i<count; ) {
+                if (buf.push((uint32_t(p) << 24) | i)) {
+                    i++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    uint32_t next[num_producers] {};
+    uint32_t received = 0;
+    while (received < num_producers * count) {
+        uint32_t v;
+        if (!buf.pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const uint8_t p = v >> 24;
+        ASSERT_LT(p, num_producers);
+        ASSERT_EQ(next[p], v & 0xFFFFFF);
+        next[p]++;
+        received++;
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    EXPECT_TRUE(buf.is_empty());
+}
+
+/*
+  producers racing each other to make room in a full buffer must not
+  spin forever, each push_force() either succeeds or gives up. A
+  producer descheduled part way through a push blocks the others'
+  pops until it runs again, so on a loaded machine any one producer
+  may never succeed; only the total is checked
+ */
+TEST(ObjectBuffer_LF, PushForceMultipleProducers)
+{
+    const uint8_t num_producers = 4;
+    const uint32_t count = 20000;
+    ObjectBuffer_LF<uint32_t> buf(8);
+
+    std::thread producers[num_producers];
+    uint32_t pushed[num_producers] {};
+    for (uint8_t p=0; p<num_producers; p++) {
+        producers[p] = std::thread([&buf, &pushed, p, count]() {
+            for (uint32_t i=0; i<count; i++) {
+                if (buf.push_force(i)) {
+                    pushed[p]++;
+                }
+            }
+        });
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    EXPECT_EQ(buf.get_size(), buf.available());
+    uint32_t total = 0;
+    for (uint8_t p=0; p<num_producers; p++) {
+        total += pushed[p];
+    }
+    EXPECT_GT(total, 0U);
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,304 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DSP.h"
+
+#if HAL_WITH_DSP
+
+#include <AP_Math/AP_Math.h>
+#include <GCS_MAVLink/GCS.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace Linux;
+
+extern const AP_HAL::HAL& hal;
+
+// initialize the FFT state machine
+AP_HAL::DSP::FFTWindowState* DSP::fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics)
+{
+    // the real FFT needs a complex FFT of at least two points
+    if (window_size < 4 || (window_size & (window_size - 1)) != 0) {
+        return nullptr;
+    }
+    DSP::FFTWindowStateLinux* fft = new DSP::FFTWindowStateLinux(window_size, sample_rate, harmonics);
+    if (fft == nullptr || fft->_hanning_window == nullptr || fft->_rfft_data == nullptr || fft->_freq_bins == nullptr || fft->_derivative_freq_bins == nullptr
+        || fft->_bit_reverse == nullptr || fft->_twiddle == nullptr || fft->_split_twiddle == nullptr) {
+        delete fft;
+        return nullptr;
+    }
+    return fft;
+}
+
+// start an FFT analysis
+void DSP::fft_start(AP_HAL::DSP::FFTWindowState* state, FloatBuffer& samples, uint16_t advance)
+{
+    step_hanning((FFTWindowStateLinux*)state, samples, advance);
+}
+
+// perform remaining steps of an FFT analysis
+uint16_t DSP::fft_analyse(AP_HAL::DSP::FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
+{
+    FFTWindowStateLinux* fft = (FFTWindowStateLinux*)state;
+    step_rfft(fft);
+    step_cmplx_mag_squared(fft);
+    step_cmplx_mag(fft, start_bin, end_bin, noise_att_cutoff);
+    return step_calc_frequencies(fft, start_bin, end_bin);
+}
+
+// create an instance of the FFT state machine
+DSP::FFTWindowStateLinux::FFTWindowStateLinux(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics)
+    : AP_HAL::DSP::FFTWindowState::FFTWindowState(window_size, sample_rate, harmonics)
+{
+    if (_freq_bins == nullptr || _hanning_window == nullptr || _rfft_data == nullptr || _derivative_freq_bins == nullptr) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate window for DSP");
+        return;
+    }
+
+    // the complex FFT is over half the window
+    const uint16_t n = _bin_count;
+
+    _bit_reverse = new uint16_t[n];
+    _twiddle = new float[n];
+    _split_twiddle = new float[n + 2];
+    if (_bit_reverse == nullptr || _twiddle == nullptr || _split_twiddle == nullptr) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate tables for DSP");
+        return;
+    }
+
+    uint8_t bits = 0;
+    while ((1U << bits) < n) {
+        bits++;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t r = 0;
+        for (uint8_t b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1U) << (bits - 1 - b);
+        }
+        _bit_reverse[i] = r;
+    }
+
+    // the butterflies only use the first half turn
+    for (uint16_t k = 0; k < n / 2; k++) {
+        const double a = 2.0 * M_PI * k / n;
+        _twiddle[2*k] = cos(a);
+        _twiddle[2*k+1] = -sin(a);
+    }
+    for (uint16_t k = 0; k <= n / 2; k++) {
+        const double a = M_PI * k / n;
+        _split_twiddle[2*k] = cos(a);
+        _split_twiddle[2*k+1] = -sin(a);
+    }
+}
+
+DSP::FFTWindowStateLinux::~FFTWindowStateLinux()
+{
+    delete[] _bit_reverse;
+    delete[] _twiddle;
+    delete[] _split_twiddle;
+}
+
+// step 1: filter the incoming samples through a Hanning window
+void DSP::step_hanning(FFTWindowStateLinux* fft, FloatBuffer& samples, uint16_t advance)
+{
+    // apply hanning window to gyro samples and store result in _freq_bins
+    samples.peek(&fft->_freq_bins[0], fft->_window_size); // the caller ensures we get a full buffer of samples
+    samples.advance(advance);
+    mult_f32(&fft->_freq_bins[0], &fft->_hanning_window[0], &fft->_freq_bins[0], fft->_window_size);
+}
+
+/*
+  step 2: the real FFT of N samples. Even and odd samples are treated
+  as the real and imaginary parts of an N/2 point complex FFT, which is
+  then split into the N/2+1 bins of the real spectrum. Output is in
+  _rfft_data as interleaved real and imaginary parts, including the
+  Nyquist bin
+ */
+void DSP::step_rfft(FFTWindowStateLinux* fft)
+{
+    const uint16_t n = fft->_bin_count;
+    const float* in = fft->_freq_bins;
+    float* data = fft->_rfft_data;
+
+    // load in bit reversed order
+    for (uint16_t i = 0; i < n; i++) {
+        const uint16_t r = fft->_bit_reverse[i];
+        data[2*r] = in[2*i];
+        data[2*r+1] = in[2*i+1];
+    }
+
+    complex_fft(fft, data);
+
+    // DC and Nyquist are both real
+    const float z0r = data[0];
+    const float z0i = data[1];
+    data[0] = z0r + z0i;
+    data[1] = 0;
+    data[2*n] = z0r - z0i;
+    data[2*n+1] = 0;
+
+    /*
+      for bins k and n-k, with A = Z[k] and B = conj(Z[n-k]):
+        E = (A + B) / 2       spectrum of the even samples
+        O = (A - B) / 2i      spectrum of the odd samples
+        X[k] = E + W^k O
+        X[n-k] = conj(E - W^k O)
+     */
+    const float* w = fft->_split_twiddle;
+    for (uint16_t k = 1; k <= n / 2; k++) {
+        const uint16_t j = n - k;
+        const float ar = data[2*k], ai = data[2*k+1];
+        const float br = data[2*j], bi = -data[2*j+1];
+        const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+        const float orr = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+        const float tr = w[2*k] * orr - w[2*k+1] * oi;
+        const float ti = w[2*k] * oi + w[2*k+1] * orr;
+        data[2*k] = er + tr;
+        data[2*k+1] = ei + ti;
+        data[2*j] = er - tr;
+        data[2*j+1] = -(ei - ti);
+    }
+}
+
+/*
+  in-place decimation in time FFT of bit reversed complex data. Pairs
+  of radix-2 stages are merged into radix-4 butterflies, saving a pass
+  over the data and a quarter of the multiplies. An odd number of
+  stages starts with a radix-2 pass
+ */
+void DSP::complex_fft(FFTWindowStateLinux* fft, float* x)
+{
+    const uint16_t n = fft->_bin_count;
+    const float* tw = fft->_twiddle;
+    uint16_t q = 1;
+
+    uint8_t bits = 0;
+    while ((1U << bits) < n) {
+        bits++;
+    }
+    if (bits & 1U) {
+        for (uint16_t i = 0; i < n; i += 2) {
+            const float ar = x[2*i], ai = x[2*i+1];
+            const float br = x[2*i+2], bi = x[2*i+3];
+            x[2*i] = ar + br;
+            x[2*i+1] = ai + bi;
+            x[2*i+2] = ar - br;
+            x[2*i+3] = ai - bi;
+        }
+        q = 2;
+    }
+
+    // each pass does the stages of size 2q and 4q
+    for (; q < n; q *= 4) {
+        const uint16_t step1 = n / (2*q);
+        const uint16_t step2 = n / (4*q);
+        for (uint16_t k = 0; k < q; k++) {
+            const float w1r = tw[2*k*step1], w1i = tw[2*k*step1+1];
+            const float w2r = tw[2*k*step2], w2i = tw[2*k*step2+1];
+            for (uint16_t i0 = k; i0 < n; i0 += 4*q) {
+                float* p0 = &x[2*i0];
+                float* p1 = &x[2*(i0+q)];
+                float* p2 = &x[2*(i0+2*q)];
+                float* p3 = &x[2*(i0+3*q)];
+
+                // first stage, the twiddle for size 2q
+                const float a1r = w1r * p1[0] - w1i * p1[1];
+                const float a1i = w1r * p1[1] + w1i * p1[0];
+                const float a3r = w1r * p3[0] - w1i * p3[1];
+                const float a3i = w1r * p3[1] + w1i * p3[0];
+                const float b0r = p0[0] + a1r, b0i = p0[1] + a1i;
+                const float b1r = p0[0] - a1r, b1i = p0[1] - a1i;
+                const float b2r = p2[0] + a3r, b2i = p2[1] + a3i;
+                const float b3r = p2[0] - a3r, b3i = p2[1] - a3i;
+
+                // second stage, the twiddle for size 4q. The odd
+                // butterfly's twiddle is a further quarter turn, -i
+                const float tr = w2r * b2r - w2i * b2i;
+                const float ti = w2r * b2i + w2i * b2r;
+                const float ur = w2r * b3i + w2i * b3r;
+                const float ui = -(w2r * b3r - w2i * b3i);
+
+                p0[0] = b0r + tr;
+                p0[1] = b0i + ti;
+                p2[0] = b0r - tr;
+                p2[1] = b0i - ti;
+                p1[0] = b1r + ur;
+                p1[1] = b1i + ui;
+                p3[0] = b1r - ur;
+                p3[1] = b1i - ui;
+            }
+        }
+    }
+}
+
+// step 3: find the power in each bin, including DC and Nyquist
+void DSP::step_cmplx_mag_squared(FFTWindowStateLinux* fft)
+{
+    const float* data = fft->_rfft_data;
+    for (uint16_t k = 0; k <= fft->_bin_count; k++) {
+        fft->_freq_bins[k] = sq(data[2*k]) + sq(data[2*k+1]);
+    }
+}
+
+void DSP::mult_f32(const float* v1, const float* v2, float* vout, uint16_t len) const
+{
+    uint16_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(&vout[i], vmulq_f32(vld1q_f32(&v1[i]), vld1q_f32(&v2[i])));
+    }
+#endif
+    for (; i < len; i++) {
+        vout[i] = v1[i] * v2[i];
+    }
+}
+
+void DSP::vector_max_float(const float* vin, uint16_t len, float* max_value, uint16_t* max_index) const
+{
+    *max_value = vin[0];
+    *max_index = 0;
+    for (uint16_t i = 1; i < len; i++) {
+        if (vin[i] > *max_value) {
+            *max_value = vin[i];
+            *max_index = i;
+        }
+    }
+}
+
+void DSP::vector_scale_float(const float* vin, float scale, float* vout, uint16_t len) const
+{
+    uint16_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= len; i += 4) {
+        vst1q_f32(&vout[i], vmulq_n_f32(vld1q_f32(&vin[i]), scale));
+    }
+#endif
+    for (; i < len; i++) {
+        vout[i] = vin[i] * scale;
+    }
+}
+
+float DSP::vector_mean_float(const float* vin, uint16_t len) const
+{
+    float sum = 0.0f;
+    for (uint16_t i = 0; i < len; i++) {
+        sum += vin[i];
+    }
+    return sum / len;
+}
+
+#endif // HAL_WITH_DSP
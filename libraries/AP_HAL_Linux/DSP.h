@@ -0,0 +1,74 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AP_HAL_Linux.h"
+
+#if HAL_WITH_DSP
+
+namespace Linux {
+
+/*
+  FFT analysis for Linux boards. A real FFT of N samples is computed
+  as a complex FFT of N/2 points using radix-4 butterflies, with one
+  radix-2 pass when log2(N/2) is odd, followed by a split into the N/2+1
+  real spectrum bins. Twiddle factors and the bit reversal permutation
+  are precomputed for each window size. Vector operations use NEON
+  where available
+ */
+class DSP : public AP_HAL::DSP {
+public:
+    // initialise an FFT instance
+    FFTWindowState* fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics) override;
+    // start an FFT analysis with an ObjectBuffer
+    void fft_start(FFTWindowState* state, FloatBuffer& samples, uint16_t advance) override;
+    // perform remaining steps of an FFT analysis
+    uint16_t fft_analyse(FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff) override;
+
+    class FFTWindowStateLinux : public AP_HAL::DSP::FFTWindowState {
+        friend class Linux::DSP;
+    public:
+        FFTWindowStateLinux(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics);
+        virtual ~FFTWindowStateLinux();
+
+    private:
+        // bit reversed index of each point of the complex FFT
+        uint16_t* _bit_reverse;
+        // exp(-2*pi*i*k/(N/2)) for the complex FFT, interleaved cos, sin
+        float* _twiddle;
+        // exp(-2*pi*i*k/N) for splitting the complex FFT into real bins
+        float* _split_twiddle;
+    };
+
+protected:
+    void vector_max_float(const float* vin, uint16_t len, float* max_value, uint16_t* max_index) const override;
+    void vector_scale_float(const float* vin, float scale, float* vout, uint16_t len) const override;
+    float vector_mean_float(const float* vin, uint16_t len) const override;
+
+private:
+    // step 1: filter the incoming samples through a Hanning window
+    void step_hanning(FFTWindowStateLinux* fft, FloatBuffer& samples, uint16_t advance);
+    // step 2: real FFT of the windowed samples into _rfft_data
+    void step_rfft(FFTWindowStateLinux* fft);
+    // step 3: power of each bin into _freq_bins
+    void step_cmplx_mag_squared(FFTWindowStateLinux* fft);
+
+    void complex_fft(FFTWindowStateLinux* fft, float* data);
+    void mult_f32(const float* v1, const float* v2, float* vout, uint16_t len) const;
+};
+
+}
+
+#endif // HAL_WITH_DSP
@@ -45,6 +45,7 @@
 #include "Util.h"
 #include "Util_RPI.h"
 #include "CANSocketIface.h"
+#include "DSP.h"
 
 using namespace Linux;
 
@@ -216,7 +217,11 @@ static OpticalFlow_Onboard opticalFlow;
 static Empty::OpticalFlow opticalFlow;
 #endif
 
+#if HAL_WITH_DSP
+static DSP dspDriver;
+#else
 static Empty::DSP dspDriver;
+#endif
 static Empty::Flash flashDriver;
 
 #if HAL_NUM_CAN_IFACES
@@ -0,0 +1,58 @@
+#include <AP_gbenchmark.h>
+#include <AP_HAL/AP_HAL.h>
+
+#if HAL_WITH_DSP
+
+#include <AP_HAL_Linux/DSP.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  cost of one FFT frame of state.range(0) samples, as run by
+  AP_GyroFFT for each axis. Two tones in noise at a 1kHz sample rate,
+  with half the window advanced each frame
+ */
+static void BM_FFTFrame(benchmark::State& state)
+{
+    const uint16_t window_size = state.range(0);
+    const uint16_t advance = window_size / 2;
+    const uint16_t sample_rate = 1000;
+
+    Linux::DSP dsp;
+    AP_HAL::DSP::FFTWindowState *fft = dsp.fft_init(window_size, sample_rate, 1);
+    if (fft == nullptr) {
+        state.SkipWithError("fft_init failed");
+        return;
+    }
+
+    const uint16_t num_samples = window_size + advance;
+    FloatBuffer samples(num_samples);
+    float tone[num_samples];
+    for (uint16_t i = 0; i < num_samples; i++) {
+        const float t = float(i) / sample_rate;
+        tone[i] = sinf(2 * M_PI * 180 * t) + 0.3f * sinf(2 * M_PI * 360 * t) + 0.1f * (rand() / float(RAND_MAX) - 0.5f);
+    }
+    samples.push(tone, window_size);
+
+    const uint16_t start_bin = 20 / fft->_bin_resolution;
+    const uint16_t end_bin = fft->_bin_count - 1;
+
+    while (state.KeepRunning()) {
+        dsp.fft_start(fft, samples, advance);
+        uint16_t bin = dsp.fft_analyse(fft, start_bin, end_bin, 0.5f);
+        gbenchmark_escape(&bin);
+
+        state.PauseTiming();
+        samples.push(&tone[window_size], advance);
+        state.ResumeTiming();
+    }
+
+    delete fft;
+}
+
+BENCHMARK(BM_FFTFrame)->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
+
+#endif // HAL_WITH_DSP
+
+BENCHMARK_MAIN();
@@ -70,6 +70,7 @@ void SITL_State::_sitl_setup(const char *home_str)
 #ifndef HIL_MODE
     _setup_fdm();
 #endif
+    _swarm_setup();
     fprintf(stdout, "Starting SITL input\n");
 
     // find the barometer object if it exists
@@ -112,6 +113,31 @@ void SITL_State::_sitl_setup(const char *home_str)
 }
 
 
+static Swarm *exit_swarm;
+
+static void swarm_leave(void)
+{
+    exit_swarm->leave();
+}
+
+/*
+  join a lock-step swarm if one was given on the command line
+ */
+void SITL_State::_swarm_setup(void)
+{
+    if (_swarm_name == nullptr) {
+        return;
+    }
+    _swarm = new Swarm();
+    if (!_swarm->init(_swarm_name, _swarm_count, _instance)) {
+        fprintf(stderr, "Failed to join swarm %s\n", _swarm_name);
+        exit(1);
+    }
+    // let the rest of the swarm carry on without us when we exit
+    exit_swarm = _swarm;
+    atexit(swarm_leave);
+}
+
 #ifndef HIL_MODE
 /*
   setup a SITL FDM listening UDP port
@@ -151,6 +177,15 @@ void SITL_State::_fdm_input_step(void)
 
     _fdm_input_local();
 
+    pthread_mutex_lock(&_clock_mutex);
+    pthread_cond_broadcast(&_clock_cond);
+    pthread_mutex_unlock(&_clock_mutex);
+
+    if (_swarm != nullptr) {
+        // don't get ahead of any other vehicle in the swarm
+        _swarm->step(AP_HAL::micros64());
+    }
+
     /* make sure we die if our parent dies */
     if (kill(_parent_pid, 0) != 0) {
         exit(1);
@@ -206,14 +241,28 @@ void SITL_State::wait_clock(uint64_t wait_time_usec)
             Scheduler::from(hal.scheduler)->semaphore_wait_hack_required()) {
             _fdm_input_step();
         } else {
-            usleep(1000);
+            // wait for the main thread to advance the clock. The
+            // timeout covers the main thread being blocked itself
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += 1000000;
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+            }
+            pthread_mutex_lock(&_clock_mutex);
+            if (AP_HAL::micros64() < wait_time_usec) {
+                pthread_cond_timedwait(&_clock_cond, &_clock_mutex, &ts);
+            }
+            pthread_mutex_unlock(&_clock_mutex);
         }
     }
     // check the outbound TCP queue size.  If it is too long then
     // MAVProxy/pymavlink take too long to process packets and it ends
     // up seeing traffic well into our past and hits time-out
     // conditions.
-    if (sitl_model->get_speedup() > 1) {
+    const float speedup = sitl_model->get_speedup();
+    if (speedup > 1 || speedup <= 0) {
         while (true) {
             const int queue_length = ((HALSITL::UARTDriver*)hal.uartA)->get_system_outqueue_length();
             // ::fprintf(stderr, "queue_length=%d\n", (signed)queue_length);
@@ -8,8 +8,10 @@
 #include "AP_HAL_SITL_Namespace.h"
 #include "HAL_SITL_Class.h"
 #include "RCInput.h"
+#include "Swarm.h"
 
 #include <sys/types.h>
+#include <pthread.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netinet/udp.h>
@@ -76,6 +78,11 @@ public:
         return _base_port;
     }
 
+    // lock-step swarm this vehicle is part of, if any
+    Swarm *get_swarm(void) const {
+        return _swarm;
+    }
+
     // create a file descriptor attached to a virtual device; type of
     // device is given by name parameter
     int sim_fd(const char *name, const char *arg);
@@ -175,6 +182,11 @@ private:
 
     void wait_clock(uint64_t wait_time_usec);
 
+    // signalled each time the main thread advances the simulation
+    // clock, so other threads in wait_clock() don't poll
+    pthread_mutex_t _clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t _clock_cond = PTHREAD_COND_INITIALIZER;
+
     // internal state
     enum vehicle_type _vehicle;
     uint16_t _framerate;
@@ -197,6 +209,12 @@ private:
 
     bool _synthetic_clock_mode;
 
+    // --swarm NAME:COUNT option
+    const char *_swarm_name;
+    uint8_t _swarm_count;
+    Swarm *_swarm;
+    void _swarm_setup(void);
+
     bool _use_rtscts;
     bool _use_fg_view;
     
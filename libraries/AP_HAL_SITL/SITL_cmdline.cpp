@@ -67,7 +67,7 @@ void SITL_State::_usage(void)
            "\t--help|-h                display this help information\n"
            "\t--wipe|-w                wipe eeprom\n"
            "\t--unhide-groups|-u       parameter enumeration ignores AP_PARAM_FLAG_ENABLE\n"
-           "\t--speedup|-s SPEEDUP     set simulation speedup\n"
+           "\t--speedup|-s SPEEDUP     set simulation speedup, 0 runs as fast as possible\n"
            "\t--rate|-r RATE           set SITL framerate\n"
            "\t--console|-C             use console instead of TCP ports\n"
            "\t--instance|-I N          set instance of SITL (adds 10*instance to all port numbers)\n"
@@ -96,7 +96,8 @@ void SITL_State::_usage(void)
            "\t--sim-port-in PORT       set port num for simulator in\n"
            "\t--sim-port-out PORT      set port num for simulator out\n"
            "\t--irlock-port PORT       set port num for irlock\n"
-           "\t--start-time TIMESTR     set simulation start time in UNIX timestamp"
+           "\t--start-time TIMESTR     set simulation start time in UNIX timestamp\n"
+           "\t--swarm NAME:COUNT       run in lock-step with the other COUNT vehicles of swarm NAME\n"
         );
 }
 
@@ -228,6 +229,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_SIM_PORT_OUT,
         CMDLINE_IRLOCK_PORT,
         CMDLINE_START_TIME,
+        CMDLINE_SWARM,
     };
 
     const struct GetOptLong::option options[] = {
@@ -264,6 +266,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"sim-port-out",    true,   0, CMDLINE_SIM_PORT_OUT},
         {"irlock-port",     true,   0, CMDLINE_IRLOCK_PORT},
         {"start-time",      true,   0, CMDLINE_START_TIME},
+        {"swarm",           true,   0, CMDLINE_SWARM},
         {0, false, 0, 0}
     };
 
@@ -385,6 +388,16 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_START_TIME:
             start_time_UTC = atoi(gopt.optarg);
             break;
+        case CMDLINE_SWARM: {
+            const char *colon = strchr(gopt.optarg, ':');
+            if (colon == nullptr) {
+                printf("Swarm must be given as NAME:COUNT\n");
+                exit(1);
+            }
+            _swarm_name = strndup(gopt.optarg, colon - gopt.optarg);
+            _swarm_count = atoi(colon+1);
+            break;
+        }
         default:
             _usage();
             exit(1);
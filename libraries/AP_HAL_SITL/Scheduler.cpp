@@ -231,14 +231,20 @@ void Scheduler::_run_io_procs()
 
     _in_io_proc = false;
 
-    hal.uartA->_timer_tick();
-    hal.uartB->_timer_tick();
-    hal.uartC->_timer_tick();
-    hal.uartD->_timer_tick();
-    hal.uartE->_timer_tick();
-    hal.uartF->_timer_tick();
-    hal.uartG->_timer_tick();
-    hal.uartH->_timer_tick();
+    UARTDriver *const uarts[] {
+        (UARTDriver *)hal.uartA,
+        (UARTDriver *)hal.uartB,
+        (UARTDriver *)hal.uartC,
+        (UARTDriver *)hal.uartD,
+        (UARTDriver *)hal.uartE,
+        (UARTDriver *)hal.uartF,
+        (UARTDriver *)hal.uartG,
+        (UARTDriver *)hal.uartH,
+    };
+    UARTDriver::check_readable(uarts, ARRAY_SIZE(uarts));
+    for (auto *uart : uarts) {
+        uart->_timer_tick();
+    }
     hal.storage->_timer_tick();
 
     // in lieu of a thread-per-bus:
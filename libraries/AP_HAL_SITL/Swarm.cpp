@@ -0,0 +1,270 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  lock-step clock and in-memory MAVLink bus for a swarm of SITL vehicles
+ */
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include "Swarm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace HALSITL;
+
+// wall clock milliseconds, the simulation clock is stopped while we wait
+static uint32_t wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000U + ts.tv_nsec/1000000U;
+}
+
+bool Swarm::init(const char *name, uint8_t count, uint8_t instance)
+{
+    if (count == 0 || count > SITL_SWARM_MAX_VEHICLES) {
+        ::fprintf(stderr, "Swarm: count must be 1 to %u\n", SITL_SWARM_MAX_VEHICLES);
+        return false;
+    }
+    if (instance >= count) {
+        ::fprintf(stderr, "Swarm: instance %u is outside swarm of %u\n", instance, count);
+        return false;
+    }
+    _instance = instance;
+    _count = count;
+
+    snprintf(shm_name, sizeof(shm_name), "/ap_swarm_%s", name);
+    const int fd = shm_open(shm_name, O_RDWR|O_CREAT|O_CLOEXEC, 0600);
+    if (fd == -1) {
+        ::fprintf(stderr, "Swarm: shm_open(%s) failed: %s\n", shm_name, strerror(errno));
+        return false;
+    }
+    // a new segment is zero filled, which is a valid empty swarm
+    if (ftruncate(fd, sizeof(shared_state)) != 0) {
+        ::fprintf(stderr, "Swarm: ftruncate failed: %s\n", strerror(errno));
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(shared_state), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        ::fprintf(stderr, "Swarm: mmap failed: %s\n", strerror(errno));
+        return false;
+    }
+    shm = (shared_state *)p;
+
+    uint32_t magic = 0;
+    if (!shm->magic.compare_exchange_strong(magic, shm_magic) && magic != shm_magic) {
+        ::fprintf(stderr, "Swarm: %s is not a swarm segment\n", shm_name);
+        return false;
+    }
+    uint32_t shm_count = 0;
+    if (!shm->count.compare_exchange_strong(shm_count, count) && shm_count != count) {
+        ::fprintf(stderr, "Swarm: %s has %u vehicles, not %u\n", shm_name, (unsigned)shm_count, count);
+        return false;
+    }
+
+    auto &v = shm->vehicle[_instance];
+    const int32_t old_pid = v.pid.load();
+    if (old_pid > 0 && old_pid != getpid() && kill(old_pid, 0) == 0) {
+        ::fprintf(stderr, "Swarm: instance %u is already running as pid %d\n", _instance, (int)old_pid);
+        return false;
+    }
+    v.time_us.store(0);
+    v.pid.store(getpid());
+
+    // only see packets sent from now on
+    bus_read = shm->bus_head.load();
+
+    ::printf("Swarm: joined %s as vehicle %u of %u\n", name, _instance, count);
+    return true;
+}
+
+/*
+  return true if a vehicle still in the swarm has not reached time_us
+ */
+bool Swarm::vehicle_behind(uint64_t time_us, int8_t &waiting_for) const
+{
+    for (uint8_t i=0; i<_count; i++) {
+        if (i == _instance) {
+            continue;
+        }
+        const int32_t pid = shm->vehicle[i].pid.load();
+        if (pid == pid_left) {
+            continue;
+        }
+        // a vehicle which hasn't joined yet holds the swarm at the start
+        if (pid == 0 || shm->vehicle[i].time_us.load() < time_us) {
+            waiting_for = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+  remove vehicles whose process has died without leaving
+ */
+void Swarm::check_vehicles()
+{
+    for (uint8_t i=0; i<_count; i++) {
+        int32_t pid = shm->vehicle[i].pid.load();
+        if (pid > 0 && kill(pid, 0) == -1 && errno == ESRCH) {
+            if (shm->vehicle[i].pid.compare_exchange_strong(pid, pid_left)) {
+                ::printf("Swarm: vehicle %u (pid %d) has died\n", i, (int)pid);
+                wake_waiters();
+            }
+        }
+    }
+}
+
+void Swarm::wake_waiters()
+{
+    shm->generation.fetch_add(1);
+#if defined(__linux__)
+    if (shm->waiters.load() != 0) {
+        syscall(SYS_futex, (uint32_t *)&shm->generation, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+#endif
+}
+
+void Swarm::wait_generation(uint32_t gen)
+{
+#if defined(__linux__)
+    // time out so dead vehicles are noticed
+    const struct timespec timeout { 0, 10*1000*1000 };
+    shm->waiters.fetch_add(1);
+    syscall(SYS_futex, (uint32_t *)&shm->generation, FUTEX_WAIT, gen, &timeout, nullptr, 0);
+    shm->waiters.fetch_sub(1);
+#else
+    if (shm->generation.load() == gen) {
+        usleep(100);
+    }
+#endif
+}
+
+void Swarm::step(uint64_t time_us)
+{
+    shm->vehicle[_instance].time_us.store(time_us);
+    wake_waiters();
+
+    while (true) {
+        const uint32_t gen = shm->generation.load();
+        int8_t waiting_for = -1;
+        if (!vehicle_behind(time_us, waiting_for)) {
+            break;
+        }
+        const uint32_t now_ms = wall_ms();
+        if (now_ms - last_check_ms > 1000) {
+            last_check_ms = now_ms;
+            check_vehicles();
+        }
+        if (now_ms - last_report_ms > 5000) {
+            last_report_ms = now_ms;
+            ::printf("Swarm: waiting for vehicle %d\n", waiting_for);
+        }
+        wait_generation(gen);
+    }
+}
+
+void Swarm::leave()
+{
+    if (shm == nullptr) {
+        return;
+    }
+    shm->vehicle[_instance].pid.store(pid_left);
+    wake_waiters();
+
+    // the last vehicle out removes the segment
+    for (uint8_t i=0; i<_count; i++) {
+        if (shm->vehicle[i].pid.load() != pid_left) {
+            return;
+        }
+    }
+    shm_unlink(shm_name);
+}
+
+bool Swarm::send(const uint8_t *buf, uint16_t len)
+{
+    if (len > SITL_SWARM_MAX_PACKET) {
+        return false;
+    }
+    const uint64_t seq = shm->bus_head.fetch_add(1);
+    auto &slot = shm->bus[seq % SITL_SWARM_BUS_SLOTS];
+    slot.seq.store(seq*2+1);
+    slot.len = len;
+    slot.src = _instance;
+    memcpy(slot.data, buf, len);
+    slot.seq.store(seq*2+2);
+    return true;
+}
+
+uint16_t Swarm::receive(uint8_t *buf, uint16_t space)
+{
+    const uint64_t head = shm->bus_head.load();
+    if (head - bus_read > SITL_SWARM_BUS_SLOTS/2) {
+        // we have fallen too far behind, skip the oldest messages
+        bus_dropped += (head - bus_read) - SITL_SWARM_BUS_SLOTS/2;
+        bus_read = head - SITL_SWARM_BUS_SLOTS/2;
+    }
+
+    uint16_t n = 0;
+    while (bus_read < head) {
+        auto &slot = shm->bus[bus_read % SITL_SWARM_BUS_SLOTS];
+        const uint64_t seq = slot.seq.load();
+        if (seq < bus_read*2+2) {
+            if (head - bus_read < SITL_SWARM_BUS_SLOTS/4) {
+                // still being written
+                break;
+            }
+            // the writer must have died part way through
+            bus_dropped++;
+            bus_read++;
+            continue;
+        }
+        if (seq == bus_read*2+2 && slot.src != _instance) {
+            const uint16_t len = slot.len;
+            if (len > space - n) {
+                break;
+            }
+            memcpy(&buf[n], slot.data, len);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load() != seq) {
+                // overwritten while we copied it
+                bus_dropped++;
+            } else {
+                n += len;
+            }
+        }
+        bus_read++;
+    }
+    return n;
+}
+
+#endif // CONFIG_HAL_BOARD
@@ -0,0 +1,112 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  lock-step clock and in-memory MAVLink bus for a swarm of SITL
+  vehicles on one machine
+
+  All vehicles started with the same --swarm NAME:COUNT option attach
+  to a shared memory segment. After each physics step a vehicle
+  publishes its simulation time and then waits until no other vehicle
+  is behind it, so the swarm advances together without any vehicle
+  sleeping on a socket. Waiting vehicles block on a futex rather than
+  polling.
+
+  A "swarm:" serial device connects a vehicle to a broadcast bus in
+  the same segment. Each write is one or more whole MAVLink packets
+  and is seen by every other vehicle on the bus.
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include "AP_HAL_SITL_Namespace.h"
+#include <atomic>
+
+#define SITL_SWARM_MAX_VEHICLES 64
+#define SITL_SWARM_BUS_SLOTS 4096
+#define SITL_SWARM_MAX_PACKET 300
+
+class HALSITL::Swarm {
+public:
+    // attach to the shared state for a swarm, creating it if needed
+    bool init(const char *name, uint8_t count, uint8_t instance);
+
+    // publish our simulation time and wait until no other vehicle in
+    // the swarm is behind it
+    void step(uint64_t time_us);
+
+    // mark this vehicle as having left the swarm
+    void leave();
+
+    // send a buffer of whole MAVLink packets to the other vehicles
+    bool send(const uint8_t *buf, uint16_t len);
+
+    // receive packets from the other vehicles, returning the number
+    // of bytes placed in buf. Only whole bus messages are returned
+    uint16_t receive(uint8_t *buf, uint16_t space);
+
+private:
+    static constexpr uint32_t shm_magic = 0x53574d31;  // "SWM1"
+
+    // pid of a vehicle which has left the swarm
+    static constexpr int32_t pid_left = -1;
+
+    struct shared_state {
+        std::atomic<uint32_t> magic;
+        std::atomic<uint32_t> count;
+
+        // incremented each time a vehicle publishes its time, waiters
+        // block on this with a futex
+        std::atomic<uint32_t> generation;
+        std::atomic<uint32_t> waiters;
+
+        struct {
+            std::atomic<uint64_t> time_us;
+            std::atomic<int32_t> pid;
+        } vehicle[SITL_SWARM_MAX_VEHICLES];
+
+        // broadcast bus. Writers claim a sequence number from head and
+        // mark the slot busy (odd) then complete (even) so readers can
+        // detect a slot being overwritten while they copy it
+        std::atomic<uint64_t> bus_head;
+        struct {
+            std::atomic<uint64_t> seq;
+            uint16_t len;
+            uint8_t src;
+            uint8_t data[SITL_SWARM_MAX_PACKET];
+        } bus[SITL_SWARM_BUS_SLOTS];
+    };
+
+    shared_state *shm;
+    char shm_name[40];
+    uint8_t _instance;
+    uint8_t _count;
+
+    // next bus sequence number to read
+    uint64_t bus_read;
+    uint32_t bus_dropped;
+
+    uint32_t last_check_ms;
+    uint32_t last_report_ms;
+
+    bool vehicle_behind(uint64_t time_us, int8_t &waiting_for) const;
+    void check_vehicles();
+    void wait_generation(uint32_t gen);
+    void wake_waiters();
+};
+
+#endif // CONFIG_HAL_BOARD
@@ -34,6 +34,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <sys/select.h>
+#include <poll.h>
 #include <termios.h>
 #include <sys/time.h>
 
@@ -81,6 +82,7 @@ void UARTDriver::begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace)
              mcast:239.255.145.50:14550
              uart:/dev/ttyUSB0:57600
              sim:ParticleSensor_SDS021:
+             swarm:           // in-memory bus shared by a --swarm
          */
         char *saveptr = nullptr;
         char *s = strdup(path);
@@ -118,6 +120,15 @@ void UARTDriver::begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace)
                 ::printf("UDP connection %s:%u\n", ip, port);
                 _udp_start_client(ip, port);
             }
+        } else if (strcmp(devtype, "swarm") == 0) {
+            if (_sitlState->get_swarm() == nullptr) {
+                AP_HAL::panic("swarm: device needs the --swarm option");
+            }
+            if (!_connected) {
+                ::printf("Swarm connection on port %u\n", _portNumber);
+                _connected = true;
+                _swarm_link = true;
+            }
         } else if (strcmp(devtype, "mcast") == 0) {
             // udp multicast connection
             const char *ip = args1 && *args1?args1:mcast_ip_default;
@@ -601,6 +612,27 @@ bool UARTDriver::_select_check(int fd)
     return false;
 }
 
+/*
+  use one poll() to see which ports have input pending. This replaces
+  a select() per port on every tick, which dominates the cost of the
+  serial ports when the simulation runs much faster than real time
+ */
+void UARTDriver::check_readable(UARTDriver *const ports[], uint8_t num_ports)
+{
+    struct pollfd fds[num_ports];
+    for (uint8_t i=0; i<num_ports; i++) {
+        const UARTDriver *p = ports[i];
+        // poll() ignores negative file descriptors
+        fds[i].fd = !p->_connected ? -1 : p->_mc_fd >= 0 ? p->_mc_fd : p->_fd;
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+    const bool any = poll(fds, num_ports, 0) > 0;
+    for (uint8_t i=0; i<num_ports; i++) {
+        ports[i]->_readable = any && (fds[i].revents & (POLLIN|POLLHUP|POLLERR)) != 0;
+    }
+}
+
 void UARTDriver::_set_nonblocking(int fd)
 {
     unsigned v = fcntl(fd, F_GETFL, 0);
@@ -652,6 +684,11 @@ void UARTDriver::_timer_tick(void)
         last_tick_us = now;
     }
 
+    if (_swarm_link) {
+        _swarm_tick(max_bytes);
+        return;
+    }
+
     if (_packetise) {
         uint16_t n = _writebuffer.available();
         n = MIN(n, max_bytes);
@@ -705,7 +742,7 @@ void UARTDriver::_timer_tick(void)
     char buf[space];
     ssize_t nread = 0;
     if (_mc_fd >= 0) {
-        if (_select_check(_mc_fd)) {
+        if (_readable) {
             struct sockaddr_in from;
             socklen_t fromlen = sizeof(from);
             nread = recvfrom(_mc_fd, buf, space, MSG_DONTWAIT, (struct sockaddr *)&from, &fromlen);
@@ -728,7 +765,7 @@ void UARTDriver::_timer_tick(void)
             }
         }
     } else if (!_use_send_recv) {
-        if (!_select_check(_fd)) {
+        if (!_readable) {
             return;
         }
         int fd = _console?0:_fd;
@@ -738,7 +775,7 @@ void UARTDriver::_timer_tick(void)
             _fd = -1;
             _connected = false;
         }
-    } else if (_select_check(_fd)) {
+    } else if (_readable) {
         nread = recv(_fd, buf, space, MSG_DONTWAIT);
         if (nread <= 0 && !_is_udp) {
             // the socket has reached EOF
@@ -756,6 +793,38 @@ void UARTDriver::_timer_tick(void)
     }
 }
 
+/*
+  exchange whole MAVLink packets with the other vehicles of a swarm
+ */
+void UARTDriver::_swarm_tick(uint32_t max_bytes)
+{
+    Swarm *swarm = _sitlState->get_swarm();
+
+    uint16_t n = MIN(_writebuffer.available(), max_bytes);
+    while (n > 0) {
+        const uint16_t len = mavlink_packetise(_writebuffer, MIN(n, SITL_SWARM_MAX_PACKET));
+        if (len == 0) {
+            break;
+        }
+        uint8_t tmpbuf[len];
+        _writebuffer.peekbytes(tmpbuf, len);
+        swarm->send(tmpbuf, len);
+        _writebuffer.advance(len);
+        n -= len;
+    }
+
+    const uint32_t space = MIN(_readbuffer.space(), max_bytes);
+    if (space < SITL_SWARM_MAX_PACKET) {
+        return;
+    }
+    uint8_t buf[space];
+    const uint16_t nread = swarm->receive(buf, space);
+    if (nread > 0) {
+        _readbuffer.write(buf, nread);
+        _receive_timestamp = AP_HAL::micros64();
+    }
+}
+
 /*
   return timestamp estimate in microseconds for when the start of
   a nbytes packet arrived on the uart. This should be treated as a
@@ -71,6 +71,10 @@ public:
 
     void _timer_tick(void) override;
 
+    // find which ports have input pending with a single poll() call,
+    // called before the ports are ticked
+    static void check_readable(UARTDriver *const ports[], uint8_t num_ports);
+
     /*
       return timestamp estimate in microseconds for when the start of
       a nbytes packet arrived on the uart. This should be treated as a
@@ -115,6 +119,7 @@ private:
     void _udp_start_client(const char *address, uint16_t port);
     void _udp_start_multicast(const char *address, uint16_t port);
     void _check_connection(void);
+    void _swarm_tick(uint32_t max_bytes);
     static bool _select_check(int );
     static void _set_nonblocking(int );
     bool set_speed(int speed);
@@ -123,6 +128,8 @@ private:
     uint64_t _receive_timestamp;
     bool _is_udp;
     bool _packetise;
+    bool _swarm_link;
+    bool _readable; // set by check_readable()
     uint16_t _mc_myport;
     uint32_t last_tick_us;
 
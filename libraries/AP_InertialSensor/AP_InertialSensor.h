@@ -13,7 +13,7 @@
  */
 #define INS_MAX_INSTANCES 3
 #define INS_MAX_BACKENDS  6
-#define INS_MAX_NOTCHES 4
+#define INS_MAX_NOTCHES 12 // enough for a notch set on each motor
 #define INS_VIBRATION_CHECK_INSTANCES 2
 #define XYZ_AXIS_COUNT    3
 // The maximum we need to store is gyro-rate / loop-rate, worst case ArduCopter with BMI088 is 2000/400
@@ -31,6 +31,7 @@
 #include <Filter/LowPassFilter.h>
 #include <Filter/NotchFilter.h>
 #include <Filter/HarmonicNotchFilter.h>
+#include <Filter/BiquadFilterBank.h>
 
 class AP_InertialSensor_Backend;
 class AuxiliaryBus;
@@ -41,6 +42,7 @@ class AP_AHRS;
   because of mutual dependencies
  */
 class AP_Logger;
+class AP_InertialSensor_BatchStream;
 
 /* AP_InertialSensor is an abstraction for gyro and accel measurements
  * which are correctly aligned to the body axes and scaled to SI units.
@@ -370,6 +372,10 @@ public:
         AP_Int16 samples_per_msg;
         AP_Int8 push_interval_ms;
 
+        // Parameters for continuous capture to files
+        AP_Int8 stream_num_files;
+        AP_Int16 stream_file_size_mb;
+
         // end Parameters
 
     private:
@@ -377,8 +383,13 @@ public:
         enum batch_opt_t {
             BATCH_OPT_SENSOR_RATE = (1<<0),
             BATCH_OPT_POST_FILTER = (1<<1),
+            BATCH_OPT_CONTINUOUS  = (1<<2),
         };
 
+        // continuous capture of every sample to files, nullptr if not in use
+        AP_InertialSensor_BatchStream *stream;
+        void sample_stream(uint8_t instance, IMU_SENSOR_TYPE type, uint64_t sample_us, const Vector3f &sample);
+
         void rotate_to_next_sensor();
         void update_doing_sensor_rate_logging();
 
@@ -476,6 +487,10 @@ private:
     float _calculated_harmonic_notch_freq_hz[INS_MAX_NOTCHES];
     uint8_t _num_calculated_harmonic_notch_frequencies;
 
+    // the gyro notch, harmonic notch and low pass filters applied as
+    // one bank, the filters above supply the coefficients
+    BiquadFilterBank _gyro_filter_bank[INS_MAX_INSTANCES];
+
     // Most recent gyro reading
     Vector3f _gyro[INS_MAX_INSTANCES];
     Vector3f _delta_angle[INS_MAX_INSTANCES];
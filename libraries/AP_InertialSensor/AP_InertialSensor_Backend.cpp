@@ -3,6 +3,7 @@
 #include "AP_InertialSensor_Backend.h"
 #include <AP_Logger/AP_Logger.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
+#include <AP_Trace/AP_Trace.h>
 #if AP_MODULE_SUPPORTED
 #include <AP_Module/AP_Module.h>
 #include <stdio.h>
@@ -151,6 +152,7 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
     }
+    AP_TRACE_SCOPE("INS_GyroSample");
     float dt;
 
     _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
@@ -234,26 +236,13 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
             _imu._gyro_window[instance][2].push(scaled_gyro.z);
         }
 #endif
-        Vector3f gyro_filtered = gyro;
-
-        // apply the notch filter
-        if (_gyro_notch_enabled()) {
-            gyro_filtered = _imu._gyro_notch_filter[instance].apply(gyro_filtered);
-        }
-
-        // apply the harmonic notch filter
-        if (gyro_harmonic_notch_enabled()) {
-            gyro_filtered = _imu._gyro_harmonic_notch_filter[instance].apply(gyro_filtered);
-        }
-
-        // apply the low pass filter last to attentuate any notch induced noise
-        gyro_filtered = _imu._gyro_filter[instance].apply(gyro_filtered);
+        // apply the notch, harmonic notch and low pass filters in turn,
+        // the low pass last to attentuate any notch induced noise
+        const Vector3f gyro_filtered = _imu._gyro_filter_bank[instance].apply(gyro);
 
         // if the filtering failed in any way then reset the filters and keep the old value
         if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
-            _imu._gyro_filter[instance].reset();
-            _imu._gyro_notch_filter[instance].reset();
-            _imu._gyro_harmonic_notch_filter[instance].reset();
+            _imu._gyro_filter_bank[instance].reset();
         } else {
             _imu._gyro_filtered[instance] = gyro_filtered;
         }
@@ -540,12 +529,12 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
         _last_harmonic_notch_center_freq_hz = gyro_harmonic_notch_center_freq_hz();
         _last_harmonic_notch_bandwidth_hz = gyro_harmonic_notch_bandwidth_hz();
         _last_harmonic_notch_attenuation_dB = gyro_harmonic_notch_attenuation_dB();
+    } else if (num_gyro_harmonic_notch_center_frequencies() > 1) {
+        // any of the motors may have changed speed so always update
+        _imu._gyro_harmonic_notch_filter[instance].update(num_gyro_harmonic_notch_center_frequencies(), gyro_harmonic_notch_center_frequencies_hz());
+        _last_harmonic_notch_center_freq_hz = gyro_harmonic_notch_center_freq_hz();
     } else if (!is_equal(_last_harmonic_notch_center_freq_hz, gyro_harmonic_notch_center_freq_hz())) {
-        if (num_gyro_harmonic_notch_center_frequencies() > 1) {
-            _imu._gyro_harmonic_notch_filter[instance].update(num_gyro_harmonic_notch_center_frequencies(), gyro_harmonic_notch_center_frequencies_hz());
-        } else {
-            _imu._gyro_harmonic_notch_filter[instance].update(gyro_harmonic_notch_center_freq_hz());
-        }
+        _imu._gyro_harmonic_notch_filter[instance].update(gyro_harmonic_notch_center_freq_hz());
         _last_harmonic_notch_center_freq_hz = gyro_harmonic_notch_center_freq_hz();
     }
     // possily update the notch filter parameters
@@ -558,6 +547,38 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
         _last_notch_bandwidth_hz = _gyro_notch_bandwidth_hz();
         _last_notch_attenuation_dB = _gyro_notch_attenuation_dB();
     }
+
+    update_gyro_filter_bank(instance);
+}
+
+/*
+  the gyro filter bank has the notch in the first stage, the harmonic
+  notch in the next HNF_MAX_FILTERS stages and the low pass last. A
+  disabled filter leaves its stages disabled
+ */
+void AP_InertialSensor_Backend::update_gyro_filter_bank(uint8_t instance)
+{
+    BiquadFilterBank &bank = _imu._gyro_filter_bank[instance];
+    const uint8_t harmonic_stage = 1;
+    const uint8_t low_pass_stage = harmonic_stage + HNF_MAX_FILTERS;
+
+    bank.set_num_stages(low_pass_stage + 1);
+
+    if (_gyro_notch_enabled()) {
+        bank.set_notch(0, _imu._gyro_notch_filter[instance]);
+    } else {
+        bank.disable(0);
+    }
+
+    if (gyro_harmonic_notch_enabled()) {
+        bank.set_harmonic_notch(harmonic_stage, HNF_MAX_FILTERS, _imu._gyro_harmonic_notch_filter[instance]);
+    } else {
+        for (uint8_t i = 0; i < HNF_MAX_FILTERS; i++) {
+            bank.disable(harmonic_stage + i);
+        }
+    }
+
+    bank.set_low_pass(low_pass_stage, _imu._gyro_filter[instance]);
 }
 
 /*
@@ -330,4 +330,7 @@ private:
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel);
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &gryo);
 
+    // copy the gyro filter coefficients into the filter bank
+    void update_gyro_filter_bank(uint8_t instance);
+
 };
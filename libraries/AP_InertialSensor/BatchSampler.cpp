@@ -1,4 +1,5 @@
 #include "AP_InertialSensor.h"
+#include "BatchStream.h"
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Logger/AP_Logger.h>
 
@@ -24,7 +25,7 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Param: BAT_OPT
     // @DisplayName: Batch Logging Options Mask
     // @Description: Options for the BatchSampler. Post-filter and sensor-rate logging cannot be used at the same time.
-    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP), 1: Sample post-filtering
+    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP), 1: Sample post-filtering, 2: Continuous capture of every sample to files (Linux only)
     // @User: Advanced
     AP_GROUPINFO("BAT_OPT",  3, AP_InertialSensor::BatchSampler, _batch_options_mask, 0),
 
@@ -41,6 +42,25 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Increment: 1
     AP_GROUPINFO("BAT_LGCT", 5, AP_InertialSensor::BatchSampler, samples_per_msg,   32),
 
+#if HAL_INS_BATCH_STREAM_ENABLED
+    // @Param: BAT_FILES
+    // @DisplayName: continuous capture file count
+    // @Description: Number of files kept in the ISB log directory when continuously capturing samples. The oldest file is removed when a new one is started. This option takes effect on the next reboot.
+    // @Range: 1 100
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("BAT_FILES", 6, AP_InertialSensor::BatchSampler, stream_num_files,   10),
+
+    // @Param: BAT_FSIZE
+    // @DisplayName: continuous capture file size
+    // @Description: Size at which a new file is started when continuously capturing samples. This option takes effect on the next reboot.
+    // @Units: MB
+    // @Range: 1 1024
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("BAT_FSIZE", 7, AP_InertialSensor::BatchSampler, stream_file_size_mb,   64),
+#endif
+
     AP_GROUPEND
 };
 
@@ -51,6 +71,23 @@ void AP_InertialSensor::BatchSampler::init()
     if (_sensor_mask == 0) {
         return;
     }
+
+#if HAL_INS_BATCH_STREAM_ENABLED
+    if ((batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_CONTINUOUS) {
+        // every sample goes to files instead of batches in the log
+        stream = new AP_InertialSensor_BatchStream();
+        if (stream != nullptr && !stream->init(stream_num_files, stream_file_size_mb)) {
+            delete stream;
+            stream = nullptr;
+        }
+        if (stream != nullptr) {
+            update_doing_sensor_rate_logging();
+            initialised = true;
+        }
+        return;
+    }
+#endif
+
     if (_required_count <= 0) {
         return;
     }
@@ -84,6 +121,10 @@ void AP_InertialSensor::BatchSampler::periodic()
     if (_sensor_mask == 0) {
         return;
     }
+    if (stream != nullptr) {
+        // samples are written out by the stream's own thread
+        return;
+    }
     push_data_to_log();
 }
 
@@ -96,7 +137,10 @@ void AP_InertialSensor::BatchSampler::update_doing_sensor_rate_logging()
         return;
     }
     _doing_post_filter_logging = false;
-    if (!((batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_SENSOR_RATE)) {
+    if (!((batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_SENSOR_RATE) ||
+        stream != nullptr) {
+        // continuous capture takes samples from every sensor, so
+        // can't follow the sensor rate setting of one of them
         _doing_sensor_rate_logging = false;
         return;
     }
@@ -273,6 +317,10 @@ bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_T
 
 void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSensor::IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &_sample)
 {
+    if (stream != nullptr) {
+        sample_stream(_instance, _type, sample_us, _sample);
+        return;
+    }
     if (!should_log(_instance, _type)) {
         return;
     }
@@ -286,3 +334,28 @@ void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSenso
 
     data_write_offset++; // may unblock the reading process
 }
+
+/*
+  pass a sample from any of the masked sensors on to the continuous capture stream
+ */
+void AP_InertialSensor::BatchSampler::sample_stream(uint8_t _instance, AP_InertialSensor::IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &_sample)
+{
+#if HAL_INS_BATCH_STREAM_ENABLED
+    if (_instance >= INS_MAX_INSTANCES || !(_sensor_mask & (1U<<_instance))) {
+        return;
+    }
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr || !logger->should_log(MASK_LOG_ANY)) {
+        return;
+    }
+    const uint16_t mult = (_type == IMU_SENSOR_TYPE_GYRO) ?
+        _imu._gyro_raw_sampling_multiplier[_instance] :
+        _imu._accel_raw_sampling_multiplier[_instance];
+    const int16_t xyz[3] {
+        int16_t(constrain_float(mult*_sample.x, INT16_MIN, INT16_MAX)),
+        int16_t(constrain_float(mult*_sample.y, INT16_MIN, INT16_MAX)),
+        int16_t(constrain_float(mult*_sample.z, INT16_MIN, INT16_MAX)),
+    };
+    stream->sample(_instance, _type, sample_us ? sample_us : AP_HAL::micros64(), xyz, mult);
+#endif
+}
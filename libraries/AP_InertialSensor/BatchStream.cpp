@@ -0,0 +1,272 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  continuous capture of raw IMU samples to a ring of files
+ */
+#include "BatchStream.h"
+
+#if HAL_INS_BATCH_STREAM_ENABLED
+
+#include <stdio.h>
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <GCS_MAVLink/GCS.h>
+#include <AP_Logger/AP_Logger.h>
+
+extern const AP_HAL::HAL& hal;
+
+#define ISB_DIRECTORY HAL_BOARD_LOG_DIRECTORY "/ISB"
+
+// number of samples which can be queued for the writer thread. At
+// 8kHz on three gyros and accels this is about 170ms of samples
+#define ISB_QUEUE_SIZE 8192
+
+bool AP_InertialSensor_BatchStream::init(uint8_t num_files, uint16_t file_size_mb)
+{
+    _num_files = MAX(num_files, 1);
+    _file_size = MAX(file_size_mb, 1) * 1024U * 1024U;
+
+    if (!_queue.set_size(ISB_QUEUE_SIZE)) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "INS: failed to allocate ISB stream");
+        return false;
+    }
+
+    // the directory may already exist
+    AP::FS().mkdir(ISB_DIRECTORY);
+    _file_num = find_last_file_num();
+
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_InertialSensor_BatchStream::writer_thread, void),
+                                      "ISB", 4096, AP_HAL::Scheduler::PRIORITY_IO, 1)) {
+        _queue.set_size(0);
+        gcs().send_text(MAV_SEVERITY_WARNING, "INS: failed to start ISB stream");
+        return false;
+    }
+    return true;
+}
+
+void AP_InertialSensor_BatchStream::sample(uint8_t instance, AP_InertialSensor::IMU_SENSOR_TYPE type, uint64_t sample_us,
+                                          const int16_t xyz[3], uint16_t multiplier)
+{
+    const queued_sample s {
+        sample_us  : sample_us,
+        xyz        : { xyz[0], xyz[1], xyz[2] },
+        multiplier : multiplier,
+        instance   : instance,
+        type       : uint8_t(type),
+    };
+    if (!_queue.push(s)) {
+        _dropped++;
+    }
+}
+
+void AP_InertialSensor_BatchStream::writer_thread()
+{
+    uint32_t last_flush_ms = AP_HAL::millis();
+    uint32_t last_log_ms = last_flush_ms;
+    while (true) {
+        queued_sample s;
+        bool got_sample = false;
+        while (_queue.pop(s)) {
+            add_sample(s);
+            got_sample = true;
+        }
+        const uint32_t now_ms = AP_HAL::millis();
+        if (_write_len > 0 && now_ms - last_flush_ms > 1000) {
+            // don't hold data back for long at low sample rates
+            flush_write_buf();
+            last_flush_ms = now_ms;
+        }
+        if (now_ms - last_log_ms >= 1000) {
+            log_status();
+            last_log_ms = now_ms;
+        }
+        if (!got_sample) {
+            hal.scheduler->delay(5);
+        }
+    }
+}
+
+/*
+  log the state of the capture so dropped samples show up in the log
+ */
+void AP_InertialSensor_BatchStream::log_status()
+{
+// @LoggerMessage: ISBS
+// @Description: IMU continuous capture status
+// @Field: TimeUS: Time since system startup
+// @Field: Drop: number of samples dropped as the queue to the writer thread was full
+// @Field: File: number of the file being written
+// @Field: Size: bytes written to the file
+    AP::logger().Write("ISBS", "TimeUS,Drop,File,Size", "QIII",
+                       AP_HAL::micros64(),
+                       _dropped.load(),
+                       _file_num,
+                       _file_bytes);
+}
+
+/*
+  add a sample to the block for its sensor, writing the block out when
+  it is full
+ */
+void AP_InertialSensor_BatchStream::add_sample(const queued_sample &s)
+{
+    if (s.instance >= INS_MAX_INSTANCES || s.type > 1) {
+        return;
+    }
+    block &b = _blocks[s.instance][s.type];
+
+    if (b.hdr.count > 0 && b.hdr.multiplier != s.multiplier) {
+        // scaling changed, the deltas would be meaningless
+        finish_block(b);
+    }
+
+    if (b.hdr.count == 0) {
+        b.hdr.instance = s.instance;
+        b.hdr.type = s.type;
+        b.hdr.multiplier = s.multiplier;
+        b.hdr.first_us = s.sample_us;
+        memcpy(b.data, s.xyz, sizeof(s.xyz));
+        b.hdr.data_len = sizeof(s.xyz);
+    } else {
+        for (uint8_t i=0; i<3; i++) {
+            b.hdr.data_len += encode_delta(int32_t(s.xyz[i]) - b.last[i], &b.data[b.hdr.data_len]);
+        }
+    }
+    memcpy(b.last, s.xyz, sizeof(s.xyz));
+    b.hdr.last_us = s.sample_us;
+    b.hdr.count++;
+
+    if (b.hdr.count == block_samples) {
+        finish_block(b);
+    }
+}
+
+void AP_InertialSensor_BatchStream::finish_block(block &b)
+{
+    if (b.hdr.count == 0) {
+        return;
+    }
+    b.hdr.magic = block_magic;
+    write(&b.hdr, sizeof(b.hdr));
+    write(b.data, b.hdr.data_len);
+    b.hdr.count = 0;
+}
+
+/*
+  buffer data for writing, starting a new file when the current one is full
+ */
+void AP_InertialSensor_BatchStream::write(const void *data, uint16_t len)
+{
+    if (len > sizeof(_write_buf) - _write_len) {
+        flush_write_buf();
+    }
+    memcpy(&_write_buf[_write_len], data, len);
+    _write_len += len;
+    if (_write_len > sizeof(_write_buf) / 2) {
+        flush_write_buf();
+    }
+}
+
+void AP_InertialSensor_BatchStream::flush_write_buf()
+{
+    if (_write_len == 0) {
+        return;
+    }
+    // the buffer only holds whole blocks, so every file can be
+    // decoded on its own
+    if (_fd == -1 || _file_bytes + _write_len > _file_size) {
+        if (!open_next_file()) {
+            // can't write, drop the data and try again with the next buffer
+            _write_len = 0;
+            return;
+        }
+    }
+    const ssize_t n = AP::FS().write(_fd, _write_buf, _write_len);
+    if (n != _write_len) {
+        // storage full or removed, start a new file next time
+        AP::FS().close(_fd);
+        _fd = -1;
+    } else {
+        _file_bytes += n;
+    }
+    _write_len = 0;
+}
+
+/*
+  close the current file and start the next one in the ring, removing
+  the oldest file
+ */
+bool AP_InertialSensor_BatchStream::open_next_file()
+{
+    if (_fd != -1) {
+        AP::FS().close(_fd);
+        _fd = -1;
+    }
+    _file_num++;
+
+    char name[64];
+    if (_file_num > _num_files) {
+        file_name(_file_num - _num_files, name, sizeof(name));
+        AP::FS().unlink(name);
+    }
+
+    file_name(_file_num, name, sizeof(name));
+    _fd = AP::FS().open(name, O_WRONLY|O_CREAT|O_TRUNC);
+    if (_fd == -1) {
+        return false;
+    }
+    _file_bytes = 0;
+
+    const file_header hdr {
+        magic    : file_magic,
+        version  : file_version,
+        reserved : 0,
+    };
+    if (AP::FS().write(_fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        AP::FS().close(_fd);
+        _fd = -1;
+        return false;
+    }
+    _file_bytes += sizeof(hdr);
+
+    return true;
+}
+
+/*
+  find the highest numbered file in the ring so we carry on after it
+ */
+uint32_t AP_InertialSensor_BatchStream::find_last_file_num()
+{
+    uint32_t last = 0;
+    auto *d = AP::FS().opendir(ISB_DIRECTORY);
+    if (d == nullptr) {
+        return 0;
+    }
+    struct dirent *de;
+    while ((de = AP::FS().readdir(d)) != nullptr) {
+        uint32_t num;
+        if (sscanf(de->d_name, "%05u.ISB", (unsigned *)&num) == 1) {
+            last = MAX(last, num);
+        }
+    }
+    AP::FS().closedir(d);
+    return last;
+}
+
+void AP_InertialSensor_BatchStream::file_name(uint32_t num, char *name, uint8_t len) const
+{
+    hal.util->snprintf(name, len, ISB_DIRECTORY "/%05u.ISB", (unsigned)num);
+}
+
+#endif // HAL_INS_BATCH_STREAM_ENABLED
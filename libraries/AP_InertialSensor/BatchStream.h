@@ -0,0 +1,167 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  continuous capture of raw IMU samples to a ring of files
+
+  Samples are queued by the sensor threads and delta encoded by a
+  writer thread into blocks which are written to
+  HAL_BOARD_LOG_DIRECTORY/ISB/NNNNN.ISB. When a file reaches its
+  maximum size the next file is started and the oldest file beyond the
+  configured number of files is removed.
+
+  file format:
+    file header:
+      uint32_t magic = 0x53425349 ("ISBS")
+      uint16_t version = 1
+      uint16_t reserved
+
+    per block:
+      uint16_t magic = 0x4b42 ("BK")
+      uint8_t  instance
+      uint8_t  type           // 0 accel, 1 gyro
+      uint8_t  count          // number of samples
+      uint16_t multiplier     // samples are scaled by this before encoding
+      uint64_t first_us       // time of the first sample
+      uint64_t last_us        // time of the last sample
+      uint16_t data_len       // bytes of encoded data which follow
+      int16_t  first[3]       // first sample, x, y, z
+      then for each following sample the difference from the previous
+      sample for x, y and z, each as a zigzag encoded LEB128 varint
+
+  Tools/scripts/isb_decode.py converts these files to CSV.
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+
+#ifndef HAL_INS_BATCH_STREAM_ENABLED
+#define HAL_INS_BATCH_STREAM_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
+
+#if HAL_INS_BATCH_STREAM_ENABLED
+
+#include <atomic>
+#include <cstddef>
+#include <AP_HAL/utility/RingBuffer.h>
+#include "AP_InertialSensor.h"
+
+class AP_InertialSensor_BatchStream {
+public:
+    // allocate the sample queue and start the writer thread
+    bool init(uint8_t num_files, uint16_t file_size_mb);
+
+    // queue a sample, called from the sensor threads
+    void sample(uint8_t instance, AP_InertialSensor::IMU_SENSOR_TYPE type, uint64_t sample_us,
+                const int16_t xyz[3], uint16_t multiplier);
+
+    // number of samples dropped as the queue was full
+    uint32_t dropped() const { return _dropped; }
+
+    // append the difference between two samples to buf as a zigzag
+    // encoded LEB128 varint, returning the number of bytes used
+    static uint8_t encode_delta(int32_t delta, uint8_t *buf) {
+        uint32_t v = (uint32_t(delta) << 1) ^ uint32_t(delta >> 31);
+        uint8_t n = 0;
+        while (v >= 0x80) {
+            buf[n++] = uint8_t(v) | 0x80;
+            v >>= 7;
+        }
+        buf[n++] = uint8_t(v);
+        return n;
+    }
+
+    // decode a difference written by encode_delta from the len bytes at
+    // buf, returning the number of bytes used or 0 if it is truncated
+    static uint8_t decode_delta(const uint8_t *buf, uint16_t len, int32_t &delta) {
+        uint32_t v = 0;
+        for (uint8_t n=0; n<5 && n<len; n++) {
+            v |= uint32_t(buf[n] & 0x7f) << (7*n);
+            if ((buf[n] & 0x80) == 0) {
+                delta = int32_t(v >> 1) ^ -int32_t(v & 1);
+                return n+1;
+            }
+        }
+        return 0;
+    }
+
+private:
+    static constexpr uint32_t file_magic = 0x53425349;
+    static constexpr uint16_t file_version = 1;
+    static constexpr uint16_t block_magic = 0x4b42;
+    static constexpr uint8_t block_samples = 32;
+
+    // largest encoded size of a block, each varint is at most 3 bytes
+    static constexpr uint16_t max_block_data = 3*sizeof(int16_t) + (block_samples-1)*3*3;
+
+    struct queued_sample {
+        uint64_t sample_us;
+        int16_t xyz[3];
+        uint16_t multiplier;
+        uint8_t instance;
+        uint8_t type;
+    };
+    ObjectBuffer_LF<queued_sample> _queue;
+    std::atomic<uint32_t> _dropped;
+
+    struct PACKED file_header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+    };
+
+    struct PACKED block_header {
+        uint16_t magic;
+        uint8_t instance;
+        uint8_t type;
+        uint8_t count;
+        uint16_t multiplier;
+        uint64_t first_us;
+        uint64_t last_us;
+        uint16_t data_len;
+    };
+
+    // a block being filled for one sensor, only used by the writer thread
+    struct block {
+        block_header hdr;
+        int16_t last[3];
+        uint8_t data[max_block_data];
+    } _blocks[INS_MAX_INSTANCES][2];
+
+    uint8_t _num_files;
+    uint32_t _file_size;
+
+    // writer thread state
+    int _fd = -1;
+    uint32_t _file_num;
+    uint32_t _file_bytes;
+    uint8_t _write_buf[8192];
+    uint16_t _write_len;
+
+    void writer_thread();
+    void log_status();
+    void add_sample(const queued_sample &s);
+    void finish_block(block &b);
+    void write(const void *data, uint16_t len);
+    void flush_write_buf();
+    bool open_next_file();
+    uint32_t find_last_file_num();
+    void file_name(uint32_t num, char *name, uint8_t len) const;
+};
+
+// the stream is allocated with operator new, which doesn't honour over-alignment
+static_assert(alignof(AP_InertialSensor_BatchStream) <= alignof(std::max_align_t),
+              "AP_InertialSensor_BatchStream must not be over-aligned");
+
+#endif // HAL_INS_BATCH_STREAM_ENABLED
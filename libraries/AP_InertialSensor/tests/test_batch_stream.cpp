@@ -0,0 +1,99 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_InertialSensor/BatchStream.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_INS_BATCH_STREAM_ENABLED
+
+typedef AP_InertialSensor_BatchStream BatchStream;
+
+static void check_round_trip(int32_t delta, uint8_t expected_len)
+{
+    uint8_t buf[5];
+    const uint8_t n = BatchStream::encode_delta(delta, buf);
+    EXPECT_EQ(expected_len, n);
+    int32_t decoded = 0;
+    EXPECT_EQ(n, BatchStream::decode_delta(buf, sizeof(buf), decoded));
+    EXPECT_EQ(delta, decoded);
+}
+
+TEST(AP_InertialSensor_BatchStream, ZigzagEncoding)
+{
+    // small differences of either sign take one byte
+    uint8_t buf[5];
+    EXPECT_EQ(1, BatchStream::encode_delta(0, buf));
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(1, BatchStream::encode_delta(-1, buf));
+    EXPECT_EQ(1, buf[0]);
+    EXPECT_EQ(1, BatchStream::encode_delta(1, buf));
+    EXPECT_EQ(2, buf[0]);
+    EXPECT_EQ(1, BatchStream::encode_delta(-64, buf));
+    EXPECT_EQ(127, buf[0]);
+    EXPECT_EQ(2, BatchStream::encode_delta(64, buf));
+    EXPECT_EQ(0x80, buf[0]);
+    EXPECT_EQ(0x01, buf[1]);
+}
+
+TEST(AP_InertialSensor_BatchStream, RoundTrip)
+{
+    check_round_trip(0, 1);
+    check_round_trip(63, 1);
+    check_round_trip(-64, 1);
+    check_round_trip(64, 2);
+    check_round_trip(-65, 2);
+    check_round_trip(8191, 2);
+    check_round_trip(-8192, 2);
+    check_round_trip(8192, 3);
+    // the largest difference between two int16_t samples fits the 3
+    // bytes allowed for in a block
+    check_round_trip(int32_t(INT16_MAX) - INT16_MIN, 3);
+    check_round_trip(int32_t(INT16_MIN) - INT16_MAX, 3);
+    check_round_trip(INT32_MAX, 5);
+    check_round_trip(INT32_MIN, 5);
+
+    for (int32_t delta = INT16_MIN; delta <= INT16_MAX; delta += 7) {
+        uint8_t buf[5];
+        const uint8_t n = BatchStream::encode_delta(delta, buf);
+        int32_t decoded;
+        ASSERT_EQ(n, BatchStream::decode_delta(buf, n, decoded));
+        ASSERT_EQ(delta, decoded);
+    }
+}
+
+TEST(AP_InertialSensor_BatchStream, SampleSequence)
+{
+    // encode a run of samples as the writer thread does and decode them again
+    const int16_t samples[] { 0, 12, -5, INT16_MAX, INT16_MIN, 100, 100, -32000, 31000 };
+    uint8_t data[3*ARRAY_SIZE(samples)];
+    uint16_t len = 0;
+    for (uint8_t i = 1; i < ARRAY_SIZE(samples); i++) {
+        len += BatchStream::encode_delta(int32_t(samples[i]) - samples[i-1], &data[len]);
+    }
+
+    int16_t last = samples[0];
+    uint16_t ofs = 0;
+    for (uint8_t i = 1; i < ARRAY_SIZE(samples); i++) {
+        int32_t delta;
+        const uint8_t n = BatchStream::decode_delta(&data[ofs], len - ofs, delta);
+        ASSERT_GT(n, 0);
+        ofs += n;
+        last = int16_t(last + delta);
+        EXPECT_EQ(samples[i], last);
+    }
+    EXPECT_EQ(len, ofs);
+}
+
+TEST(AP_InertialSensor_BatchStream, Truncated)
+{
+    uint8_t buf[5];
+    const uint8_t n = BatchStream::encode_delta(20000, buf);
+    int32_t decoded;
+    EXPECT_EQ(0, BatchStream::decode_delta(buf, n-1, decoded));
+    EXPECT_EQ(0, BatchStream::decode_delta(buf, 0, decoded));
+}
+
+#endif // HAL_INS_BATCH_STREAM_ENABLED
+
+AP_GTEST_MAIN()
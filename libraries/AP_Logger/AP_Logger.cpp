@@ -3,6 +3,7 @@
 #include "AP_Logger_Backend.h"
 
 #include "AP_Logger_File.h"
+#include "AP_Logger_File_Mmap.h"
 #include "AP_Logger_SITL.h"
 #include "AP_Logger_DataFlash.h"
 #include "AP_Logger_MAVLink.h"
@@ -10,6 +11,7 @@
 #include <AP_InternalError/AP_InternalError.h>
 #include <GCS_MAVLink/GCS.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
+#include <AP_Trace/AP_Trace.h>
 
 AP_Logger *AP_Logger::_singleton;
 
@@ -47,9 +49,9 @@ extern const AP_HAL::HAL& hal;
 const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @Param: _BACKEND_TYPE
     // @DisplayName: AP_Logger Backend Storage type
-    // @Description: Bitmap of what Logger backend types to enable. Block-based logging is available on SITL and boards with dataflash chips. Multiple backends can be selected.
-    // @Values: 0:None,1:File,2:MAVLink,3:File and MAVLink,4:Block,6:Block and MAVLink
-    // @Bitmask: 0:File,1:MAVLink,2:Block
+    // @Description: Bitmap of what Logger backend types to enable. Block-based logging is available on SITL and boards with dataflash chips. Memory mapped file logging is used on Linux boards and SITL, replacing File logging if both are selected, and falls back to File logging elsewhere. Multiple backends can be selected.
+    // @Values: 0:None,1:File,2:MAVLink,3:File and MAVLink,4:Block,6:Block and MAVLink,8:Memory mapped File,10:Memory mapped File and MAVLink
+    // @Bitmask: 0:File,1:MAVLink,2:Block,3:Memory mapped File
     // @User: Standard
     AP_GROUPINFO("_BACKEND_TYPE",  0, AP_Logger, _params.backend_types,       uint8_t(HAL_LOGGING_BACKENDS_DEFAULT)),
 
@@ -136,13 +138,22 @@ void AP_Logger::Init(const struct LogStructure *structures, uint8_t num_types)
     _structures = structures;
 
 #if defined(HAL_BOARD_LOG_DIRECTORY) && HAVE_FILESYSTEM_SUPPORT
-    if (_params.backend_types & uint8_t(Backend_Type::FILESYSTEM)) {
+    if (_params.backend_types & (uint8_t(Backend_Type::FILESYSTEM) | uint8_t(Backend_Type::FILESYSTEM_MMAP))) {
         LoggerMessageWriter_DFLogStart *message_writer =
             new LoggerMessageWriter_DFLogStart();
         if (message_writer != nullptr)  {
-            backends[_next_backend] = new AP_Logger_File(*this,
-                                                         message_writer,
-                                                         HAL_BOARD_LOG_DIRECTORY);
+#if HAL_LOGGER_FILE_MMAP_ENABLED
+            if (_params.backend_types & uint8_t(Backend_Type::FILESYSTEM_MMAP)) {
+                backends[_next_backend] = new AP_Logger_File_Mmap(*this,
+                                                                  message_writer,
+                                                                  HAL_BOARD_LOG_DIRECTORY);
+            } else
+#endif
+            {
+                backends[_next_backend] = new AP_Logger_File(*this,
+                                                             message_writer,
+                                                             HAL_BOARD_LOG_DIRECTORY);
+            }
         }
         if (backends[_next_backend] == nullptr) {
             hal.console->printf("Unable to open AP_Logger_File");
@@ -742,6 +753,7 @@ void AP_Logger::handle_mavlink_msg(GCS_MAVLINK &link, const mavlink_message_t &m
 }
 
 void AP_Logger::periodic_tasks() {
+    AP_TRACE_SCOPE("Log_PeriodicTasks");
     handle_log_send();
     FOR_EACH_BACKEND(periodic_tasks());
 }
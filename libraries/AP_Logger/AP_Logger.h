@@ -428,6 +428,7 @@ private:
         FILESYSTEM = (1<<0),
         MAVLINK    = (1<<1),
         BLOCK      = (1<<2),
+        FILESYSTEM_MMAP = (1<<3),
     };
 
     /*
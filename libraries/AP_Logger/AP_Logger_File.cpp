@@ -22,6 +22,7 @@
 
 #include <AP_Math/AP_Math.h>
 #include <GCS_MAVLink/GCS.h>
+#include <AP_Trace/AP_Trace.h>
 #include <stdio.h>
 
 
@@ -44,14 +45,14 @@ AP_Logger_File::AP_Logger_File(AP_Logger &front,
                                const char *log_directory) :
     AP_Logger_Backend(front, writer),
     _write_fd(-1),
-    _read_fd(-1),
-    _log_directory(log_directory),
-    _writebuf(0),
     _writebuf_chunk(HAL_LOGGER_WRITE_CHUNK_SIZE),
     _perf_write(hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "DF_write")),
     _perf_fsync(hal.util->perf_alloc(AP_HAL::Util::PC_ELAPSED, "DF_fsync")),
     _perf_errors(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_errors")),
-    _perf_overruns(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_overruns"))
+    _perf_overruns(hal.util->perf_alloc(AP_HAL::Util::PC_COUNT, "DF_overruns")),
+    _read_fd(-1),
+    _log_directory(log_directory),
+    _writebuf(0)
 {
     df_stats_clear();
 }
@@ -149,7 +150,7 @@ void AP_Logger_File::periodic_1Hz()
 
         // semaphore_write_fd not taken here as if the io thread is
         // dead it may not release lock...
-        _write_fd = -1;
+        abandon_log_file();
         _initialised = false;
     }
 }
@@ -796,7 +797,7 @@ void AP_Logger_File::start_new_log(void)
     ensure_log_directory_exists();
 
     EXPECT_DELAY_MS(3000);
-    _write_fd = AP::FS().open(_write_filename, O_WRONLY|O_CREAT|O_TRUNC);
+    _write_fd = AP::FS().open(_write_filename, write_open_flags());
     _cached_oldest_log = 0;
 
     if (_write_fd == -1) {
@@ -870,6 +871,7 @@ void AP_Logger_File::flush(void)
 
 void AP_Logger_File::_io_timer(void)
 {
+    AP_TRACE_SCOPE("Log_FileWrite");
     uint32_t tnow = AP_HAL::millis();
     _io_timer_heartbeat = tnow;
     if (_write_fd == -1 || !_initialised || _open_error) {
@@ -886,17 +888,8 @@ void AP_Logger_File::_io_timer(void)
         // least once per 2 seconds if data is available
         return;
     }
-    if (tnow - _free_space_last_check_time > _free_space_check_interval) {
-        _free_space_last_check_time = tnow;
-        last_io_operation = "disk_space_avail";
-        if (disk_space_avail() < _free_space_min_avail && disk_space() > 0) {
-            hal.console->printf("Out of space for logging\n");
-            stop_logging();
-            _open_error = true; // prevent logging starting again
-            last_io_operation = "";
-            return;
-        }
-        last_io_operation = "";
+    if (!io_check_free_space(tnow)) {
+        return;
     }
 
     hal.util->perf_begin(_perf_write);
@@ -977,6 +970,27 @@ void AP_Logger_File::_io_timer(void)
     hal.util->perf_end(_perf_write);
 }
 
+/*
+  check for free space on the log device, stopping logging if we are
+  running out. Returns false if logging was stopped
+ */
+bool AP_Logger_File::io_check_free_space(uint32_t tnow)
+{
+    if (tnow - _free_space_last_check_time > _free_space_check_interval) {
+        _free_space_last_check_time = tnow;
+        last_io_operation = "disk_space_avail";
+        if (disk_space_avail() < _free_space_min_avail && disk_space() > 0) {
+            hal.console->printf("Out of space for logging\n");
+            stop_logging();
+            _open_error = true; // prevent logging starting again
+            last_io_operation = "";
+            return false;
+        }
+        last_io_operation = "";
+    }
+    return true;
+}
+
 bool AP_Logger_File::io_thread_alive() const
 {
     // if the io thread hasn't had a heartbeat in a full seconds then it is dead
@@ -60,10 +60,50 @@ protected:
     bool WritesOK() const override;
     bool StartNewLogOK() const override;
 
-private:
+    // flags used to open a new log file for writing
+    virtual int write_open_flags() const { return O_WRONLY|O_CREAT|O_TRUNC; }
+
+    // called from the IO thread to move data to the log file
+    virtual void _io_timer(void);
+
+    // check for free space once a second from the IO thread,
+    // returns false if logging has been stopped for lack of space
+    bool io_check_free_space(uint32_t tnow);
+
+    void stop_logging(void) override;
+
+    // stop writing to the log file when the IO thread is stuck,
+    // without blocking or taking write_fd_semaphore
+    virtual void abandon_log_file(void) { _write_fd = -1; }
+
     int _write_fd;
     char *_write_filename;
     uint32_t _last_write_ms;
+    uint32_t _write_offset;
+    volatile bool _open_error;
+    bool _last_write_failed;
+    uint32_t _io_timer_heartbeat;
+    uint32_t _last_write_time;
+    uint32_t last_messagewrite_message_sent;
+
+    const uint16_t _writebuf_chunk;
+
+    // semaphore mediates access to the ringbuffer
+    HAL_Semaphore semaphore;
+    // write_fd_semaphore mediates access to write_fd so the frontend
+    // can open/close files without causing the backend to write to a
+    // bad fd
+    HAL_Semaphore write_fd_semaphore;
+
+    // performance counters
+    AP_HAL::Util::perf_counter_t  _perf_write;
+    AP_HAL::Util::perf_counter_t  _perf_fsync;
+    AP_HAL::Util::perf_counter_t  _perf_errors;
+    AP_HAL::Util::perf_counter_t  _perf_overruns;
+
+    const char *last_io_operation = "";
+
+private:
 #if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
     bool _need_rtc_update;
 #endif
@@ -71,12 +111,8 @@ private:
     int _read_fd;
     uint16_t _read_fd_log_num;
     uint32_t _read_offset;
-    uint32_t _write_offset;
-    volatile bool _open_error;
     const char *_log_directory;
-    bool _last_write_failed;
 
-    uint32_t _io_timer_heartbeat;
     bool io_thread_alive() const;
     uint8_t io_thread_warning_decimation_counter;
 
@@ -93,8 +129,6 @@ private:
 
     // write buffer
     ByteBuffer _writebuf;
-    const uint16_t _writebuf_chunk;
-    uint32_t _last_write_time;
 
     /* construct a file name given a log number. Caller must free. */
     char *_log_file_name(const uint16_t log_num) const;
@@ -104,33 +138,12 @@ private:
     uint32_t _get_log_size(const uint16_t log_num);
     uint32_t _get_log_time(const uint16_t log_num);
 
-    void stop_logging(void) override;
-
-    void _io_timer(void);
-
-    uint32_t last_messagewrite_message_sent;
-
     // free-space checks; filling up SD cards under NuttX leads to
     // corrupt filesystems which cause loss of data, failure to gather
     // data and failures-to-boot.
     uint32_t _free_space_last_check_time; // milliseconds
     const uint32_t _free_space_check_interval = 1000UL; // milliseconds
     const uint32_t _free_space_min_avail = 8388608; // bytes
-
-    // semaphore mediates access to the ringbuffer
-    HAL_Semaphore semaphore;
-    // write_fd_semaphore mediates access to write_fd so the frontend
-    // can open/close files without causing the backend to write to a
-    // bad fd
-    HAL_Semaphore write_fd_semaphore;
-    
-    // performance counters
-    AP_HAL::Util::perf_counter_t  _perf_write;
-    AP_HAL::Util::perf_counter_t  _perf_fsync;
-    AP_HAL::Util::perf_counter_t  _perf_errors;
-    AP_HAL::Util::perf_counter_t  _perf_overruns;
-
-    const char *last_io_operation = "";
 };
 
 #endif // HAVE_FILESYSTEM_SUPPORT
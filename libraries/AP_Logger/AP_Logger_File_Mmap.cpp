@@ -0,0 +1,452 @@
+/*
+   AP_Logger logging - memory mapped file variant
+
+   Log messages are copied straight into a shared mapping of the log
+   file, so the writers never block on a ring buffer and the IO thread
+   never copies data. The IO thread's job is reduced to:
+
+    - mapping the next segment of the file before the writers need it
+    - flushing dirty pages to the file and dropping them from memory
+    - unmapping segments the writers have moved past
+
+   Space for each segment is allocated in the file before it is
+   mapped so that a full disk results in dropped messages rather than
+   a SIGBUS in a writer. The file is truncated back to the written
+   length when logging stops; a log that is not closed cleanly is
+   padded with zeroes up to the end of the last mapped segment, which
+   log parsers skip over.
+ */
+
+#include "AP_Logger_File_Mmap.h"
+
+#if HAL_LOGGER_FILE_MMAP_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_InternalError/AP_InternalError.h>
+#include <AP_Math/AP_Math.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+extern const AP_HAL::HAL& hal;
+
+#ifndef HAL_LOGGER_MMAP_SEGMENT_SIZE
+#define HAL_LOGGER_MMAP_SEGMENT_SIZE (4U*1024U*1024U)
+#endif
+
+/*
+  constructor
+ */
+AP_Logger_File_Mmap::AP_Logger_File_Mmap(AP_Logger &front,
+                                         LoggerMessageWriter_DFLogStart *writer,
+                                         const char *log_directory) :
+    AP_Logger_File(front, writer, log_directory),
+    _segment_size(HAL_LOGGER_MMAP_SEGMENT_SIZE),
+    _segments(HAL_LOGGER_MMAP_SEGMENT_SIZE)
+{
+}
+
+void AP_Logger_File_Mmap::Init()
+{
+    _page_size = sysconf(_SC_PAGESIZE);
+    if (_page_size == 0 || _segment_size % _page_size != 0) {
+        hal.console->printf("AP_Logger_File_Mmap: bad segment size %u\n", (unsigned)_segment_size);
+        return;
+    }
+
+    hal.console->printf("AP_Logger_File_Mmap: segment size=%u\n", (unsigned)_segment_size);
+
+    _initialised = true;
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_Logger_File_Mmap::_io_timer, void));
+}
+
+/*
+  allocate space in the log file for the segment starting at offset
+  and map it. Must be called with write_fd_semaphore held
+ */
+uint8_t *AP_Logger_File_Mmap::map_segment(uint32_t offset)
+{
+    last_io_operation = "fallocate";
+    const int ret = posix_fallocate(_write_fd, offset, _segment_size);
+    last_io_operation = "";
+    if (ret != 0) {
+        printf("Log fallocate failed: %s\n", strerror(ret));
+        return nullptr;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    // fault the pages in now rather than in the writers
+    flags |= MAP_POPULATE;
+#endif
+    last_io_operation = "mmap";
+    void *base = mmap(nullptr, _segment_size, PROT_READ|PROT_WRITE, flags, _write_fd, offset);
+    last_io_operation = "";
+    if (base == MAP_FAILED) {
+        printf("Log mmap failed: %s\n", strerror(errno));
+        return nullptr;
+    }
+    return (uint8_t *)base;
+}
+
+uint32_t AP_Logger_File_Mmap::bufferspace_available()
+{
+    const uint32_t space = _segments.space(_write_offset);
+    const uint32_t crit = critical_message_reserved_space(_segment_size);
+
+    return (space > crit) ? space - crit : 0;
+}
+
+/* Write a block of data at current offset */
+bool AP_Logger_File_Mmap::_WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical)
+{
+    if (! WriteBlockCheckStartupMessages()) {
+        _dropped++;
+        return false;
+    }
+
+    if (!semaphore.take(1)) {
+        return false;
+    }
+
+    const uint32_t space = _segments.space(_write_offset);
+
+    if (_writing_startup_messages &&
+        _startup_messagewriter->fmt_done()) {
+        // leave room for other things, as in AP_Logger_File
+        const uint32_t now = AP_HAL::millis();
+        const bool must_dribble = (now - last_messagewrite_message_sent) > 100;
+        if (!must_dribble &&
+            space < non_messagewriter_message_reserved_space(_segment_size)) {
+            // this message isn't dropped, it will be sent again...
+            semaphore.give();
+            return false;
+        }
+        last_messagewrite_message_sent = now;
+    } else {
+        // we reserve some amount of space for critical messages:
+        if (!is_critical && space < critical_message_reserved_space(_segment_size)) {
+            _dropped++;
+            semaphore.give();
+            return false;
+        }
+    }
+
+    // if the IO thread has not mapped enough of the file - drop it:
+    if (space < size) {
+        hal.util->perf_count(_perf_overruns);
+        _dropped++;
+        semaphore.give();
+        return false;
+    }
+
+    _segments.write(_write_offset, pBuffer, size);
+    _write_offset += size;
+
+    df_stats_gather(size, space - size);
+    semaphore.give();
+    return true;
+}
+
+/*
+  start writing to a new log file
+ */
+void AP_Logger_File_Mmap::start_new_log(void)
+{
+    AP_Logger_File::start_new_log();
+
+    if (!write_fd_semaphore.take(1)) {
+        return;
+    }
+    if (_write_fd == -1) {
+        write_fd_semaphore.give();
+        return;
+    }
+    uint8_t *base = map_segment(0);
+    write_fd_semaphore.give();
+
+    if (base == nullptr) {
+        stop_logging();
+        _open_error = true;
+        return;
+    }
+
+    WITH_SEMAPHORE(semaphore);
+    _segments.start(base);
+    _synced_offset = 0;
+}
+
+/*
+  unmap both segments and give back the space allocated in the file
+  ahead of the writers. If the IO thread is using the segments they
+  are handed to it to unmap, so it never touches an unmapped address
+ */
+void AP_Logger_File_Mmap::release_segments(int fd)
+{
+    AP_Logger_MmapSegments::segment old[2];
+    uint32_t length;
+    {
+        WITH_SEMAPHORE(semaphore);
+        _segments.clear(old);
+        _segments_generation++;
+        length = _write_offset;
+        if (_io_using_segments) {
+            for (auto &seg : old) {
+                for (auto &abandoned : _abandoned) {
+                    if (seg.base != nullptr && abandoned.base == nullptr) {
+                        abandoned = seg;
+                        seg.base = nullptr;
+                    }
+                }
+                // if the IO thread is stuck for long enough to fill
+                // _abandoned, a mapping is leaked rather than risk a
+                // fault in the IO thread
+                seg.base = nullptr;
+            }
+        }
+    }
+    for (auto &seg : old) {
+        if (seg.base != nullptr) {
+            munmap(seg.base, _segment_size);
+        }
+    }
+    if (fd != -1 && ftruncate(fd, length) != 0) {
+        printf("Log truncate failed: %s\n", strerror(errno));
+    }
+}
+
+/*
+  unmap segments released while the IO thread was using them, called
+  from the IO thread
+ */
+void AP_Logger_File_Mmap::unmap_abandoned()
+{
+    AP_Logger_MmapSegments::segment abandoned[ARRAY_SIZE(_abandoned)];
+    {
+        WITH_SEMAPHORE(semaphore);
+        _io_using_segments = false;
+        memcpy(abandoned, _abandoned, sizeof(abandoned));
+        memset(_abandoned, 0, sizeof(_abandoned));
+    }
+    for (auto &seg : abandoned) {
+        if (seg.base != nullptr) {
+            munmap(seg.base, _segment_size);
+        }
+    }
+}
+
+/*
+  stop logging
+ */
+void AP_Logger_File_Mmap::stop_logging(void)
+{
+    // best-case effort to avoid annoying the IO thread
+    const bool have_sem = write_fd_semaphore.take(hal.util->get_soft_armed()?1:20);
+
+    const int fd = _write_fd;
+    _write_fd = -1;
+    release_segments(fd);
+    if (fd != -1) {
+        AP::FS().close(fd);
+    }
+    if (have_sem) {
+        write_fd_semaphore.give();
+    }
+}
+
+/*
+  the IO thread is stuck. The segments are still released so the log
+  isn't left padded with zeroes; those the IO thread is using are
+  unmapped by it if it recovers. The writers only hold semaphore while
+  copying, so taking it can't block on the IO thread
+ */
+void AP_Logger_File_Mmap::abandon_log_file(void)
+{
+    const int fd = _write_fd;
+    _write_fd = -1;
+    release_segments(fd);
+}
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+void AP_Logger_File_Mmap::flush(void)
+#if APM_BUILD_TYPE(APM_BUILD_Replay) || APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
+{
+    if (!write_fd_semaphore.take(1)) {
+        INTERNAL_ERROR(AP_InternalError::error_t::logger_flushing_without_sem);
+        return;
+    }
+    {
+        WITH_SEMAPHORE(semaphore);
+        const AP_Logger_MmapSegments::segment segs[] { _segments.current(), _segments.next() };
+        for (const auto &seg : segs) {
+            if (seg.base != nullptr) {
+                msync(seg.base, _segment_size, MS_SYNC);
+            }
+        }
+        _synced_offset = _write_offset;
+    }
+    write_fd_semaphore.give();
+}
+#else
+{
+    // flush is for replay and examples only
+}
+#endif // APM_BUILD_TYPE(APM_BUILD_Replay) || APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
+#endif
+
+/*
+  once the writers have moved into the segment mapped ahead, flush
+  and release the segment behind them
+ */
+void AP_Logger_File_Mmap::retire_segment()
+{
+    AP_Logger_MmapSegments::segment retired {};
+    {
+        WITH_SEMAPHORE(semaphore);
+        if (!_segments.retire(_write_offset, retired)) {
+            return;
+        }
+    }
+
+    last_io_operation = "msync";
+    if (msync(retired.base, _segment_size, MS_SYNC) != 0) {
+        hal.util->perf_count(_perf_errors);
+    }
+    munmap(retired.base, _segment_size);
+    last_io_operation = "";
+    _synced_offset = MAX(_synced_offset, retired.offset + _segment_size);
+}
+
+/*
+  map the next segment once the current one is half full, so the
+  mapping cost is never paid by a writer
+ */
+void AP_Logger_File_Mmap::map_next_segment()
+{
+    uint32_t next_offset;
+    uint32_t generation;
+    {
+        WITH_SEMAPHORE(semaphore);
+        if (!_segments.want_next(_write_offset, next_offset)) {
+            return;
+        }
+        generation = _segments_generation;
+    }
+
+    uint8_t *base = map_segment(next_offset);
+    if (base == nullptr) {
+        // writers will start dropping messages when they reach the
+        // end of the current segment; we retry on the next call
+        _last_write_failed = true;
+        return;
+    }
+
+    {
+        WITH_SEMAPHORE(semaphore);
+        if (generation == _segments_generation) {
+            _segments.add_next(base, next_offset);
+            return;
+        }
+    }
+    // the log was stopped while we were mapping
+    munmap(base, _segment_size);
+}
+
+/*
+  write dirty pages in the current segment back to the file
+ */
+void AP_Logger_File_Mmap::sync_written(uint32_t tnow)
+{
+    uint32_t written;
+    AP_Logger_MmapSegments::segment seg;
+    {
+        WITH_SEMAPHORE(semaphore);
+        written = _write_offset;
+        seg = _segments.current();
+    }
+    if (seg.base == nullptr || written == _synced_offset) {
+        return;
+    }
+    if (written - _synced_offset < _writebuf_chunk &&
+        tnow - _last_write_time < 2000UL) {
+        // sync in _writebuf_chunk-sized chunks, but always sync at
+        // least once per 2 seconds if data is available
+        return;
+    }
+    _last_write_time = tnow;
+
+    // anything past this segment is synced when the segment is retired
+    const uint32_t end = MIN(written, seg.offset + _segment_size);
+    const uint32_t start = _synced_offset & ~(_page_size-1);
+    if (end <= start) {
+        return;
+    }
+    uint8_t *addr = &seg.base[start - seg.offset];
+
+    /*
+      as with fsync in AP_Logger_File, wait for the data to reach the
+      card on real boards to minimise corruption on power loss
+     */
+#if CONFIG_HAL_BOARD != HAL_BOARD_SITL && CONFIG_HAL_BOARD_SUBTYPE != HAL_BOARD_SUBTYPE_LINUX_NONE
+    const int sync_flags = MS_SYNC;
+#else
+    const int sync_flags = MS_ASYNC;
+#endif
+    last_io_operation = "msync";
+    if (msync(addr, end - start, sync_flags) != 0) {
+        last_io_operation = "";
+        hal.util->perf_count(_perf_errors);
+        _last_write_failed = true;
+        return;
+    }
+
+    // pages which will not be written again need not stay resident
+    const uint32_t full_pages_end = end & ~(_page_size-1);
+    if (sync_flags == MS_SYNC && full_pages_end > start) {
+        last_io_operation = "madvise";
+        madvise(addr, full_pages_end - start, MADV_DONTNEED);
+    }
+    last_io_operation = "";
+
+    _synced_offset = end;
+    _last_write_failed = false;
+    _last_write_ms = tnow;
+}
+
+void AP_Logger_File_Mmap::_io_timer(void)
+{
+    uint32_t tnow = AP_HAL::millis();
+    _io_timer_heartbeat = tnow;
+    if (_write_fd == -1 || !_initialised || _open_error) {
+        return;
+    }
+    if (!io_check_free_space(tnow)) {
+        return;
+    }
+
+    if (!write_fd_semaphore.take(1)) {
+        return;
+    }
+    {
+        WITH_SEMAPHORE(semaphore);
+        if (_write_fd == -1 || _segments.current().base == nullptr) {
+            write_fd_semaphore.give();
+            return;
+        }
+        _io_using_segments = true;
+    }
+
+    hal.util->perf_begin(_perf_write);
+    retire_segment();
+    map_next_segment();
+    sync_written(tnow);
+    unmap_abandoned();
+    hal.util->perf_end(_perf_write);
+
+    write_fd_semaphore.give();
+}
+
+#endif // HAL_LOGGER_FILE_MMAP_ENABLED
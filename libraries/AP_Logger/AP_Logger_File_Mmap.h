@@ -0,0 +1,88 @@
+/*
+   AP_Logger logging - memory mapped file variant
+
+   This writes log messages straight into a memory mapped window of
+   the log file instead of copying them through a ring buffer. The IO
+   thread maps the next segment of the file ahead of the writers and
+   flushes and releases the segments behind them.
+ */
+#pragma once
+
+#include "AP_Logger_File.h"
+#include "AP_Logger_MmapSegments.h"
+
+#ifndef HAL_LOGGER_FILE_MMAP_ENABLED
+#if HAVE_FILESYSTEM_SUPPORT && defined(__linux__) && (CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#define HAL_LOGGER_FILE_MMAP_ENABLED 1
+#else
+#define HAL_LOGGER_FILE_MMAP_ENABLED 0
+#endif
+#endif
+
+#if HAL_LOGGER_FILE_MMAP_ENABLED
+
+class AP_Logger_File_Mmap : public AP_Logger_File
+{
+public:
+    // constructor
+    AP_Logger_File_Mmap(AP_Logger &front,
+                        LoggerMessageWriter_DFLogStart *writer,
+                        const char *log_directory);
+
+    // initialisation
+    void Init() override;
+
+    /* Write a block of data at current offset */
+    bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override;
+    uint32_t bufferspace_available() override;
+
+    void start_new_log(void) override;
+
+    void flush(void) override;
+
+protected:
+
+    // the log file must be readable to be mapped shared
+    int write_open_flags() const override { return O_RDWR|O_CREAT|O_TRUNC; }
+
+    void _io_timer(void) override;
+
+    void stop_logging(void) override;
+    void abandon_log_file(void) override;
+
+private:
+    // size of each mapped window of the log file, a multiple of the page size
+    const uint32_t _segment_size;
+    uint32_t _page_size;
+
+    // the windows of the log file being written to, protected by semaphore
+    AP_Logger_MmapSegments _segments;
+
+    // file offset up to which data has been flushed
+    uint32_t _synced_offset;
+
+    // incremented each time the segments are released, so the IO
+    // thread can tell that a segment it mapped belongs to a dead log
+    uint32_t _segments_generation;
+
+    // true while the IO thread is using the segments outside
+    // semaphore. Segments released meanwhile are left for the IO
+    // thread to unmap once it is done, in _abandoned
+    bool _io_using_segments;
+    AP_Logger_MmapSegments::segment _abandoned[4];
+
+    // allocate space in the file for a segment and map it, returns nullptr on failure
+    uint8_t *map_segment(uint32_t offset);
+
+    // unmap both segments and truncate the file to the written length
+    void release_segments(int fd);
+    // unmap segments released while the IO thread was using them
+    void unmap_abandoned();
+
+    // IO thread helpers
+    void retire_segment();
+    void map_next_segment();
+    void sync_written(uint32_t tnow);
+};
+
+#endif // HAL_LOGGER_FILE_MMAP_ENABLED
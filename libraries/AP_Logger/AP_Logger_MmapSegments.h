@@ -0,0 +1,127 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  the pair of mapped windows of a log file used by AP_Logger_File_Mmap
+
+  The first segment is being written to, the second is mapped ahead
+  of it so that writes can carry straight on into the next window.
+  This only keeps track of where the windows are; mapping and
+  unmapping them and locking are left to the caller.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <AP_Math/AP_Math.h>
+
+class AP_Logger_MmapSegments
+{
+public:
+    // a window of the log file mapped into memory
+    struct segment {
+        uint8_t *base;      // nullptr if not mapped
+        uint32_t offset;    // file offset of the start of the window
+    };
+
+    AP_Logger_MmapSegments(uint32_t segment_size) :
+        _segment_size(segment_size) {}
+
+    uint32_t segment_size() const { return _segment_size; }
+
+    // the segment being written to
+    const struct segment &current() const { return _segment[0]; }
+
+    // the segment mapped ahead of the writers
+    const struct segment &next() const { return _segment[1]; }
+
+    // start writing at the beginning of the file
+    void start(uint8_t *base) {
+        _segment[0].base = base;
+        _segment[0].offset = 0;
+        _segment[1].base = nullptr;
+    }
+
+    // number of bytes which can be written at write_offset before
+    // running off the end of the mapped segments
+    uint32_t space(uint32_t write_offset) const {
+        if (_segment[0].base == nullptr) {
+            return 0;
+        }
+        uint32_t ret = _segment[0].offset + _segment_size - write_offset;
+        if (_segment[1].base != nullptr) {
+            ret += _segment_size;
+        }
+        return ret;
+    }
+
+    // copy a message to write_offset, which may straddle the end of
+    // the current segment, or lie entirely in the next segment if the
+    // writers have moved into it before it has been retired. The
+    // caller must have checked space()
+    void write(uint32_t write_offset, const void *data, uint16_t size) {
+        const uint8_t *src = (const uint8_t *)data;
+        const uint32_t ofs = write_offset - _segment[0].offset;
+        if (ofs >= _segment_size) {
+            memcpy(&_segment[1].base[ofs - _segment_size], src, size);
+            return;
+        }
+        const uint32_t n = MIN(uint32_t(size), _segment_size - ofs);
+        memcpy(&_segment[0].base[ofs], src, n);
+        if (n < size) {
+            memcpy(_segment[1].base, &src[n], size - n);
+        }
+    }
+
+    // once the current segment is half full, the file offset of the
+    // next segment to map ahead of the writers
+    bool want_next(uint32_t write_offset, uint32_t &next_offset) const {
+        if (_segment[0].base == nullptr ||
+            _segment[1].base != nullptr ||
+            write_offset - _segment[0].offset < _segment_size/2) {
+            return false;
+        }
+        next_offset = _segment[0].offset + _segment_size;
+        return true;
+    }
+
+    // add the segment mapped ahead of the writers
+    void add_next(uint8_t *base, uint32_t offset) {
+        _segment[1].base = base;
+        _segment[1].offset = offset;
+    }
+
+    // once the writers have moved into the segment mapped ahead, make
+    // it the current one and return the segment behind them
+    bool retire(uint32_t write_offset, struct segment &retired) {
+        if (_segment[1].base == nullptr || write_offset < _segment[1].offset) {
+            return false;
+        }
+        retired = _segment[0];
+        _segment[0] = _segment[1];
+        _segment[1].base = nullptr;
+        return true;
+    }
+
+    // forget both segments, returning them for unmapping
+    void clear(struct segment old[2]) {
+        memcpy(old, _segment, sizeof(_segment));
+        memset(_segment, 0, sizeof(_segment));
+    }
+
+private:
+    const uint32_t _segment_size;
+    struct segment _segment[2] {};
+};
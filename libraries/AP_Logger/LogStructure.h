@@ -340,6 +340,9 @@ struct PACKED log_MAV {
     uint8_t flags;
     uint16_t stream_slowdown_ms;
     uint16_t times_full;
+    uint32_t bandwidth;
+    uint16_t stream_scale;
+    uint16_t priority_scale;
 };
 
 struct PACKED log_RSSI {
@@ -690,6 +693,16 @@ struct PACKED log_ekfStateVar {
     float v11;
 };
 
+struct PACKED log_XKLT {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t core;
+    uint8_t parallel;
+    uint16_t count;
+    uint32_t avg_us;
+    uint32_t max_us;
+};
+
 struct PACKED log_Cmd {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -1174,6 +1187,28 @@ struct PACKED log_Performance {
     uint32_t extra_loop_us;
 };
 
+// per-task scheduler latency histogram; bucket n counts samples in
+// [16*4^(n-1), 16*4^n) microseconds, with bucket 0 starting at zero
+// and bucket 5 having no upper limit
+struct PACKED log_TaskHistogram {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t  task;
+    uint16_t budget_overruns;
+    uint16_t exec[6];
+    uint16_t jitter[6];
+};
+
+// one AP_Trace event
+struct PACKED log_Trace {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    int32_t  value;
+    uint8_t  type;
+    uint8_t  thread;
+    char     name[16];
+};
+
 struct PACKED log_SRTL {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -1782,6 +1817,9 @@ struct PACKED log_PSC {
 // @Field: flags: compact representation of some stage of the channel
 // @Field: ss: stream slowdown is the number of ms being added to each message to fit within bandwidth
 // @Field: tf: times buffer was full when a message was going to be sent
+// @Field: bw: estimated link bandwidth in bytes per second
+// @Field: sc: percentage scaling of stream intervals to fit within bandwidth
+// @Field: psc: percentage scaling of priority stream intervals to fit within bandwidth
 
 // @LoggerMessage: MAVC
 // @Description: MAVLink command we have just executed
@@ -2028,6 +2066,32 @@ struct PACKED log_PSC {
 // @Field: I2CI: Number of i2c interrupts serviced
 // @Field: ExUS: number of microseconds being added to each loop to address scheduler overruns
 
+// @LoggerMessage: SCHH
+// @Description: Scheduler per-task latency histograms over the last second, written when SCHED_OPTIONS bit 1 is set. Bucket 0 is 0-15us, 1 is 16-63us, 2 is 64-255us, 3 is 256-1023us, 4 is 1024-4095us and 5 is 4096us and over
+// @Field: TimeUS: Time since system startup
+// @Field: T: task index, as listed in @SYS/tasks.txt
+// @Field: BOv: number of times this task used up the time remaining in the loop
+// @Field: E0: task runs which took 0-15us
+// @Field: E1: task runs which took 16-63us
+// @Field: E2: task runs which took 64-255us
+// @Field: E3: task runs which took 256-1023us
+// @Field: E4: task runs which took 1024-4095us
+// @Field: E5: task runs which took 4096us or longer
+// @Field: J0: task starts which were within 15us of the requested interval
+// @Field: J1: task starts which were 16-63us away from the requested interval
+// @Field: J2: task starts which were 64-255us away from the requested interval
+// @Field: J3: task starts which were 256-1023us away from the requested interval
+// @Field: J4: task starts which were 1024-4095us away from the requested interval
+// @Field: J5: task starts which were 4096us or more away from the requested interval
+
+// @LoggerMessage: TRCE
+// @Description: Timing trace events from code instrumented with the AP_TRACE macros, only in builds with HAL_TRACE_ENABLED
+// @Field: TimeUS: Time the event started
+// @Field: Val: duration of a span in microseconds, or the value of a counter
+// @Field: Type: event type, 0 for a span, 1 for an instant and 2 for a counter
+// @Field: Thr: priority of the thread which recorded the event
+// @Field: Name: event name
+
 // @LoggerMessage: POS
 // @Description: Canonical vehicle position
 // @Field: TimeUS: Time since system startup
@@ -2453,6 +2517,15 @@ struct PACKED log_PSC {
 // @Field: V22: Variance for state 22
 // @Field: V23: Variance for state 23
 
+// @LoggerMessage: XKLT
+// @Description: EKF3 lane update timing
+// @Field: TimeUS: Time since system startup
+// @Field: C: EKF3 core this data is for
+// @Field: Par: true if the lanes are being updated in parallel
+// @Field: N: number of lane updates since the last message
+// @Field: Avg: average time taken by a lane update
+// @Field: Max: maximum time taken by a lane update
+
 // @LoggerMessage: WINC
 // @Description: Winch
 // @Field: TimeUS: Time since system startup
@@ -2608,6 +2681,12 @@ struct PACKED log_PSC {
       "XKV1","Qffffffffffff","TimeUS,V00,V01,V02,V03,V04,V05,V06,V07,V08,V09,V10,V11", "s------------", "F------------" }, \
     { LOG_XKV2_MSG, sizeof(log_ekfStateVar), \
       "XKV2","Qffffffffffff","TimeUS,V12,V13,V14,V15,V16,V17,V18,V19,V20,V21,V22,V23", "s------------", "F------------" }, \
+    { LOG_XKLT_MSG, sizeof(log_XKLT), \
+      "XKLT","QBBHII","TimeUS,C,Par,N,Avg,Max", "s#--ss", "F---FF" }, \
+    { LOG_SCHED_HIST_MSG, sizeof(log_TaskHistogram), \
+      "SCHH","QBHHHHHHHHHHHHH","TimeUS,T,BOv,E0,E1,E2,E3,E4,E5,J0,J1,J2,J3,J4,J5", "s#-------------", "F--------------" }, \
+    { LOG_TRACE_MSG, sizeof(log_Trace), \
+      "TRCE","QiBBN","TimeUS,Val,Type,Thr,Name", "s----", "F----" }, \
     { LOG_TERRAIN_MSG, sizeof(log_TERRAIN), \
       "TERR","QBLLHffHH","TimeUS,Status,Lat,Lng,Spacing,TerrH,CHeight,Pending,Loaded", "s-DU-mm--", "F-GG-00--" }, \
     { LOG_GPS_UBX1_MSG, sizeof(log_Ubx1), \
@@ -2681,7 +2760,7 @@ struct PACKED log_PSC {
     { LOG_RALLY_MSG, sizeof(log_Rally), \
       "RALY", "QBBLLh", "TimeUS,Tot,Seq,Lat,Lng,Alt", "s--DUm", "F--GGB" },  \
     { LOG_MAV_MSG, sizeof(log_MAV),   \
-      "MAV", "QBHHHBHH",   "TimeUS,chan,txp,rxp,rxdp,flags,ss,tf", "s#----s-", "F-000-C-" },   \
+      "MAV", "QBHHHBHHIHH",   "TimeUS,chan,txp,rxp,rxdp,flags,ss,tf,bw,sc,psc", "s#----s----", "F-000-C----" },   \
     { LOG_VISUALODOM_MSG, sizeof(log_VisualOdom), \
       "VISO", "Qffffffff", "TimeUS,dt,AngDX,AngDY,AngDZ,PosDX,PosDY,PosDZ,conf", "ssrrrmmm-", "FF000000-" }, \
     { LOG_VISUALPOS_MSG, sizeof(log_VisualPosition), \
@@ -2866,6 +2945,9 @@ enum LogMessages : uint8_t {
     LOG_SIMPLE_AVOID_MSG,
     LOG_WINCH_MSG,
     LOG_PSC_MSG,
+    LOG_XKLT_MSG,
+    LOG_SCHED_HIST_MSG,
+    LOG_TRACE_MSG,
 
     _LOG_LAST_MSG_
 };
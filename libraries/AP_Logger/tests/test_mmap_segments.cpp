@@ -0,0 +1,178 @@
+#include <AP_gtest.h>
+
+#include <AP_Logger/AP_Logger_MmapSegments.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  plain buffers stand in for the mapped windows of the log file, and
+  a copy of the whole file is kept to check what the writers put there
+ */
+#define SEGMENT_SIZE 64U
+#define FILE_SIZE (8*SEGMENT_SIZE)
+
+class MmapSegmentsTest : public ::testing::Test {
+protected:
+    MmapSegmentsTest() : segments(SEGMENT_SIZE) {}
+
+    // map the segment at offset, as AP_Logger_File_Mmap::map_segment
+    uint8_t *map(uint32_t offset) {
+        return &file[offset];
+    }
+
+    // write a message of size bytes if it fits, as the backend does
+    bool write(uint16_t size) {
+        if (segments.space(write_offset) < size) {
+            return false;
+        }
+        uint8_t msg[SEGMENT_SIZE];
+        for (uint16_t i = 0; i < size; i++) {
+            msg[i] = uint8_t(write_offset + i);
+        }
+        segments.write(write_offset, msg, size);
+        write_offset += size;
+        return true;
+    }
+
+    // one pass of the IO thread, returns the offset of any retired segment
+    int32_t io_timer() {
+        int32_t ret = -1;
+        AP_Logger_MmapSegments::segment retired;
+        if (segments.retire(write_offset, retired)) {
+            ret = retired.offset;
+        }
+        uint32_t next_offset;
+        if (segments.want_next(write_offset, next_offset)) {
+            segments.add_next(map(next_offset), next_offset);
+        }
+        return ret;
+    }
+
+    AP_Logger_MmapSegments segments;
+    uint32_t write_offset = 0;
+    uint8_t file[FILE_SIZE] {};
+};
+
+TEST_F(MmapSegmentsTest, NothingMapped)
+{
+    uint32_t next_offset;
+    EXPECT_EQ(0U, segments.space(0));
+    EXPECT_FALSE(segments.want_next(0, next_offset));
+    EXPECT_FALSE(write(1));
+}
+
+TEST_F(MmapSegmentsTest, MapsAheadAtHalfFull)
+{
+    segments.start(map(0));
+    EXPECT_EQ(SEGMENT_SIZE, segments.space(write_offset));
+
+    EXPECT_TRUE(write(SEGMENT_SIZE/2 - 1));
+    EXPECT_EQ(-1, io_timer());
+    EXPECT_EQ(nullptr, segments.next().base);
+
+    EXPECT_TRUE(write(1));
+    EXPECT_EQ(-1, io_timer());
+    EXPECT_EQ(&file[SEGMENT_SIZE], segments.next().base);
+    EXPECT_EQ(SEGMENT_SIZE, segments.next().offset);
+    EXPECT_EQ(SEGMENT_SIZE + SEGMENT_SIZE/2, segments.space(write_offset));
+}
+
+TEST_F(MmapSegmentsTest, DropsWithoutNextSegment)
+{
+    segments.start(map(0));
+    EXPECT_TRUE(write(SEGMENT_SIZE - 4));
+    // the IO thread hasn't run, so only the current segment is mapped
+    EXPECT_FALSE(write(5));
+    EXPECT_TRUE(write(4));
+    EXPECT_EQ(0U, segments.space(write_offset));
+    EXPECT_FALSE(write(1));
+}
+
+TEST_F(MmapSegmentsTest, WritesStraddleSegments)
+{
+    segments.start(map(0));
+    EXPECT_TRUE(write(SEGMENT_SIZE - 5));
+    io_timer();
+    EXPECT_TRUE(write(10));
+
+    // the current segment is kept until the writers are past it
+    EXPECT_EQ(0U, segments.current().offset);
+    EXPECT_EQ(0, io_timer());
+    EXPECT_EQ(SEGMENT_SIZE, segments.current().offset);
+    EXPECT_EQ(nullptr, segments.next().base);
+
+    for (uint32_t i = 0; i < write_offset; i++) {
+        EXPECT_EQ(uint8_t(i), file[i]);
+    }
+}
+
+TEST_F(MmapSegmentsTest, WritesIntoNextBeforeRetire)
+{
+    // separate windows, with space after the current one to catch
+    // writes past its end
+    uint8_t current[2*SEGMENT_SIZE] {};
+    uint8_t next[SEGMENT_SIZE] {};
+    segments.start(current);
+    EXPECT_TRUE(write(40));
+    segments.add_next(next, SEGMENT_SIZE);
+    EXPECT_TRUE(write(30));
+    // the writers are now in the next segment but the IO thread has
+    // not retired the current one
+    EXPECT_TRUE(write(10));
+    EXPECT_TRUE(write(10));
+
+    for (uint32_t i = 0; i < SEGMENT_SIZE; i++) {
+        EXPECT_EQ(uint8_t(i), current[i]);
+    }
+    for (uint32_t i = SEGMENT_SIZE; i < ARRAY_SIZE(current); i++) {
+        EXPECT_EQ(0U, current[i]);
+    }
+    for (uint32_t i = SEGMENT_SIZE; i < write_offset; i++) {
+        EXPECT_EQ(uint8_t(i), next[i - SEGMENT_SIZE]);
+    }
+}
+
+TEST_F(MmapSegmentsTest, WrapsThroughFile)
+{
+    segments.start(map(0));
+    int32_t expected_retired = 0;
+    const uint16_t sizes[] { 1, 7, 13, 29, 31 };
+    uint8_t n = 0;
+    while (write_offset + SEGMENT_SIZE < FILE_SIZE) {
+        // writers never run out of space as long as the IO thread
+        // runs once per half segment
+        ASSERT_TRUE(write(sizes[n++ % ARRAY_SIZE(sizes)]));
+        const int32_t retired = io_timer();
+        if (retired != -1) {
+            EXPECT_EQ(expected_retired, retired);
+            expected_retired += SEGMENT_SIZE;
+        }
+        EXPECT_LE(segments.current().offset, write_offset);
+        EXPECT_LT(write_offset, segments.current().offset + SEGMENT_SIZE);
+    }
+    EXPECT_GT(expected_retired, int32_t(4*SEGMENT_SIZE));
+
+    for (uint32_t i = 0; i < write_offset; i++) {
+        EXPECT_EQ(uint8_t(i), file[i]);
+    }
+    // nothing was written past the end of the data
+    for (uint32_t i = write_offset; i < FILE_SIZE; i++) {
+        EXPECT_EQ(0U, file[i]);
+    }
+}
+
+TEST_F(MmapSegmentsTest, ClearReturnsBothSegments)
+{
+    segments.start(map(0));
+    EXPECT_TRUE(write(SEGMENT_SIZE/2));
+    io_timer();
+
+    AP_Logger_MmapSegments::segment old[2];
+    segments.clear(old);
+    EXPECT_EQ(&file[0], old[0].base);
+    EXPECT_EQ(&file[SEGMENT_SIZE], old[1].base);
+    EXPECT_EQ(SEGMENT_SIZE, old[1].offset);
+    EXPECT_EQ(0U, segments.space(write_offset));
+}
+
+AP_GTEST_MAIN()
@@ -19,6 +19,17 @@
 #include <stdint.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Math/vectorN.h>
+#include <AP_HAL/AP_HAL_Boards.h>
+
+/*
+  allow EKF3 lanes to be run in parallel on their own threads on
+  boards with enough CPU cores. When enabled EKF3 has its own
+  per-thread copy of the scratch space below so lanes running
+  concurrently don't share it
+ */
+#ifndef HAL_NAVEKF3_LANE_THREADS
+#define HAL_NAVEKF3_LANE_THREADS (CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
 
 /*
   this declares a common parent class for AP_NavEKF2 and
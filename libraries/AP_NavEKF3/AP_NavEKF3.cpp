@@ -1,6 +1,7 @@
 #include <AP_HAL/AP_HAL.h>
 
 #include "AP_NavEKF3_core.h"
+#include "AP_NavEKF3_LaneThreads.h"
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Logger/AP_Logger.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
@@ -655,6 +656,16 @@ const AP_Param::GroupInfo NavEKF3::var_info[] = {
     // @RebootRequired: True
     AP_GROUPINFO("AFFINITY", 62, NavEKF3, _affinity, 0),
 
+#if HAL_NAVEKF3_LANE_THREADS
+    // @Param: LANE_THREADS
+    // @DisplayName: EKF3 parallel lane update
+    // @Description: When enabled on boards with 4 or more CPU cores, each EKF3 lane runs its prediction and fusion steps on its own CPU core. The lane outputs are the same as when the lanes are run one after the other.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("LANE_THREADS", 63, NavEKF3, _laneThreads, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -669,6 +680,16 @@ NavEKF3::NavEKF3()
  */
 void NavEKF3::check_log_write(void)
 {
+    // each lane records the sensors it has read, these are only
+    // collected here so lanes running in parallel don't share the flags
+    for (uint8_t i=0; i<num_cores; i++) {
+        bool log_compass, log_baro, log_imu;
+        core[i].getLogRequests(log_compass, log_baro, log_imu);
+        logging.log_compass |= log_compass;
+        logging.log_baro |= log_baro;
+        logging.log_imu |= log_imu;
+    }
+
     if (!have_ekf_logging()) {
         return;
     }
@@ -753,6 +774,19 @@ bool NavEKF3::InitialiseFilter(void)
         for (uint8_t i = 0; i < num_cores; i++) {
             new (&core[i]) NavEKF3_core(this);
         }
+
+#if HAL_NAVEKF3_LANE_THREADS
+        if (_laneThreads != 0 && num_cores > 1) {
+            laneThreads = new NavEKF3_LaneThreads();
+            if (laneThreads != nullptr &&
+                laneThreads->init(FUNCTOR_BIND_MEMBER(&NavEKF3::UpdateLane, void, uint8_t, bool), num_cores)) {
+                gcs().send_text(MAV_SEVERITY_INFO, "EKF3 running %u lanes in parallel", (unsigned)num_cores);
+            } else {
+                delete laneThreads;
+                laneThreads = nullptr;
+            }
+        }
+#endif
     }
 
     // Set up any cores that have been created
@@ -800,6 +834,43 @@ bool NavEKF3::InitialiseFilter(void)
     return ret;
 }
 
+/*
+  run the prediction and fusion steps for one lane. This may be called
+  from a lane worker thread so must only touch this lane's state
+ */
+void NavEKF3::UpdateLane(uint8_t i, bool predict)
+{
+#if HAL_NAVEKF3_LANE_THREADS
+    const uint32_t start_us = AP_HAL::micros();
+    core[i].UpdateFilter(predict);
+    const uint32_t elapsed_us = AP_HAL::micros() - start_us;
+
+    laneTiming[i].count++;
+    laneTiming[i].total_us += elapsed_us;
+    laneTiming[i].max_us = MAX(laneTiming[i].max_us, elapsed_us);
+#else
+    core[i].UpdateFilter(predict);
+#endif
+}
+
+#if HAL_NAVEKF3_LANE_THREADS
+/*
+  copy an origin set by a lane in the last update to the frontend. This
+  is done after all lanes have been updated whether or not they ran in
+  parallel, so the other lanes pick it up on their next update
+ */
+void NavEKF3::publishLaneOrigins(void)
+{
+    for (uint8_t i=0; i<num_cores; i++) {
+        Location loc;
+        if (core[i].getOriginToPublish(loc)) {
+            common_EKF_origin = loc;
+            common_origin_valid = true;
+        }
+    }
+}
+#endif // HAL_NAVEKF3_LANE_THREADS
+
 /*
   return true if a new core index has a better score than the current
   core
@@ -841,6 +912,25 @@ void NavEKF3::UpdateFilter(void)
     const AP_InertialSensor &ins = AP::ins();
 
     bool statePredictEnabled[num_cores];
+#if HAL_NAVEKF3_LANE_THREADS
+    // the lanes may run in parallel, so the prediction step is only
+    // suppressed based on the time used before the lanes start. The
+    // same rule is used when the lanes run one after the other so the
+    // lane outputs don't depend on whether they run in parallel
+    const bool overBudget = (AP_HAL::micros() - ins.get_last_update_usec()) > _frameTimeUsec/3;
+    for (uint8_t i=0; i<num_cores; i++) {
+        statePredictEnabled[i] = !(overBudget && core[i].getFramesSincePredict() < (_framesPerPrediction+3));
+    }
+    if (laneThreads != nullptr) {
+        laneThreads->run(statePredictEnabled);
+    } else {
+        for (uint8_t i=0; i<num_cores; i++) {
+            UpdateLane(i, statePredictEnabled[i]);
+        }
+    }
+
+    publishLaneOrigins();
+#else
     for (uint8_t i=0; i<num_cores; i++) {
         // if we have not overrun by more than 3 IMU frames, and we
         // have already used more than 1/3 of the CPU budget for this
@@ -852,8 +942,9 @@ void NavEKF3::UpdateFilter(void)
         } else {
             statePredictEnabled[i] = true;
         }
-        core[i].UpdateFilter(statePredictEnabled[i]);
+        UpdateLane(i, statePredictEnabled[i]);
     }
+#endif
 
     // If the current core selected has a bad error score or is unhealthy, switch to a healthy core with the lowest fault score
     // Don't start running the check until the primary core has started returned healthy for at least 10 seconds to avoid switching
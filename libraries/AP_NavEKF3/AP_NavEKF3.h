@@ -23,11 +23,13 @@
 #include <AP_Param/AP_Param.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_NavEKF/AP_Nav_Common.h>
+#include <AP_NavEKF/AP_NavEKF_core_common.h>
 #include <AP_Airspeed/AP_Airspeed.h>
 #include <AP_Compass/AP_Compass.h>
 #include <AP_Logger/LogStructure.h>
 
 class NavEKF3_core;
+class NavEKF3_LaneThreads;
 class AP_AHRS;
 
 class NavEKF3 {
@@ -510,6 +512,9 @@ private:
     AP_Int8 _gsfResetMaxCount;      // maximum number of times the EKF3 is allowed to reset it's yaw to the EKF-GSF estimate
     AP_Float _err_thresh;           // lanes have to be consistently better than the primary by at least this threshold to reduce their overall relativeCoreError
     AP_Int32 _affinity;             // bitmask of sensor affinity options
+#if HAL_NAVEKF3_LANE_THREADS
+    AP_Int8 _laneThreads;           // run lanes in parallel on their own CPU cores
+#endif
 
 // Possible values for _flowUse
 #define FLOW_USE_NONE    0
@@ -598,6 +603,38 @@ private:
     // origin set by one of the cores
     struct Location common_EKF_origin;
     bool common_origin_valid;
+
+#if HAL_NAVEKF3_LANE_THREADS
+    // per-lane execution time of the prediction and fusion steps, cleared each time it is logged
+    struct {
+        uint32_t count;
+        uint32_t total_us;
+        uint32_t max_us;
+    } laneTiming[MAX_EKF_CORES];
+    uint32_t lastLaneTimingLog_ms;
+
+    // worker threads used to update the lanes in parallel, nullptr when lanes run serially
+    NavEKF3_LaneThreads *laneThreads = nullptr;
+#endif
+
+    // true when the lanes are being updated in parallel
+    bool lanesInParallel(void) const {
+#if HAL_NAVEKF3_LANE_THREADS
+        return laneThreads != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    // run the prediction and fusion steps for one lane and record how long it took
+    void UpdateLane(uint8_t i, bool predict);
+
+#if HAL_NAVEKF3_LANE_THREADS
+    // copy any origin set by a lane during the last update to the frontend so the
+    // other lanes can use it. This is done after all lanes have been updated, so the
+    // result doesn't depend on the lane timing
+    void publishLaneOrigins(void);
+#endif
     
     // update the yaw reset data to capture changes due to a lane switch
     // new_primary - index of the ekf instance that we are about to switch to as the primary
@@ -630,5 +667,8 @@ private:
     void Log_Write_BodyOdom(uint64_t time_us) const;
     void Log_Write_State_Variances(uint64_t time_us) const;
     void Log_Write_GSF(uint8_t core, uint64_t time_us) const;
+#if HAL_NAVEKF3_LANE_THREADS
+    void Log_Write_LaneTiming(uint64_t time_us);
+#endif
 
 };
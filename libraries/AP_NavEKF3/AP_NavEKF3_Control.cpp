@@ -537,9 +537,36 @@ void NavEKF3_core::setOrigin(const Location &loc)
     validOrigin = true;
     gcs().send_text(MAV_SEVERITY_INFO, "EKF3 IMU%u origin set",(unsigned)imu_index);
 
-    // put origin in frontend as well to ensure it stays in sync between lanes
+    // put origin in frontend as well to ensure it stays in sync between lanes. When lanes
+    // may run in parallel this is left to the frontend once all lanes have been updated
+#if HAL_NAVEKF3_LANE_THREADS
+    originToPublish = true;
+#else
     frontend->common_EKF_origin = EKF_origin;
     frontend->common_origin_valid = true;
+#endif
+}
+
+// return true and the origin if it has been set since the last call
+bool NavEKF3_core::getOriginToPublish(Location &loc)
+{
+    if (!originToPublish) {
+        return false;
+    }
+    originToPublish = false;
+    loc = EKF_origin;
+    return true;
+}
+
+// return the sensors read since the last call that should be logged, and clear them
+void NavEKF3_core::getLogRequests(bool &log_compass, bool &log_baro, bool &log_imu)
+{
+    log_compass = logRequests.compass;
+    log_baro = logRequests.baro;
+    log_imu = logRequests.imu;
+    logRequests.compass = false;
+    logRequests.baro = false;
+    logRequests.imu = false;
 }
 
 // record a yaw reset event
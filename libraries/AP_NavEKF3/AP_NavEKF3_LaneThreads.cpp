@@ -0,0 +1,114 @@
+/*
+  run the EKF3 lanes in parallel, one lane per CPU core
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AP_NavEKF3_LaneThreads.h"
+
+#if HAL_NAVEKF3_LANE_THREADS
+
+#include <AP_HAL/AP_HAL.h>
+#include <sched.h>
+#include <unistd.h>
+
+extern const AP_HAL::HAL& hal;
+
+bool NavEKF3_LaneThreads::init(update_fn_t _update_fn, uint8_t _num_lanes)
+{
+    const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (_num_lanes < 2 || _num_lanes > MAX_EKF_CORES || num_cpus < min_cpus) {
+        return false;
+    }
+
+    update_fn = _update_fn;
+    num_lanes = _num_lanes;
+    state = State::STARTING;
+    num_exited = 0;
+
+    // the calling thread plus one worker per additional lane meet at each barrier
+    if (pthread_barrier_init(&start_barrier, nullptr, num_lanes) != 0) {
+        return false;
+    }
+    if (pthread_barrier_init(&done_barrier, nullptr, num_lanes) != 0) {
+        pthread_barrier_destroy(&start_barrier);
+        return false;
+    }
+
+    uint8_t num_started = 0;
+    for (uint8_t i=1; i<num_lanes; i++) {
+        Worker &worker = workers[i];
+        worker.owner = this;
+        worker.lane = i;
+        // keep lanes off CPU0, which usually services interrupts and the main loop
+        worker.cpu = num_cpus - i;
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND(&worker, &Worker::thread_main, void),
+                                          "EKF3lane", 8192, AP_HAL::Scheduler::PRIORITY_MAIN, 0)) {
+            break;
+        }
+        num_started++;
+    }
+
+    if (num_started < num_lanes - 1) {
+        // tell the workers that did start to exit, and wait for them
+        // so the caller can free this object
+        state = State::FAILED;
+        while (num_exited < num_started) {
+            hal.scheduler->delay_microseconds(1000);
+        }
+        pthread_barrier_destroy(&start_barrier);
+        pthread_barrier_destroy(&done_barrier);
+        return false;
+    }
+
+    state = State::RUNNING;
+    return true;
+}
+
+/*
+  update all lanes, returning when every lane has finished
+ */
+void NavEKF3_LaneThreads::run(const bool *predict)
+{
+    memcpy(lane_predict, predict, sizeof(lane_predict[0]) * num_lanes);
+
+    pthread_barrier_wait(&start_barrier);
+    update_fn(0, lane_predict[0]);
+    pthread_barrier_wait(&done_barrier);
+}
+
+void NavEKF3_LaneThreads::Worker::thread_main(void)
+{
+    while (owner->state == State::STARTING) {
+        hal.scheduler->delay_microseconds(1000);
+    }
+    if (owner->state == State::FAILED) {
+        owner->num_exited++;
+        return;
+    }
+
+    // if pinning fails the lane still runs correctly, it just may
+    // share a CPU with another lane
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+
+    while (true) {
+        pthread_barrier_wait(&owner->start_barrier);
+        owner->update_fn(lane, owner->lane_predict[lane]);
+        pthread_barrier_wait(&owner->done_barrier);
+    }
+}
+
+#endif // HAL_NAVEKF3_LANE_THREADS
@@ -0,0 +1,77 @@
+/*
+  run the EKF3 lanes in parallel, one lane per CPU core
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AP_NavEKF3.h"
+
+#if HAL_NAVEKF3_LANE_THREADS
+
+#include <atomic>
+#include <pthread.h>
+
+/*
+  Lane 0 is run by the calling thread, every other lane has a worker
+  thread pinned to its own CPU. run() releases all lanes together and
+  returns once every lane has finished, so the caller sees exactly the
+  same lane state it would have seen running the lanes one after the
+  other.
+ */
+class NavEKF3_LaneThreads {
+public:
+    // called to update a lane, with the lane index and whether the
+    // prediction step is enabled
+    FUNCTOR_TYPEDEF(update_fn_t, void, uint8_t, bool);
+
+    // start the worker threads. Returns false if the board does not
+    // have enough CPUs or the threads could not be created, in which
+    // case the lanes must be run serially and this object may be
+    // deleted
+    bool init(update_fn_t update_fn, uint8_t num_lanes);
+
+    // update all lanes in parallel, predict[] is indexed by lane
+    void run(const bool *predict);
+
+private:
+    // minimum number of online CPUs before we run lanes in parallel
+    static const uint8_t min_cpus = 4;
+
+    struct Worker {
+        NavEKF3_LaneThreads *owner;
+        uint8_t lane;
+        int cpu;
+        void thread_main(void);
+    } workers[MAX_EKF_CORES];
+
+    // workers wait for init() to finish starting all of them before
+    // using the barriers, and exit if it fails
+    enum class State : uint8_t {
+        STARTING,
+        RUNNING,
+        FAILED,
+    };
+    std::atomic<State> state;
+    std::atomic<uint8_t> num_exited;
+
+    update_fn_t update_fn;
+    uint8_t num_lanes;
+    bool lane_predict[MAX_EKF_CORES];
+
+    pthread_barrier_t start_barrier;
+    pthread_barrier_t done_barrier;
+};
+
+#endif // HAL_NAVEKF3_LANE_THREADS
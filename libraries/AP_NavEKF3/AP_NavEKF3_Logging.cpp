@@ -359,7 +359,38 @@ void NavEKF3::Log_Write()
             Log_EKF_Timing("XKT", i, time_us, timing);
         }
     }
+
+#if HAL_NAVEKF3_LANE_THREADS
+    // log lane update timing every second
+    Log_Write_LaneTiming(time_us);
+#endif
+}
+
+#if HAL_NAVEKF3_LANE_THREADS
+void NavEKF3::Log_Write_LaneTiming(uint64_t time_us)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - lastLaneTimingLog_ms < 1000) {
+        return;
+    }
+    lastLaneTimingLog_ms = now_ms;
+
+    const bool parallel = lanesInParallel();
+    for (uint8_t i=0; i<activeCores(); i++) {
+        const struct log_XKLT pkt{
+            LOG_PACKET_HEADER_INIT(LOG_XKLT_MSG),
+            time_us  : time_us,
+            core     : i,
+            parallel : parallel,
+            count    : (uint16_t)MIN(laneTiming[i].count, UINT16_MAX),
+            avg_us   : laneTiming[i].count > 0 ? laneTiming[i].total_us / laneTiming[i].count : 0,
+            max_us   : laneTiming[i].max_us
+        };
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        memset(&laneTiming[i], 0, sizeof(laneTiming[i]));
+    }
 }
+#endif // HAL_NAVEKF3_LANE_THREADS
 
 void NavEKF3::Log_Write_GSF(uint8_t _core, uint64_t time_us) const
 {
@@ -90,6 +90,8 @@ class AP_AHRS;
 
 class NavEKF3_core : public NavEKF_core_common
 {
+    friend class NavEKF3_core_Benchmark;
+
 public:
     // Constructor
     NavEKF3_core(class NavEKF3 *_frontend);
@@ -421,6 +423,13 @@ public:
     // get timing statistics structure
     void getTimingStatistics(struct ekf_timing &timing);
 
+    // return true and the origin if this lane has set an origin that has not yet been
+    // shared with the other lanes
+    bool getOriginToPublish(Location &loc);
+
+    // return the sensors read since the last call that should be logged, and clear them
+    void getLogRequests(bool &log_compass, bool &log_baro, bool &log_imu);
+
     // values for EK3_MAG_CAL
     enum class MagCal {
         WHEN_FLYING = 0,
@@ -488,6 +497,7 @@ private:
     typedef VectorN<ftype,24> Vector24;
     typedef VectorN<ftype,25> Vector25;
     typedef VectorN<ftype,31> Vector31;
+    typedef VectorN<ftype,54> Vector54;
     typedef VectorN<VectorN<ftype,3>,3> Matrix3;
     typedef VectorN<VectorN<ftype,24>,24> Matrix24;
     typedef VectorN<VectorN<ftype,34>,50> Matrix34_50;
@@ -511,12 +521,25 @@ private:
     typedef ftype Vector23[23];
     typedef ftype Vector24[24];
     typedef ftype Vector25[25];
+    typedef ftype Vector54[54];
     typedef ftype Matrix3[3][3];
     typedef ftype Matrix24[24][24];
     typedef ftype Matrix34_50[34][50];
     typedef uint32_t Vector_u32_50[50];
 #endif
 
+#if HAL_NAVEKF3_LANE_THREADS
+    // lanes run in parallel can't share the scratch space in
+    // NavEKF_core_common, so these per-thread copies hide it
+    static thread_local Matrix24 KH;
+    static thread_local Matrix24 KHP;
+    static thread_local Matrix24 nextP;
+    static thread_local Vector28 Kfusion;
+
+    // fill the per-thread scratch variables with NaN on SITL
+    void fill_scratch_variables(void);
+#endif
+
     const AP_AHRS *_ahrs;
 
     // the states are available in two forms, either as a Vector24, or
@@ -1095,6 +1118,14 @@ private:
     bool gpsNotAvailable;           // bool true when valid GPS data is not available
     struct Location EKF_origin;     // LLH origin of the NED axis system
     bool validOrigin;               // true when the EKF origin is valid
+    bool originToPublish;           // true when the origin has been set and not yet copied to the frontend
+
+    // sensors read by this lane that the frontend should log
+    struct {
+        bool compass:1;
+        bool baro:1;
+        bool imu:1;
+    } logRequests;
     float gpsSpdAccuracy;           // estimated speed accuracy in m/s returned by the GPS receiver
     float gpsPosAccuracy;           // estimated position accuracy in m returned by the GPS receiver
     float gpsHgtAccuracy;           // estimated height accuracy in m returned by the GPS receiver
@@ -0,0 +1,74 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_NavEKF3/AP_NavEKF3.h>
+#include <AP_NavEKF3/AP_NavEKF3_core.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  cost of one covariance prediction for a 400Hz EKF in level flight,
+  the argument is the number of states, as set by stateIndexLim
+ */
+class NavEKF3_core_Benchmark {
+public:
+    NavEKF3_core_Benchmark(uint8_t state_index_lim) {
+        // the core relies on zeroed memory
+        core = new NavEKF3_core(&frontend);
+        core->stateIndexLim = state_index_lim;
+        core->inhibitDelVelBiasStates = state_index_lim < 15;
+        core->inhibitMagStates = state_index_lim < 21;
+        core->lastInhibitMagStates = core->inhibitMagStates;
+        core->inhibitWindStates = state_index_lim < 23;
+
+        const float dt = 0.0025f;
+        core->dtEkfAvg = dt;
+        core->dtIMUavg = dt;
+        core->imuDataDelayed.delAngDT = dt;
+        core->imuDataDelayed.delVelDT = dt;
+        core->imuDataDelayed.delAng = Vector3f(0.01f, -0.02f, 0.005f) * dt;
+        core->imuDataDelayed.delVel = Vector3f(0.1f, 0.2f, -GRAVITY_MSS) * dt;
+        core->stateStruct.quat.from_euler(0.1f, -0.05f, 1.0f);
+
+        // a well conditioned covariance with some correlation between states
+        for (uint8_t i = 0; i < 24; i++) {
+            for (uint8_t j = 0; j < 24; j++) {
+                P0[i][j] = (i == j) ? 0.1f + 0.01f * i : 1.0e-4f / (1 + i + j);
+            }
+        }
+    }
+
+    ~NavEKF3_core_Benchmark() {
+        delete core;
+    }
+
+    void predict() {
+        // start from the same covariance each time so it doesn't grow
+        for (uint8_t i = 0; i < 24; i++) {
+            for (uint8_t j = 0; j < 24; j++) {
+                core->P[i][j] = P0[i][j];
+            }
+        }
+        core->CovariancePrediction();
+        gbenchmark_escape(&core->P);
+    }
+
+private:
+    NavEKF3 frontend;
+    NavEKF3_core *core;
+    float P0[24][24];
+};
+
+static void BM_CovariancePrediction(benchmark::State& state)
+{
+    NavEKF3_core_Benchmark *ekf = new NavEKF3_core_Benchmark(state.range(0));
+
+    while (state.KeepRunning()) {
+        ekf->predict();
+    }
+    delete ekf;
+}
+
+BENCHMARK(BM_CovariancePrediction)->Arg(12)->Arg(15)->Arg(21)->Arg(23);
+
+BENCHMARK_MAIN();
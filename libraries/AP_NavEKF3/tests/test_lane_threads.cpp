@@ -0,0 +1,77 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_NavEKF3/AP_NavEKF3_LaneThreads.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_NAVEKF3_LANE_THREADS
+
+#include <atomic>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+  records each lane update, standing in for NavEKF3::UpdateLane()
+ */
+class LaneRecorder {
+public:
+    void update(uint8_t lane, bool predict) {
+        // give the other lanes a chance to run at the same time
+        usleep(100);
+        updates[lane]++;
+        predicted[lane] = predict;
+        thread[lane] = pthread_self();
+    }
+
+    std::atomic<uint32_t> updates[MAX_EKF_CORES];
+    bool predicted[MAX_EKF_CORES];
+    pthread_t thread[MAX_EKF_CORES];
+};
+
+static bool enough_cpus(void)
+{
+    return sysconf(_SC_NPROCESSORS_ONLN) >= 4;
+}
+
+TEST(NavEKF3_LaneThreads, RejectsSingleLane)
+{
+    NavEKF3_LaneThreads lanes;
+    LaneRecorder recorder;
+    EXPECT_FALSE(lanes.init(FUNCTOR_BIND(&recorder, &LaneRecorder::update, void, uint8_t, bool), 1));
+    EXPECT_FALSE(lanes.init(FUNCTOR_BIND(&recorder, &LaneRecorder::update, void, uint8_t, bool), MAX_EKF_CORES+1));
+}
+
+TEST(NavEKF3_LaneThreads, EachLaneOncePerRun)
+{
+    // the workers are never stopped, so neither object is freed
+    LaneRecorder *recorder = new LaneRecorder();
+    NavEKF3_LaneThreads *lanes = new NavEKF3_LaneThreads();
+    const uint8_t num_lanes = 3;
+
+    if (!lanes->init(FUNCTOR_BIND(recorder, &LaneRecorder::update, void, uint8_t, bool), num_lanes)) {
+        // only boards with enough CPUs run lanes in parallel
+        EXPECT_FALSE(enough_cpus());
+        return;
+    }
+
+    for (uint32_t run = 1; run <= 100; run++) {
+        const bool predict[num_lanes] { true, (run & 1) != 0, (run & 2) != 0 };
+        lanes->run(predict);
+        // every lane has finished by the time run() returns
+        for (uint8_t i = 0; i < num_lanes; i++) {
+            EXPECT_EQ(run, recorder->updates[i].load());
+            EXPECT_EQ(predict[i], recorder->predicted[i]);
+        }
+    }
+
+    // lane 0 runs on the calling thread, the others on their own threads
+    EXPECT_TRUE(pthread_equal(pthread_self(), recorder->thread[0]));
+    EXPECT_FALSE(pthread_equal(recorder->thread[0], recorder->thread[1]));
+    EXPECT_FALSE(pthread_equal(recorder->thread[1], recorder->thread[2]));
+    EXPECT_FALSE(pthread_equal(recorder->thread[0], recorder->thread[2]));
+}
+
+#endif // HAL_NAVEKF3_LANE_THREADS
+
+AP_GTEST_MAIN()
@@ -71,6 +71,18 @@ AP_Param *AP_Param::_singleton;
 // number of rows in the _var_info[] table
 uint16_t AP_Param::_num_vars;
 
+// top level keys in sorted order
+uint16_t *AP_Param::_key_index;
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+// index of parameter names
+struct AP_Param::name_index_entry *AP_Param::_name_index;
+uint16_t *AP_Param::_name_index_sorted;
+uint16_t AP_Param::_name_index_count;
+uint16_t AP_Param::_name_index_marker;
+HAL_Semaphore AP_Param::_name_index_sem;
+#endif
+
 // cached parameter count
 uint16_t AP_Param::_parameter_count;
 uint16_t AP_Param::_count_marker;
@@ -333,6 +345,63 @@ bool AP_Param::setup(void)
         erase_all();
     }
 
+    build_key_index();
+
+    return true;
+}
+
+/*
+  build the index of top level keys used by find_by_header(). The
+  keys are unique, which is checked by check_var_info()
+ */
+void AP_Param::build_key_index(void)
+{
+    if (_key_index != nullptr || _num_vars == 0) {
+        return;
+    }
+    _key_index = new uint16_t[_num_vars];
+    if (_key_index == nullptr) {
+        return;
+    }
+    // insertion sort, as the table is usually close to key order
+    for (uint16_t i=0; i<_num_vars; i++) {
+        uint16_t j = i;
+        while (j > 0 && _var_info[_key_index[j-1]].key > _var_info[i].key) {
+            _key_index[j] = _key_index[j-1];
+            j--;
+        }
+        _key_index[j] = i;
+    }
+}
+
+/*
+  find the _var_info[] index of a top level key
+ */
+bool AP_Param::find_vindex_by_key(uint16_t key, uint16_t &vindex)
+{
+    if (_key_index == nullptr) {
+        for (uint16_t i=0; i<_num_vars; i++) {
+            if (_var_info[i].key == key) {
+                vindex = i;
+                return true;
+            }
+        }
+        return false;
+    }
+    uint16_t lo = 0;
+    uint16_t hi = _num_vars;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (_var_info[_key_index[mid]].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == _num_vars || _var_info[_key_index[lo]].key != key) {
+        return false;
+    }
+    vindex = _key_index[lo];
     return true;
 }
 
@@ -449,30 +518,27 @@ const struct AP_Param::Info *AP_Param::find_by_header_group(struct Param_header
 // return the Info structure and a pointer to the variables storage
 const struct AP_Param::Info *AP_Param::find_by_header(struct Param_header phdr, void **ptr)
 {
-    // loop over all named variables
-    for (uint16_t i=0; i<_num_vars; i++) {
-        uint8_t type = _var_info[i].type;
-        uint16_t key = _var_info[i].key;
-        if (key != get_key(phdr)) {
-            // not the right key
-            continue;
-        }
-        if (type == AP_PARAM_GROUP) {
-            const struct GroupInfo *group_info = get_group_info(_var_info[i]);
-            if (group_info == nullptr) {
-                continue;
-            }
-            return find_by_header_group(phdr, ptr, i, group_info, 0, 0, 0);
+    uint16_t i;
+    if (!find_vindex_by_key(get_key(phdr), i)) {
+        // not a known key
+        return nullptr;
+    }
+    uint8_t type = _var_info[i].type;
+    if (type == AP_PARAM_GROUP) {
+        const struct GroupInfo *group_info = get_group_info(_var_info[i]);
+        if (group_info == nullptr) {
+            return nullptr;
         }
-        if (type == phdr.type) {
-            // found it
-            ptrdiff_t base;
-            if (!get_base(_var_info[i], base)) {
-                return nullptr;
-            }
-            *ptr = (void*)base;
-            return &_var_info[i];
+        return find_by_header_group(phdr, ptr, i, group_info, 0, 0, 0);
+    }
+    if (type == phdr.type) {
+        // found it
+        ptrdiff_t base;
+        if (!get_base(_var_info[i], base)) {
+            return nullptr;
         }
+        *ptr = (void*)base;
+        return &_var_info[i];
     }
     return nullptr;
 }
@@ -849,10 +915,141 @@ AP_Param::find_group(const char *name, uint16_t vindex, ptrdiff_t group_offset,
 }
 
 
+#if AP_PARAM_NAME_INDEX_ENABLED
+/*
+  rebuild the name index if parameters have been added or hidden
+  since it was built. Must be called with _name_index_sem held
+ */
+bool AP_Param::update_name_index(void)
+{
+    const uint16_t marker = _count_marker;
+    if (_name_index != nullptr && _name_index_marker == marker) {
+        return true;
+    }
+
+    delete[] _name_index;
+    delete[] _name_index_sorted;
+    _name_index_count = 0;
+
+    const uint16_t count = count_parameters();
+    _name_index = new name_index_entry[count];
+    _name_index_sorted = new uint16_t[count];
+    if (_name_index == nullptr || _name_index_sorted == nullptr) {
+        delete[] _name_index;
+        delete[] _name_index_sorted;
+        _name_index = nullptr;
+        _name_index_sorted = nullptr;
+        return false;
+    }
+
+    ParamToken token;
+    enum ap_var_type type;
+    uint16_t n = 0;
+    for (AP_Param *ap = first(&token, &type);
+         ap != nullptr && n < count;
+         ap = next_scalar(&token, &type)) {
+        struct name_index_entry &e = _name_index[n];
+        e.ptr = ap;
+        e.token = token;
+        e.type = type;
+        ap->copy_name_token(token, e.name, AP_MAX_NAME_SIZE, true);
+        e.name[AP_MAX_NAME_SIZE] = 0;
+
+        // insert after any equal names, so lookups find the first
+        // one in table order, as a linear search would. Names are
+        // compared case sensitively, as group prefixes are in
+        // find_in_tree(); other spellings fall back to the tree
+        uint16_t lo = 0;
+        uint16_t hi = n;
+        while (lo < hi) {
+            const uint16_t mid = (lo + hi) / 2;
+            if (strncmp(_name_index[_name_index_sorted[mid]].name, e.name, AP_MAX_NAME_SIZE) <= 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        memmove(&_name_index_sorted[lo+1], &_name_index_sorted[lo], (n-lo)*sizeof(_name_index_sorted[0]));
+        _name_index_sorted[lo] = n;
+        n++;
+    }
+    _name_index_count = n;
+    _name_index_marker = marker;
+    return true;
+}
+
+/*
+  find a scalar parameter by name in the name index. Must be called
+  with _name_index_sem held. Returns nullptr if not found
+ */
+const struct AP_Param::name_index_entry *AP_Param::name_index_find(const char *name)
+{
+    uint16_t lo = 0;
+    uint16_t hi = _name_index_count;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (strncmp(_name_index[_name_index_sorted[mid]].name, name, AP_MAX_NAME_SIZE) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == _name_index_count) {
+        return nullptr;
+    }
+    const struct name_index_entry &e = _name_index[_name_index_sorted[lo]];
+    if (strncmp(e.name, name, AP_MAX_NAME_SIZE) != 0) {
+        return nullptr;
+    }
+    return &e;
+}
+#endif // AP_PARAM_NAME_INDEX_ENABLED
+
 // Find a variable by name.
 //
 AP_Param *
 AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
+{
+#if AP_PARAM_NAME_INDEX_ENABLED
+    if (strnlen(name, AP_MAX_NAME_SIZE+1) <= AP_MAX_NAME_SIZE) {
+        struct name_index_entry e;
+        bool found = false;
+        {
+            WITH_SEMAPHORE(_name_index_sem);
+            if (update_name_index()) {
+                const struct name_index_entry *ep = name_index_find(name);
+                if (ep != nullptr) {
+                    e = *ep;
+                    found = true;
+                }
+            }
+        }
+        if (found) {
+            *ptype = (enum ap_var_type)e.type;
+            if (flags != nullptr) {
+                uint32_t group_element = 0;
+                const struct GroupInfo *ginfo = nullptr;
+                struct GroupNesting group_nesting {};
+                uint8_t idx;
+                const struct Info *info = e.ptr->find_var_info_token(e.token, &group_element, ginfo, group_nesting, &idx);
+                if (info != nullptr && ginfo != nullptr) {
+                    *flags = ginfo->flags;
+                }
+            }
+            return e.ptr;
+        }
+        // parameters hidden from next_scalar(), such as those in
+        // disabled groups, fall back to searching the tree
+    }
+#endif
+
+    return find_in_tree(name, ptype, flags);
+}
+
+// Find a variable by name by searching the var_info tree
+//
+AP_Param *
+AP_Param::find_in_tree(const char *name, enum ap_var_type *ptype, uint16_t *flags)
 {
     for (uint16_t i=0; i<_num_vars; i++) {
         uint8_t type = _var_info[i].type;
@@ -894,11 +1091,28 @@ AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
     return nullptr;
 }
 
-// Find a variable by index. Note that this is quite slow.
+// Find a variable by index. Note that this is quite slow without
+// the name index.
 //
 AP_Param *
 AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token)
 {
+#if AP_PARAM_NAME_INDEX_ENABLED
+    {
+        WITH_SEMAPHORE(_name_index_sem);
+        if (update_name_index()) {
+            if (idx >= _name_index_count) {
+                return nullptr;
+            }
+            const struct name_index_entry &e = _name_index[idx];
+            *token = e.token;
+            if (ptype != nullptr) {
+                *ptype = (enum ap_var_type)e.type;
+            }
+            return e.ptr;
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count=0;
     for (ap=AP_Param::first(token, ptype);
@@ -912,6 +1126,21 @@ AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token
 // by-name equivalent of find_by_index()
 AP_Param* AP_Param::find_by_name(const char* name, enum ap_var_type *ptype, ParamToken *token)
 {
+#if AP_PARAM_NAME_INDEX_ENABLED
+    {
+        WITH_SEMAPHORE(_name_index_sem);
+        if (update_name_index()) {
+            const struct name_index_entry *e = name_index_find(name);
+            if (e != nullptr) {
+                *token = e->token;
+                *ptype = (enum ap_var_type)e->type;
+                return e->ptr;
+            }
+            // the index is case sensitive, so other spellings fall
+            // back to the scan
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count = 0;
     for (ap = AP_Param::first(token, ptype);
@@ -1439,6 +1668,10 @@ bool AP_Param::load_all()
         if (is_sentinal(phdr)) {
             // we've reached the sentinal
             sentinal_offset = ofs;
+#if AP_PARAM_NAME_INDEX_ENABLED
+            WITH_SEMAPHORE(_name_index_sem);
+            update_name_index();
+#endif
             return true;
         }
 
@@ -1974,7 +2207,11 @@ void AP_Param::set_float(float value, enum ap_var_type var_type)
         if (value < 0) rounding_addition = -rounding_addition;
         float v = value+rounding_addition;
         v = constrain_float(v, -128, 127);
+        const int8_t old_value = ((AP_Int8 *)this)->get();
         ((AP_Int8 *)this)->set(v);
+        if (((AP_Int8 *)this)->get() != old_value) {
+            invalidate_count_if_enable();
+        }
     }
 }
 
@@ -2388,6 +2625,23 @@ void AP_Param::invalidate_count(void)
     _count_marker++;
 }
 
+/*
+  invalidate the parameter count cache, and with it the name index,
+  when an enable parameter changes, as the parameters it enables may
+  be shown or hidden
+ */
+void AP_Param::invalidate_count_if_enable(void) const
+{
+    uint32_t group_element = 0;
+    const struct GroupInfo *ginfo;
+    struct GroupNesting group_nesting {};
+    uint8_t idx;
+    const struct Info *info = find_var_info(&group_element, ginfo, group_nesting, &idx);
+    if (info != nullptr && ginfo != nullptr && (ginfo->flags & AP_PARAM_FLAG_ENABLE)) {
+        invalidate_count();
+    }
+}
+
 /*
   set a default value by name
  */
@@ -2440,13 +2694,18 @@ void AP_Param::set_defaults_from_table(const struct defaults_table_struct *table
 bool AP_Param::set_by_name(const char *name, float value)
 {
     enum ap_var_type vtype;
-    AP_Param *vp = find(name, &vtype);
+    uint16_t flags = 0;
+    AP_Param *vp = find(name, &vtype, &flags);
     if (vp == nullptr) {
         return false;
     }
     switch (vtype) {
     case AP_PARAM_INT8:
         ((AP_Int8 *)vp)->set(value);
+        if (flags & AP_PARAM_FLAG_ENABLE) {
+            // the parameters this enables may be shown or hidden
+            invalidate_count();
+        }
         return true;
     case AP_PARAM_INT16:
         ((AP_Int16 *)vp)->set(value);
@@ -2503,13 +2762,18 @@ bool AP_Param::get(const char *name, float &value)
 bool AP_Param::set_and_save_by_name(const char *name, float value)
 {
     enum ap_var_type vtype;
-    AP_Param *vp = find(name, &vtype);
+    uint16_t flags = 0;
+    AP_Param *vp = find(name, &vtype, &flags);
     if (vp == nullptr) {
         return false;
     }
     switch (vtype) {
     case AP_PARAM_INT8:
         ((AP_Int8 *)vp)->set_and_save(value);
+        if (flags & AP_PARAM_FLAG_ENABLE) {
+            // don't wait for the IO thread to save it
+            invalidate_count();
+        }
         return true;
     case AP_PARAM_INT16:
         ((AP_Int16 *)vp)->set_and_save(value);
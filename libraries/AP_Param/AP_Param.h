@@ -35,6 +35,15 @@
 // optionally enable debug code for dumping keys
 #define AP_PARAM_KEY_DUMP 0
 
+/*
+  enable a sorted index of parameter names for find(), find_by_name()
+  and find_by_index(). This takes about 32 bytes per parameter so is
+  only enabled by default on boards with plenty of memory
+ */
+#ifndef AP_PARAM_NAME_INDEX_ENABLED
+#define AP_PARAM_NAME_INDEX_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 /*
   maximum size of embedded parameter file
  */
@@ -144,6 +153,8 @@ enum ap_var_type {
 ///
 class AP_Param
 {
+    friend class AP_Param_Test;
+
 public:
     // the Info and GroupInfo structures are passed by the main
     // program in setup() to give information on how variables are
@@ -603,6 +614,12 @@ private:
                                     const struct GroupInfo *   &group_ret,
                                     struct GroupNesting        &group_nesting,
                                     uint8_t *                   idx) const;
+    // find() without the name index
+    static AP_Param *           find_in_tree(const char *name, enum ap_var_type *ptype, uint16_t *flags);
+
+    // invalidate the parameter count if this is an enable parameter
+    void                        invalidate_count_if_enable(void) const;
+
     const struct Info *         find_var_info(
                                     uint32_t *                group_element,
                                     const struct GroupInfo *  &group_ret,
@@ -679,6 +696,35 @@ private:
 
     static StorageAccess        _storage;
     static uint16_t             _num_vars;
+
+    // top level _var_info[] indexes sorted by key, for find_by_header()
+    static uint16_t *           _key_index;
+    static void                 build_key_index(void);
+    static bool                 find_vindex_by_key(uint16_t key, uint16_t &vindex);
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+    /*
+      index of the scalar parameters in first()/next_scalar() order,
+      with a second array giving the order sorted by name. It is
+      rebuilt when the parameter count is invalidated, which happens
+      when objects are loaded with load_object_from_eeprom() and when
+      enable parameters change
+    */
+    struct name_index_entry {
+        AP_Param *ptr;
+        ParamToken token;
+        uint8_t type;
+        char name[AP_MAX_NAME_SIZE+1];
+    };
+    static struct name_index_entry *_name_index;
+    static uint16_t *           _name_index_sorted;
+    static uint16_t             _name_index_count;
+    static uint16_t             _name_index_marker;
+    static HAL_Semaphore        _name_index_sem;
+    static bool                 update_name_index(void);
+    static const struct name_index_entry *name_index_find(const char *name);
+#endif
+
     static uint16_t             _parameter_count;
     static uint16_t             _count_marker;
     static uint16_t             _count_marker_done;
@@ -0,0 +1,151 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  a small parameter tree with an enable parameter, a vector and top
+  level scalars sharing a prefix with a group
+ */
+class IndexTestGroup {
+public:
+    IndexTestGroup() {
+        AP_Param::setup_object_defaults(this, var_info);
+    }
+    static const struct AP_Param::GroupInfo var_info[];
+
+    AP_Int8 enable;
+    AP_Float gain;
+    AP_Int16 rate;
+    AP_Vector3f offset;
+};
+
+const AP_Param::GroupInfo IndexTestGroup::var_info[] = {
+    AP_GROUPINFO_FLAGS("ENABLE", 0, IndexTestGroup, enable, 0, AP_PARAM_FLAG_ENABLE),
+    AP_GROUPINFO("GAIN", 1, IndexTestGroup, gain, 1.5f),
+    AP_GROUPINFO("RATE", 2, IndexTestGroup, rate, 50),
+    AP_GROUPINFO("OFS", 3, IndexTestGroup, offset, 0),
+    AP_GROUPEND
+};
+
+static IndexTestGroup group1;
+static IndexTestGroup group2;
+static AP_Int16 top_rate;
+static AP_Float top_gain;
+
+static const AP_Param::Info var_info[] = {
+    { AP_PARAM_INT16, "TST_RATE", 0, &top_rate, {def_value : 10} },
+    { AP_PARAM_GROUP, "TST_", 1, &group1, {group_info : IndexTestGroup::var_info} },
+    { AP_PARAM_GROUP, "TST2_", 2, &group2, {group_info : IndexTestGroup::var_info} },
+    { AP_PARAM_FLOAT, "TST_GAIN2", 3, &top_gain, {def_value : 0.5f} },
+    AP_VAREND
+};
+
+static AP_Param param_loader(var_info);
+
+const struct AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+GCS_Dummy _gcs;
+
+class AP_Param_Test {
+public:
+    static AP_Param *find_in_tree(const char *name, enum ap_var_type *ptype, uint16_t *flags) {
+        return AP_Param::find_in_tree(name, ptype, flags);
+    }
+};
+
+static const char *names[] {
+    "TST_RATE",
+    "TST_ENABLE",
+    "TST_GAIN",
+    "TST_RATE",
+    "TST_OFS",
+    "TST_OFS_X",
+    "TST_OFS_Z",
+    "TST2_ENABLE",
+    "TST2_GAIN",
+    "TST2_OFS_Y",
+    "TST_GAIN2",
+    // other spellings
+    "tst_rate",
+    "TST_gain",
+    "tst_GAIN",
+    "TST2_ofs_x",
+    // not parameters
+    "TST_",
+    "TST_GAIN3",
+    "TST3_GAIN",
+    "",
+    "TST_OFS_W",
+};
+
+/*
+  find() through the name index must give the same answer as
+  searching the tree for every name
+ */
+static void check_find_matches_tree(void)
+{
+    for (const char *name : names) {
+        enum ap_var_type type1 = AP_PARAM_NONE;
+        enum ap_var_type type2 = AP_PARAM_NONE;
+        uint16_t flags1 = 0xFFFF;
+        uint16_t flags2 = 0xFFFF;
+        AP_Param *indexed = AP_Param::find(name, &type1, &flags1);
+        AP_Param *tree = AP_Param_Test::find_in_tree(name, &type2, &flags2);
+        EXPECT_EQ(tree, indexed) << name;
+        if (tree != nullptr) {
+            EXPECT_EQ(type2, type1) << name;
+            EXPECT_EQ(flags2, flags1) << name;
+        }
+    }
+}
+
+TEST(AP_Param, NameIndexMatchesTree)
+{
+    group1.enable.set(1);
+    group2.enable.set(1);
+    AP_Param::invalidate_count();
+    check_find_matches_tree();
+
+    // disabled groups are hidden from the index
+    group2.enable.set(0);
+    AP_Param::invalidate_count();
+    check_find_matches_tree();
+}
+
+TEST(AP_Param, FindByIndexFollowsEnable)
+{
+    ASSERT_TRUE(AP_Param::set_by_name("TST_ENABLE", 1));
+    ASSERT_TRUE(AP_Param::set_by_name("TST2_ENABLE", 0));
+    const uint16_t count = AP_Param::count_parameters();
+
+    // setting an enable by name, as scripting does, must update the
+    // index without anything being saved
+    ASSERT_TRUE(AP_Param::set_by_name("TST2_ENABLE", 1));
+    EXPECT_GT(AP_Param::count_parameters(), count);
+
+    AP_Param::ParamToken token;
+    enum ap_var_type type;
+    AP_Param *ap = AP_Param::find_by_name("TST2_GAIN", &type, &token);
+    EXPECT_EQ(&group2.gain, ap);
+
+    // every index finds the parameter the scan would
+    uint16_t idx = 0;
+    AP_Param::ParamToken scan_token;
+    enum ap_var_type scan_type;
+    for (AP_Param *scan = AP_Param::first(&scan_token, &scan_type);
+         scan != nullptr;
+         scan = AP_Param::next_scalar(&scan_token, &scan_type), idx++) {
+        EXPECT_EQ(scan, AP_Param::find_by_index(idx, &type, &token));
+        EXPECT_EQ(scan_type, type);
+    }
+    EXPECT_EQ(nullptr, AP_Param::find_by_index(idx, &type, &token));
+
+    check_find_matches_tree();
+}
+
+AP_GTEST_MAIN()
@@ -60,7 +60,7 @@ const AP_Param::GroupInfo AP_Scheduler::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Scheduling options
     // @Description: This controls optional aspects of the scheduler.
-    // @Bitmask: 0:Enable per-task perf info
+    // @Bitmask: 0:Enable per-task perf info,1:Enable per-task latency histograms,2:Earliest deadline first scheduling
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Scheduler, _options, 0),
 
@@ -124,6 +124,9 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks, uint
     if (_options & uint8_t(Options::RECORD_TASK_INFO)) {
         perf_info.allocate_task_info(_num_tasks);
     }
+    if (_options & uint8_t(Options::RECORD_TASK_HISTOGRAMS)) {
+        perf_info.allocate_task_histograms(_num_tasks);
+    }
 
     _log_performance_bit = log_performance_bit;
 }
@@ -146,15 +149,64 @@ static void fill_nanf_stack(void)
 }
 #endif
 
+// return the number of ticks between runs of a task
+uint16_t AP_Scheduler::task_interval_ticks(const Task &task) const
+{
+    // we allow 0 to mean loop rate
+    uint32_t interval_ticks = (is_zero(task.rate_hz) ? 1 : _loop_rate_hz / task.rate_hz);
+    if (interval_ticks < 1) {
+        interval_ticks = 1;
+    }
+    return interval_ticks;
+}
+
+/*
+  run a single task, returning the time it took in microseconds
+ */
+uint32_t AP_Scheduler::run_task(uint8_t i, const Task &task, uint16_t interval_ticks, uint32_t now)
+{
+    _task_time_allowed = task.max_time_micros;
+    _task_time_started = now;
+    hal.util->persistent_data.scheduler_task = i;
+    if (_debug > 1 && _perf_counters && _perf_counters[i]) {
+        hal.util->perf_begin(_perf_counters[i]);
+    }
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    fill_nanf_stack();
+#endif
+    task.function();
+    if (_debug > 1 && _perf_counters && _perf_counters[i]) {
+        hal.util->perf_end(_perf_counters[i]);
+    }
+    hal.util->persistent_data.scheduler_task = -1;
+
+    // work out how long the event actually took
+    const uint32_t time_taken = AP_HAL::micros() - _task_time_started;
+    bool overrun = false;
+    if (time_taken > _task_time_allowed) {
+        overrun = true;
+        // the event overran!
+        debug(3, "Scheduler overrun task[%u-%s] (%u/%u)\n",
+              (unsigned)i,
+              task.name,
+              (unsigned)time_taken,
+              (unsigned)_task_time_allowed);
+    }
+
+    perf_info.update_task_info(i, time_taken, overrun);
+    // a task taking over 65ms still belongs in the slowest bucket
+    perf_info.update_task_histogram(i, _task_time_started, interval_ticks * get_loop_period_us(),
+                                    MIN(time_taken, uint32_t(UINT16_MAX)));
+
+    return time_taken;
+}
+
 /*
   run one tick
   this will run as many scheduler tasks as we can in the specified time
  */
 void AP_Scheduler::run(uint32_t time_available)
 {
-    uint32_t run_started_usec = AP_HAL::micros();
-    uint32_t now = run_started_usec;
-
     if (_debug > 1 && _perf_counters == nullptr) {
         _perf_counters = new AP_HAL::Util::perf_counter_t[_num_tasks];
         if (_perf_counters != nullptr) {
@@ -166,16 +218,23 @@ void AP_Scheduler::run(uint32_t time_available)
             }
         }
     }
-    
+
+    if (_options & uint8_t(Options::DEADLINE_SCHEDULING)) {
+        if (_deadline.cost_us != nullptr || deadline_init()) {
+            run_deadline(time_available);
+            return;
+        }
+    } else if (_deadline.cost_us != nullptr) {
+        deadline_free();
+    }
+
+    uint32_t now = AP_HAL::micros();
+
     for (uint8_t i=0; i<_num_tasks; i++) {
         const AP_Scheduler::Task& task = (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
 
         uint32_t dt = _tick_counter - _last_run[i];
-        // we allow 0 to mean loop rate
-        uint32_t interval_ticks = (is_zero(task.rate_hz) ? 1 : _loop_rate_hz / task.rate_hz);
-        if (interval_ticks < 1) {
-            interval_ticks = 1;
-        }
+        const uint16_t interval_ticks = task_interval_ticks(task);
         if (dt < interval_ticks) {
             // this task is not yet scheduled to run again
             continue;
@@ -200,48 +259,28 @@ void AP_Scheduler::run(uint32_t time_available)
         }
 
         // run it
-        _task_time_started = now;
-        hal.util->persistent_data.scheduler_task = i;
-        if (_debug > 1 && _perf_counters && _perf_counters[i]) {
-            hal.util->perf_begin(_perf_counters[i]);
-        }
-#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
-        fill_nanf_stack();
-#endif
-        task.function();
-        if (_debug > 1 && _perf_counters && _perf_counters[i]) {
-            hal.util->perf_end(_perf_counters[i]);
-        }
-        hal.util->persistent_data.scheduler_task = -1;
+        const uint32_t time_taken = run_task(i, task, interval_ticks, now);
+        now += time_taken;
 
         // record the tick counter when we ran. This drives
         // when we next run the event
         _last_run[i] = _tick_counter;
 
-        // work out how long the event actually took
-        now = AP_HAL::micros();
-        uint32_t time_taken = now - _task_time_started;
-        bool overrun = false;
-        if (time_taken > _task_time_allowed) {
-            overrun = true;
-            // the event overran!
-            debug(3, "Scheduler overrun task[%u-%s] (%u/%u)\n",
-                  (unsigned)i,
-                  task.name,
-                  (unsigned)time_taken,
-                  (unsigned)_task_time_allowed);
-        }
-
-        perf_info.update_task_info(i, time_taken, overrun);
-
         if (time_taken >= time_available) {
+            // this task pushed the loop over budget
+            perf_info.task_exceeded_budget(i);
             time_available = 0;
             break;
         }
         time_available -= time_taken;
     }
 
-    // update number of spare microseconds
+    update_spare_time(time_available);
+}
+
+// update number of spare microseconds
+void AP_Scheduler::update_spare_time(uint32_t time_available)
+{
     _spare_micros += time_available;
 
     _spare_ticks++;
@@ -251,6 +290,141 @@ void AP_Scheduler::run(uint32_t time_available)
     }
 }
 
+/*
+  allocate the state for deadline scheduling and spread the first run
+  of each task which runs slower than the loop rate so that tasks
+  with the same rate don't all become due on the same tick
+ */
+bool AP_Scheduler::deadline_init()
+{
+    _deadline.cost_us = new uint16_t[_num_tasks];
+    if (_deadline.cost_us == nullptr || !_deadline.due.init(_num_tasks)) {
+        deadline_free();
+        _options.set(_options & ~uint8_t(Options::DEADLINE_SCHEDULING));
+        hal.console->printf("Unable to allocate scheduler deadline state\n");
+        return false;
+    }
+
+    // estimated load on each of the next few ticks
+    const uint8_t num_slots = 32;
+    uint32_t slot_load_us[num_slots] {};
+
+    for (uint8_t i=0; i<_num_tasks; i++) {
+        const AP_Scheduler::Task& task = (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
+        const uint16_t interval_ticks = task_interval_ticks(task);
+
+        // start from the promised time until we have measured the task
+        _deadline.cost_us[i] = task.max_time_micros;
+
+        // pick the phase which keeps the busiest tick it runs on lightest
+        uint8_t best_phase = 0;
+        uint32_t best_load = UINT32_MAX;
+        for (uint8_t phase=0; phase<MIN(interval_ticks, num_slots); phase++) {
+            uint32_t load = 0;
+            for (uint16_t t=phase; t<num_slots; t+=interval_ticks) {
+                load = MAX(load, slot_load_us[t]);
+            }
+            if (load < best_load) {
+                best_load = load;
+                best_phase = phase;
+            }
+        }
+        for (uint16_t t=best_phase; t<num_slots; t+=interval_ticks) {
+            slot_load_us[t] += task.max_time_micros;
+        }
+
+        // becomes due best_phase ticks from now
+        _last_run[i] = _tick_counter + best_phase - interval_ticks;
+    }
+
+    return true;
+}
+
+void AP_Scheduler::deadline_free()
+{
+    delete[] _deadline.cost_us;
+    _deadline.cost_us = nullptr;
+    _deadline.due.free();
+}
+
+/*
+  run one tick with earliest deadline first scheduling
+
+  Tasks running at the loop rate run first, in table order, as the
+  vehicle code relies on their order. The other due tasks run in
+  order of deadline, which is the tick by which they must run before
+  they are due again. A task is skipped if its measured cost doesn't
+  fit in the time left, unless it has fallen max_task_slowdown
+  intervals behind, in which case it runs anyway to guarantee it a
+  minimum rate.
+ */
+void AP_Scheduler::run_deadline(uint32_t time_available)
+{
+    // build the list of due tasks, sorted by deadline
+    AP::DeadlineQueue &due = _deadline.due;
+    due.clear();
+    for (uint8_t i=0; i<_num_tasks; i++) {
+        const AP_Scheduler::Task& task = (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
+        const uint16_t interval_ticks = task_interval_ticks(task);
+        const uint16_t dt = _tick_counter - _last_run[i];
+        if (dt < interval_ticks) {
+            continue;
+        }
+        if (dt >= interval_ticks*2) {
+            perf_info.task_slipped(i);
+        }
+        if (dt >= interval_ticks*max_task_slowdown) {
+            task_not_achieved++;
+        }
+        due.insert(i, AP::DeadlineQueue::deadline(interval_ticks, dt));
+    }
+
+    uint32_t now = AP_HAL::micros();
+
+    for (uint8_t n=0; n<due.count(); n++) {
+        const uint8_t i = due[n];
+        const AP_Scheduler::Task& task = (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
+        const uint16_t interval_ticks = task_interval_ticks(task);
+        const uint16_t dt = _tick_counter - _last_run[i];
+
+        const bool guaranteed = dt >= interval_ticks*max_task_slowdown;
+        if (!guaranteed && _deadline.cost_us[i] > time_available) {
+            // doesn't fit, maybe a cheaper task will
+            continue;
+        }
+
+        const uint32_t time_taken = run_task(i, task, interval_ticks, now);
+        now += time_taken;
+
+        // track the cost, quickly up and slowly down
+        uint16_t &cost = _deadline.cost_us[i];
+        if (time_taken >= cost) {
+            cost = MIN(time_taken, UINT16_MAX);
+        } else {
+            cost -= (cost - time_taken) / 16;
+        }
+
+        // keep the task on its phase unless it has slipped a whole interval
+        if (dt < interval_ticks*2) {
+            _last_run[i] += interval_ticks;
+        } else {
+            _last_run[i] = _tick_counter;
+        }
+
+        if (time_taken >= time_available) {
+            if (time_available > 0) {
+                // this task pushed the loop over budget
+                perf_info.task_exceeded_budget(i);
+            }
+            time_available = 0;
+        } else {
+            time_available -= time_taken;
+        }
+    }
+
+    update_spare_time(time_available);
+}
+
 /*
   return number of micros until the current task reaches its deadline
  */
@@ -371,15 +545,23 @@ void AP_Scheduler::update_logging()
     if (_log_performance_bit != (uint32_t)-1 &&
         AP::logger().should_log(_log_performance_bit)) {
         Log_Write_Performance();
+        perf_info.Log_Write_Task_Histograms();
     }
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
+    perf_info.reset_task_histograms();
     // dynamically update the per-task perf counter
     if (!(_options & uint8_t(Options::RECORD_TASK_INFO)) && perf_info.has_task_info()) {
         perf_info.free_task_info();
     } else if ((_options & uint8_t(Options::RECORD_TASK_INFO)) && !perf_info.has_task_info()) {
         perf_info.allocate_task_info(_num_tasks);
     }
+    // and the per-task histograms
+    if (!(_options & uint8_t(Options::RECORD_TASK_HISTOGRAMS)) && perf_info.has_task_histograms()) {
+        perf_info.free_task_histograms();
+    } else if ((_options & uint8_t(Options::RECORD_TASK_HISTOGRAMS)) && !perf_info.has_task_histograms()) {
+        perf_info.allocate_task_histograms(_num_tasks);
+    }
 }
 
 // Write a performance monitoring packet
@@ -459,6 +641,61 @@ size_t AP_Scheduler::task_info(char *buf, size_t bufsize)
     return total;
 }
 
+// display per-task latency histograms for the last second as text buffer for @SYS/taskhist.txt
+size_t AP_Scheduler::task_histograms(char *buf, size_t bufsize)
+{
+    size_t total = 0;
+
+    // a header to allow for machine parsers to determine format
+    int n = hal.util->snprintf(buf, bufsize, "TaskHistV1 EXEC/JITTER <16us <64us <256us <1ms <4ms >=4ms\n");
+
+    if (n <= 0 || size_t(n) >= bufsize) {
+        return 0;
+    }
+
+    // dynamically enable histogram collection
+    if (!(_options & uint8_t(Options::RECORD_TASK_HISTOGRAMS))) {
+        _options |= uint8_t(Options::RECORD_TASK_HISTOGRAMS);
+        return n;
+    }
+
+    if (perf_info.get_task_histogram(0) == nullptr) {
+        return n;
+    }
+
+    buf += n;
+    bufsize -= n;
+    total += n;
+
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        const AP_Scheduler::Task& task = (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
+        const AP::PerfInfo::TaskHistogram* h = perf_info.get_task_histogram(i);
+
+#if HAL_MINIMIZE_FEATURES
+        const char* fmt = "%-16.16s E=%u,%u,%u,%u,%u,%u J=%u,%u,%u,%u,%u,%u BOV=%u\n";
+#else
+        const char* fmt = "%-32.32s E=%u,%u,%u,%u,%u,%u J=%u,%u,%u,%u,%u,%u BOV=%u\n";
+#endif
+        n = hal.util->snprintf(buf, bufsize, fmt, task.name,
+            unsigned(MIN(h->exec[0], 999)), unsigned(MIN(h->exec[1], 999)), unsigned(MIN(h->exec[2], 999)),
+            unsigned(MIN(h->exec[3], 999)), unsigned(MIN(h->exec[4], 999)), unsigned(MIN(h->exec[5], 999)),
+            unsigned(MIN(h->jitter[0], 999)), unsigned(MIN(h->jitter[1], 999)), unsigned(MIN(h->jitter[2], 999)),
+            unsigned(MIN(h->jitter[3], 999)), unsigned(MIN(h->jitter[4], 999)), unsigned(MIN(h->jitter[5], 999)),
+            unsigned(MIN(h->budget_overruns, 999)));
+
+        // stop once the buffer is full, snprintf returns the length
+        // it would have written
+        if (n <= 0 || size_t(n) >= bufsize) {
+            break;
+        }
+        buf += n;
+        bufsize -= n;
+        total += n;
+    }
+
+    return total;
+}
+
 namespace AP {
 
 AP_Scheduler &scheduler()
@@ -25,6 +25,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include "PerfInfo.h"       // loop perf monitoring
+#include "DeadlineQueue.h"
 
 #if HAL_MINIMIZE_FEATURES
 #define AP_SCHEDULER_NAME_INITIALIZER(_clazz,_name) .name = #_name,
@@ -80,7 +81,9 @@ public:
     };
 
     enum class Options : uint8_t {
-        RECORD_TASK_INFO = 1 << 0
+        RECORD_TASK_INFO = 1 << 0,
+        RECORD_TASK_HISTOGRAMS = 1 << 1,
+        DEADLINE_SCHEDULING = 1 << 2,
     };
 
     // initialise scheduler
@@ -157,6 +160,7 @@ public:
     HAL_Semaphore &get_semaphore(void) { return _rsem; }
 
     size_t task_info(char *buf, size_t bufsize);
+    size_t task_histograms(char *buf, size_t bufsize);
 
     static const struct AP_Param::GroupInfo var_info[];
 
@@ -244,6 +248,20 @@ private:
 
     // semaphore that is held while not waiting for ins samples
     HAL_Semaphore _rsem;
+
+    // state for deadline scheduling, allocated when enabled
+    struct {
+        uint16_t *cost_us;  // filtered measured run time of each task
+        AP::DeadlineQueue due;
+    } _deadline;
+
+    uint16_t task_interval_ticks(const Task &task) const;
+    uint32_t run_task(uint8_t i, const Task &task, uint16_t interval_ticks, uint32_t now);
+    void update_spare_time(uint32_t time_available);
+
+    bool deadline_init();
+    void deadline_free();
+    void run_deadline(uint32_t time_available);
 };
 
 namespace AP {
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace AP {
+
+/*
+  the due tasks of one scheduler tick, in order of deadline
+ */
+class DeadlineQueue {
+public:
+    DeadlineQueue() {}
+
+    /* Do not allow copies */
+    DeadlineQueue(const DeadlineQueue &other) = delete;
+    DeadlineQueue &operator=(const DeadlineQueue&) = delete;
+
+    ~DeadlineQueue() { free(); }
+
+    // allocate space for num_tasks tasks, returns false on failure
+    bool init(uint8_t num_tasks) {
+        free();
+        _order = new uint8_t[num_tasks];
+        _deadline = new int32_t[num_tasks];
+        if (_order == nullptr || _deadline == nullptr) {
+            free();
+            return false;
+        }
+        return true;
+    }
+
+    void free() {
+        delete[] _order;
+        delete[] _deadline;
+        _order = nullptr;
+        _deadline = nullptr;
+        _count = 0;
+    }
+
+    /*
+      the deadline of a task which is dt ticks since its last run, in
+      ticks from now. A task must run before it is due again, tasks
+      running at the loop rate have no slack so always come first
+     */
+    static int32_t deadline(uint16_t interval_ticks, uint16_t dt) {
+        if (interval_ticks == 1) {
+            return INT32_MIN;
+        }
+        return int32_t(interval_ticks*2) - dt;
+    }
+
+    void clear() { _count = 0; }
+
+    // add a due task. The insertion is stable, so tasks with equal
+    // deadlines keep table order
+    void insert(uint8_t task, int32_t deadline) {
+        uint8_t pos = _count;
+        while (pos > 0 && _deadline[pos-1] > deadline) {
+            _order[pos] = _order[pos-1];
+            _deadline[pos] = _deadline[pos-1];
+            pos--;
+        }
+        _order[pos] = task;
+        _deadline[pos] = deadline;
+        _count++;
+    }
+
+    uint8_t count() const { return _count; }
+
+    // the task to run n'th
+    uint8_t operator[](uint8_t n) const { return _order[n]; }
+
+private:
+    uint8_t *_order = nullptr;      // due tasks in the order they will be run
+    int32_t *_deadline = nullptr;   // ticks until the deadline of each task in order
+    uint8_t _count;
+};
+
+};
@@ -74,6 +74,83 @@ void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, b
     }
 }
 
+// allocate the per-task latency histograms
+void AP::PerfInfo::allocate_task_histograms(uint8_t num_tasks)
+{
+    _task_histograms = new TaskHistogram[num_tasks];
+    if (_task_histograms == nullptr) {
+        hal.console->printf("Unable to allocate scheduler TaskHistogram\n");
+        _num_histograms = 0;
+        return;
+    }
+    _num_histograms = num_tasks;
+}
+
+void AP::PerfInfo::free_task_histograms()
+{
+    delete[] _task_histograms;
+    _task_histograms = nullptr;
+    _num_histograms = 0;
+}
+
+// return the histogram bucket for a time in microseconds
+uint8_t AP::PerfInfo::histogram_bucket(uint32_t value_us)
+{
+    uint8_t bucket = 0;
+    for (uint32_t limit = 16; value_us >= limit && bucket < HISTOGRAM_BUCKETS-1; limit *= 4) {
+        bucket++;
+    }
+    return bucket;
+}
+
+// called after each run of a task to add its start jitter and execution time to the histograms
+void AP::PerfInfo::update_task_histogram(uint8_t task_index, uint32_t start_us, uint32_t interval_us, uint16_t task_time_us)
+{
+    if (_task_histograms == nullptr || task_index >= _num_histograms) {
+        return;
+    }
+    TaskHistogram &h = _task_histograms[task_index];
+    h.exec[histogram_bucket(task_time_us)]++;
+    if (h.last_start_us != 0) {
+        const int32_t error_us = int32_t((start_us - h.last_start_us) - interval_us);
+        h.jitter[histogram_bucket(abs(error_us))]++;
+    }
+    h.last_start_us = start_us;
+}
+
+// write out a SCHH message per task
+void AP::PerfInfo::Log_Write_Task_Histograms() const
+{
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (_task_histograms == nullptr || logger == nullptr) {
+        return;
+    }
+    const uint64_t now = AP_HAL::micros64();
+    for (uint8_t i=0; i<_num_histograms; i++) {
+        const TaskHistogram &h = _task_histograms[i];
+        struct log_TaskHistogram pkt {
+            LOG_PACKET_HEADER_INIT(LOG_SCHED_HIST_MSG),
+            time_us         : now,
+            task            : i,
+            budget_overruns : h.budget_overruns,
+        };
+        memcpy(pkt.exec, h.exec, sizeof(pkt.exec));
+        memcpy(pkt.jitter, h.jitter, sizeof(pkt.jitter));
+        logger->WriteBlock(&pkt, sizeof(pkt));
+    }
+}
+
+// clear the histogram counts to start a new period
+void AP::PerfInfo::reset_task_histograms()
+{
+    for (uint8_t i=0; i<_num_histograms; i++) {
+        TaskHistogram &h = _task_histograms[i];
+        memset(h.exec, 0, sizeof(h.exec));
+        memset(h.jitter, 0, sizeof(h.jitter));
+        h.budget_overruns = 0;
+    }
+}
+
 // check_loop_time - check latest loop time vs min, max and overtime threshold
 void AP::PerfInfo::check_loop_time(uint32_t time_in_micros)
 {
@@ -18,6 +18,19 @@ public:
         uint16_t overrun_count;
     };
 
+    // number of buckets in the per-task latency histograms. Each
+    // bucket covers four times the range of the one before it,
+    // starting with 0-15us
+    static const uint8_t HISTOGRAM_BUCKETS = 6;
+
+    // per-task latency histograms, reset every second
+    struct TaskHistogram {
+        uint16_t exec[HISTOGRAM_BUCKETS];   // time taken by each run
+        uint16_t jitter[HISTOGRAM_BUCKETS]; // start time error against the requested rate
+        uint16_t budget_overruns;           // runs which used up the rest of the loop
+        uint32_t last_start_us;
+    };
+
     /* Do not allow copies */
     PerfInfo(const PerfInfo &other) = delete;
     PerfInfo &operator=(const PerfInfo&) = delete;
@@ -47,6 +60,26 @@ public:
     }
     // called after each run of a task to update its statistics based on measurements taken by the scheduler
     void update_task_info(uint8_t task_index, uint16_t task_time_us, bool overrun);
+    // allocate the per-task latency histograms
+    void allocate_task_histograms(uint8_t num_tasks);
+    void free_task_histograms();
+    bool has_task_histograms() const { return _task_histograms != nullptr; }
+    const TaskHistogram* get_task_histogram(uint8_t task_index) const {
+        return (_task_histograms && task_index < _num_histograms) ? &_task_histograms[task_index] : nullptr;
+    }
+    // called after each run of a task with its start time and requested interval
+    void update_task_histogram(uint8_t task_index, uint32_t start_us, uint32_t interval_us, uint16_t task_time_us);
+    // record that a task used up the rest of the time available in the loop
+    void task_exceeded_budget(uint8_t task_index) {
+        if (_task_histograms && task_index < _num_histograms) {
+            _task_histograms[task_index].budget_overruns++;
+        }
+    }
+    // write the histograms to the log
+    void Log_Write_Task_Histograms() const;
+    // clear the histogram counts to start a new period
+    void reset_task_histograms();
+
     // record that a task slipped
     void task_slipped(uint8_t task_index) {
         if (_task_info && task_index < _num_tasks) {
@@ -69,6 +102,10 @@ private:
     // performance monitoring
     uint8_t _num_tasks;
     TaskInfo* _task_info;
+    uint8_t _num_histograms;
+    TaskHistogram* _task_histograms;
+
+    static uint8_t histogram_bucket(uint32_t value_us);
 };
 
 };
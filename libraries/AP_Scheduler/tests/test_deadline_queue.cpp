@@ -0,0 +1,80 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Scheduler/DeadlineQueue.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(DeadlineQueue, Deadline)
+{
+    // loop rate tasks always come first
+    EXPECT_EQ(INT32_MIN, AP::DeadlineQueue::deadline(1, 1));
+    EXPECT_EQ(INT32_MIN, AP::DeadlineQueue::deadline(1, 5));
+
+    // a task must run before it is due again
+    EXPECT_EQ(10, AP::DeadlineQueue::deadline(10, 10));
+    EXPECT_EQ(1, AP::DeadlineQueue::deadline(10, 19));
+    EXPECT_EQ(-5, AP::DeadlineQueue::deadline(10, 25));
+
+    // a faster task which just fell due goes ahead of a slower one
+    EXPECT_LT(AP::DeadlineQueue::deadline(4, 4), AP::DeadlineQueue::deadline(8, 8));
+    // but not of one which has been waiting
+    EXPECT_GT(AP::DeadlineQueue::deadline(4, 4), AP::DeadlineQueue::deadline(8, 13));
+}
+
+TEST(DeadlineQueue, OrdersByDeadline)
+{
+    AP::DeadlineQueue due;
+    ASSERT_TRUE(due.init(6));
+    due.clear();
+
+    due.insert(0, 7);
+    due.insert(1, INT32_MIN);
+    due.insert(2, -3);
+    due.insert(3, 20);
+    due.insert(4, INT32_MIN);
+    due.insert(5, 0);
+
+    const uint8_t expected[] { 1, 4, 2, 5, 0, 3 };
+    ASSERT_EQ(ARRAY_SIZE(expected), due.count());
+    for (uint8_t n=0; n<due.count(); n++) {
+        EXPECT_EQ(expected[n], due[n]);
+    }
+}
+
+TEST(DeadlineQueue, EqualDeadlinesKeepTableOrder)
+{
+    AP::DeadlineQueue due;
+    ASSERT_TRUE(due.init(8));
+    due.clear();
+
+    for (uint8_t i=0; i<8; i++) {
+        due.insert(i, (i & 1) ? 5 : 2);
+    }
+    const uint8_t expected[] { 0, 2, 4, 6, 1, 3, 5, 7 };
+    ASSERT_EQ(ARRAY_SIZE(expected), due.count());
+    for (uint8_t n=0; n<due.count(); n++) {
+        EXPECT_EQ(expected[n], due[n]);
+    }
+}
+
+TEST(DeadlineQueue, ClearedEachTick)
+{
+    AP::DeadlineQueue due;
+    ASSERT_TRUE(due.init(4));
+    due.clear();
+    due.insert(3, 1);
+    due.insert(2, 0);
+    EXPECT_EQ(2U, due.count());
+
+    due.clear();
+    EXPECT_EQ(0U, due.count());
+    due.insert(1, 4);
+    EXPECT_EQ(1U, due.count());
+    EXPECT_EQ(1U, due[0]);
+
+    due.free();
+    EXPECT_EQ(0U, due.count());
+}
+
+AP_GTEST_MAIN()
@@ -26,6 +26,10 @@
 
 #include <AP_Filesystem/AP_Filesystem.h>
 
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#include <unistd.h>
+#endif
+
 extern const AP_HAL::HAL& hal;
 
 AP_Terrain *AP_Terrain::singleton;
@@ -41,7 +45,7 @@ const AP_Param::GroupInfo AP_Terrain::var_info[] = {
 
     // @Param: SPACING
     // @DisplayName: Terrain grid spacing
-    // @Description: Distance between terrain grid points in meters. This controls the horizontal resolution of the terrain data that is stored on te SD card and requested from the ground station. If your GCS is using the ArduPilot SRTM database like Mission Planner or MAVProxy, then a resolution of 100 meters is appropriate. Grid spacings lower than 100 meters waste SD card space if the GCS cannot provide that resolution. The grid spacing also controls how much data is kept in memory during flight. A larger grid spacing will allow for a larger amount of data in memory. A grid spacing of 100 meters results in the vehicle keeping 12 grid squares in memory with each grid square having a size of 2.7 kilometers by 3.2 kilometers. Any additional grid squares are stored on the SD once they are fetched from the GCS and will be loaded as needed.
+    // @Description: Distance between terrain grid points in meters. This controls the horizontal resolution of the terrain data that is stored on te SD card and requested from the ground station. If your GCS is using the ArduPilot SRTM database like Mission Planner or MAVProxy, then a resolution of 100 meters is appropriate. Grid spacings lower than 100 meters waste SD card space if the GCS cannot provide that resolution. The grid spacing also controls how much data is kept in memory during flight. A larger grid spacing will allow for a larger amount of data in memory. A grid spacing of 100 meters results in the vehicle keeping TERRAIN_CACHE_SZ grid squares in memory (12 by default on most boards) with each grid square having a size of 2.7 kilometers by 3.2 kilometers. Any additional grid squares are stored on the SD once they are fetched from the GCS and will be loaded as needed.
     // @Units: m
     // @Increment: 1
     // @User: Advanced
@@ -53,7 +57,15 @@ const AP_Param::GroupInfo AP_Terrain::var_info[] = {
     // @Bitmask: 0:Disable Download
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",   2, AP_Terrain, options, 0),
-    
+
+    // @Param: CACHE_SZ
+    // @DisplayName: Terrain cache size
+    // @Description: Number of terrain grid blocks kept in memory. Each block takes about 2 kilobytes. Zero selects the size automatically, which is 12 blocks on most boards and is based on the free memory on Linux boards and SITL. A larger cache avoids reloading blocks from the SD card on long missions.
+    // @Range: 0 1024
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("CACHE_SZ",  3, AP_Terrain, cache_sz, 0),
+
     AP_GROUPEND
 };
 
@@ -328,6 +340,9 @@ void AP_Terrain::update(void)
     // check for pending rally data
     update_rally_data();
 
+    // load grids ahead of the vehicle on the mission
+    update_mission_prefetch();
+
     // update capabilities and status
     if (allocate()) {
         if (!pos_valid) {
@@ -378,6 +393,26 @@ void AP_Terrain::log_terrain_data()
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
 
+/*
+  return the number of grid blocks to allocate for the cache
+ */
+uint16_t AP_Terrain::get_cache_size(void) const
+{
+    if (cache_sz > 0) {
+        return MIN(uint16_t(cache_sz.get()), TERRAIN_GRID_BLOCK_CACHE_MAX);
+    }
+#if (CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL) && defined(_SC_AVPHYS_PAGES)
+    // use up to 1/64th of the free memory
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) {
+        const uint64_t blocks = (uint64_t(pages) * uint64_t(page_size) / 64) / sizeof(struct grid_cache);
+        return constrain_int32(blocks, TERRAIN_GRID_BLOCK_CACHE_SIZE, TERRAIN_GRID_BLOCK_CACHE_MAX);
+    }
+#endif
+    return TERRAIN_GRID_BLOCK_CACHE_SIZE;
+}
+
 /*
   allocate terrain cache. Making this dynamically allocated allows
   memory to be saved when terrain functionality is disabled
@@ -390,13 +425,17 @@ bool AP_Terrain::allocate(void)
     if (cache != nullptr) {
         return true;
     }
-    cache = (struct grid_cache *)calloc(TERRAIN_GRID_BLOCK_CACHE_SIZE, sizeof(cache[0]));
-    if (cache == nullptr) {
+    const uint16_t size = get_cache_size();
+
+    cache = (struct grid_cache *)calloc(size, sizeof(cache[0]));
+    if (cache == nullptr || !cache_index.init(size)) {
+        free(cache);
+        cache = nullptr;
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Terrain: Allocation failed");
         memory_alloc_failed = true;
         return false;
     }
-    cache_size = TERRAIN_GRID_BLOCK_CACHE_SIZE;
+    cache_size = size;
     return true;
 }
 
@@ -29,6 +29,7 @@
 
 #include <AP_Param/AP_Param.h>
 #include <AP_Mission/AP_Mission.h>
+#include "TerrainCacheIndex.h"
 
 #define TERRAIN_DEBUG 0
 
@@ -51,9 +52,16 @@
 #define TERRAIN_GRID_BLOCK_SIZE_X (TERRAIN_GRID_MAVLINK_SIZE*TERRAIN_GRID_BLOCK_MUL_X)
 #define TERRAIN_GRID_BLOCK_SIZE_Y (TERRAIN_GRID_MAVLINK_SIZE*TERRAIN_GRID_BLOCK_MUL_Y)
 
-// number of grid_blocks in the LRU memory cache
+// number of grid_blocks in the LRU memory cache when TERRAIN_CACHE_SZ
+// is zero on boards without plenty of RAM
 #define TERRAIN_GRID_BLOCK_CACHE_SIZE 12
 
+// limit on the number of grid_blocks in the LRU memory cache
+#define TERRAIN_GRID_BLOCK_CACHE_MAX 1024
+
+// number of mission legs ahead of the vehicle to prefetch
+#define TERRAIN_PREFETCH_LEGS 3
+
 // format of grid on disk
 #define TERRAIN_GRID_FORMAT_VERSION 1
 
@@ -294,6 +302,16 @@ private:
     */
     struct grid_cache &find_grid_cache(const struct grid_info &info);
 
+    /*
+      hash index of the grid cache, keyed on the grid indices
+     */
+    uint16_t grid_hash(const struct grid_block &grid) const;
+    void hash_insert(uint16_t idx);
+    void hash_remove(uint16_t idx);
+
+    // number of grid blocks to allocate for the cache
+    uint16_t get_cache_size(void) const;
+
     /*
       calculate bit number in grid_block bitmap. This corresponds to a
       bit representing a 4x4 mavlink transmitted block
@@ -346,11 +364,17 @@ private:
      */
     void update_rally_data(void);
 
+    /*
+      load the grid blocks along the next mission legs
+     */
+    void update_mission_prefetch(void);
+
 
     // parameters
     AP_Int8  enable;
     AP_Int16 grid_spacing; // meters between grid points
     AP_Int16 options; // option bits
+    AP_Int16 cache_sz; // number of grid blocks to cache in memory, 0 for automatic
 
     enum class Options {
         DisableDownload = (1U<<0),
@@ -361,9 +385,12 @@ private:
     const AP_Mission &mission;
 
     // cache of grids in memory, LRU
-    uint8_t cache_size = 0;
+    uint16_t cache_size = 0;
     struct grid_cache *cache = nullptr;
 
+    // hash index into cache
+    TerrainCacheIndex cache_index;
+
     // a grid_cache block waiting for disk IO
     enum DiskIoState {
         DiskIoIdle      = 0,
@@ -419,6 +446,9 @@ private:
     // grid spacing during mission check
     uint16_t last_mission_spacing;
 
+    // last time we prefetched grids along the mission
+    uint32_t last_prefetch_ms;
+
     // next rally command to check
     uint16_t next_rally_index;
 
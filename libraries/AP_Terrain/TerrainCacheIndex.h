@@ -0,0 +1,96 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+  hash index of the AP_Terrain grid cache, keyed on the integer grid
+  indices of each block. Each bucket is a chain of cache indices
+  linked through _next, ending in NONE
+ */
+class TerrainCacheIndex {
+public:
+    enum : uint16_t { NONE = UINT16_MAX };
+
+    TerrainCacheIndex() {}
+
+    /* Do not allow copies */
+    TerrainCacheIndex(const TerrainCacheIndex &other) = delete;
+    TerrainCacheIndex &operator=(const TerrainCacheIndex&) = delete;
+
+    // allocate the index for a cache of size entries, returns false on failure
+    bool init(uint16_t size) {
+        // at least two blocks per bucket on average
+        uint16_t buckets = 1;
+        while (buckets*2 < size) {
+            buckets *= 2;
+        }
+        _head = (uint16_t *)malloc(buckets * sizeof(_head[0]));
+        _next = (uint16_t *)malloc(size * sizeof(_next[0]));
+        if (_head == nullptr || _next == nullptr) {
+            release();
+            return false;
+        }
+        for (uint16_t i=0; i<buckets; i++) {
+            _head[i] = NONE;
+        }
+        _mask = buckets - 1;
+        return true;
+    }
+
+    void release() {
+        ::free(_head);
+        ::free(_next);
+        _head = nullptr;
+        _next = nullptr;
+    }
+
+    // the bucket holding the block with the given grid indices
+    uint16_t bucket(int8_t lat_degrees, int16_t lon_degrees, uint16_t grid_idx_x, uint16_t grid_idx_y) const {
+        uint32_t h = uint8_t(lat_degrees);
+        h = h * 31 + uint16_t(lon_degrees);
+        h = h * 31 + grid_idx_x;
+        h = h * 31 + grid_idx_y;
+        h ^= h >> 13;
+        return h & _mask;
+    }
+
+    // add a cache entry to a bucket
+    void insert(uint16_t bucket, uint16_t idx) {
+        _next[idx] = _head[bucket];
+        _head[bucket] = idx;
+    }
+
+    // remove a cache entry from a bucket, if it is there
+    void remove(uint16_t bucket, uint16_t idx) {
+        for (uint16_t *p = &_head[bucket]; *p != NONE; p = &_next[*p]) {
+            if (*p == idx) {
+                *p = _next[idx];
+                return;
+            }
+        }
+    }
+
+    // walk the cache entries in a bucket, ending in NONE
+    uint16_t first(uint16_t bucket) const { return _head[bucket]; }
+    uint16_t next(uint16_t idx) const { return _next[idx]; }
+
+private:
+    uint16_t _mask;
+    uint16_t *_head = nullptr;
+    uint16_t *_next = nullptr;
+};
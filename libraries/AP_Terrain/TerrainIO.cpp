@@ -87,8 +87,12 @@ void AP_Terrain::schedule_disk_io(void)
         int16_t cache_idx = find_io_idx(GRID_CACHE_DISKWAIT);
         if (cache_idx != -1) {
             if (disk_block.block.bitmap != 0) {
-                // when bitmap is zero we read an empty block
+                // when bitmap is zero we read an empty block. The
+                // block read from disk is re-indexed in case its grid
+                // indices differ from the ones we calculated
+                hash_remove(cache_idx);
                 cache[cache_idx].grid = disk_block.block;
+                hash_insert(cache_idx);
             }
             cache[cache_idx].state = GRID_CACHE_VALID;
             cache[cache_idx].last_access_ms = AP_HAL::millis();
@@ -24,6 +24,7 @@
 #include <GCS_MAVLink/GCS.h>
 #include "AP_Terrain.h"
 #include <AP_GPS/AP_GPS.h>
+#include <AP_AHRS/AP_AHRS.h>
 
 #if AP_TERRAIN_AVAILABLE
 
@@ -107,6 +108,90 @@ void AP_Terrain::update_mission_data(void)
     }
 }
 
+/*
+  load the grid blocks along the next few legs of a running mission
+  into the cache, so they are read from disk (or requested from the
+  GCS) before the vehicle gets there. This is only useful when the
+  cache is large enough to hold them alongside the blocks around the
+  vehicle, so at most half the cache is used for prefetching
+ */
+void AP_Terrain::update_mission_prefetch(void)
+{
+    if (mission.state() != AP_Mission::MISSION_RUNNING) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_prefetch_ms < 1000) {
+        return;
+    }
+    last_prefetch_ms = now_ms;
+
+    const uint16_t max_blocks = cache_size / 2;
+    if (max_blocks <= TERRAIN_GRID_BLOCK_CACHE_SIZE / 2) {
+        // the cache is needed for the blocks around the vehicle
+        return;
+    }
+
+    // the non-const mission is needed to follow DO_JUMPs
+    AP_Mission *nav_mission = AP::mission();
+    if (nav_mission == nullptr) {
+        return;
+    }
+
+    Location pos;
+    if (!AP::ahrs().get_position(pos)) {
+        return;
+    }
+
+    // walk the legs in steps of half a grid block
+    const float step = grid_spacing * TERRAIN_GRID_BLOCK_SPACING_X * 0.5f;
+    uint16_t index = mission.get_current_nav_index();
+    uint16_t blocks = 0;
+    uint16_t steps = 0;
+    Location last_grid;
+    for (uint8_t leg=0; leg<TERRAIN_PREFETCH_LEGS; leg++) {
+        // follow DO_JUMPs to the legs which will be flown next,
+        // without counting them as run
+        AP_Mission::Mission_Command cmd;
+        do {
+            if (!nav_mission->get_next_nav_cmd(index, cmd) ||
+                ++steps >= 200) {
+                return;
+            }
+            index = cmd.index + 1;
+        } while ((cmd.id != MAV_CMD_NAV_WAYPOINT &&
+                  cmd.id != MAV_CMD_NAV_SPLINE_WAYPOINT) ||
+                 (cmd.content.location.lat == 0 && cmd.content.location.lng == 0));
+
+        const Location &dest = cmd.content.location;
+        const float bearing = pos.get_bearing_to(dest) * 0.01f;
+        float distance = pos.get_distance(dest);
+        while (true) {
+            struct grid_info info;
+            calculate_grid_info(pos, info);
+            if (!TERRAIN_LATLON_EQUAL(last_grid.lat, info.grid_lat) ||
+                !TERRAIN_LATLON_EQUAL(last_grid.lng, info.grid_lon)) {
+                find_grid_cache(info);
+                last_grid.lat = info.grid_lat;
+                last_grid.lng = info.grid_lon;
+                if (++blocks >= max_blocks) {
+                    return;
+                }
+            }
+            if (distance <= 0) {
+                break;
+            }
+            if (++steps >= 200) {
+                return;
+            }
+            const float d = MIN(step, distance);
+            pos.offset_bearing(bearing, d);
+            distance -= d;
+        }
+        pos = dest;
+    }
+}
+
 /*
   check that we have fetched all rally terrain data
  */
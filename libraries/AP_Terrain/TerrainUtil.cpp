@@ -105,28 +105,59 @@ void AP_Terrain::calculate_grid_info(const Location &loc, struct grid_info &info
 
 
 /*
-  find a grid structure given a grid_info
+  hash index bucket of a grid block
  */
-AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info)
+uint16_t AP_Terrain::grid_hash(const struct grid_block &grid) const
 {
-    uint16_t oldest_i = 0;
+    return cache_index.bucket(grid.lat_degrees, grid.lon_degrees, grid.grid_idx_x, grid.grid_idx_y);
+}
+
+/*
+  add a cache entry to the hash index
+ */
+void AP_Terrain::hash_insert(uint16_t idx)
+{
+    cache_index.insert(grid_hash(cache[idx].grid), idx);
+}
 
+/*
+  remove a cache entry from the hash index
+ */
+void AP_Terrain::hash_remove(uint16_t idx)
+{
+    cache_index.remove(grid_hash(cache[idx].grid), idx);
+}
+
+/*
+  find a grid structure given a grid_info. Cache entries which are
+  not GRID_CACHE_INVALID are kept in a hash index so the common case
+  of a hit does not need to scan the cache
+ */
+AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info)
+{
     // see if we have that grid
-    for (uint16_t i=0; i<cache_size; i++) {
+    const uint16_t h = cache_index.bucket(info.lat_degrees, info.lon_degrees, info.grid_idx_x, info.grid_idx_y);
+    for (uint16_t i=cache_index.first(h); i != TerrainCacheIndex::NONE; i=cache_index.next(i)) {
         if (TERRAIN_LATLON_EQUAL(cache[i].grid.lat,info.grid_lat) &&
             TERRAIN_LATLON_EQUAL(cache[i].grid.lon,info.grid_lon) &&
             cache[i].grid.spacing == grid_spacing) {
             cache[i].last_access_ms = AP_HAL::millis();
             return cache[i];
         }
-        if (cache[i].last_access_ms < cache[oldest_i].last_access_ms) {
-            oldest_i = i;
-        }
     }
 
     // Not found. Use the oldest grid and make it this grid,
     // initially unpopulated
+    uint16_t oldest_i = 0;
+    for (uint16_t i=1; i<cache_size; i++) {
+        if (cache[i].last_access_ms < cache[oldest_i].last_access_ms) {
+            oldest_i = i;
+        }
+    }
     struct grid_cache &grid = cache[oldest_i];
+    if (grid.state != GRID_CACHE_INVALID) {
+        hash_remove(oldest_i);
+    }
     memset(&grid, 0, sizeof(grid));
 
     grid.grid.lat = info.grid_lat;
@@ -141,6 +172,7 @@ AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info
 
     // mark as waiting for disk read
     grid.state = GRID_CACHE_DISKWAIT;
+    hash_insert(oldest_i);
 
     return grid;
 }
@@ -0,0 +1,159 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Terrain/TerrainCacheIndex.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  a cache of grid blocks with the same find and evict logic as
+  AP_Terrain::find_grid_cache(), keyed only on the grid indices
+ */
+class TerrainCacheTest : public ::testing::Test {
+protected:
+    struct block {
+        int8_t lat_degrees;
+        int16_t lon_degrees;
+        uint16_t grid_idx_x;
+        uint16_t grid_idx_y;
+        uint32_t last_access;
+        bool valid;
+    };
+
+    ~TerrainCacheTest() {
+        index.release();
+    }
+
+    void init(uint16_t size) {
+        ASSERT_LE(size, ARRAY_SIZE(cache));
+        ASSERT_TRUE(index.init(size));
+        cache_size = size;
+    }
+
+    uint16_t bucket(const block &b) const {
+        return index.bucket(b.lat_degrees, b.lon_degrees, b.grid_idx_x, b.grid_idx_y);
+    }
+
+    static bool same_grid(const block &a, const block &b) {
+        return a.lat_degrees == b.lat_degrees && a.lon_degrees == b.lon_degrees &&
+            a.grid_idx_x == b.grid_idx_x && a.grid_idx_y == b.grid_idx_y;
+    }
+
+    // the cache entry holding a block, or NONE
+    uint16_t lookup(const block &key) const {
+        for (uint16_t i=index.first(bucket(key)); i != TerrainCacheIndex::NONE; i=index.next(i)) {
+            if (same_grid(cache[i], key)) {
+                return i;
+            }
+        }
+        return TerrainCacheIndex::NONE;
+    }
+
+    // find a block, replacing the least recently used one on a miss
+    uint16_t find(const block &key) {
+        now++;
+        uint16_t i = lookup(key);
+        if (i != TerrainCacheIndex::NONE) {
+            hits++;
+            cache[i].last_access = now;
+            return i;
+        }
+        uint16_t oldest = 0;
+        for (i=1; i<cache_size; i++) {
+            if (cache[i].last_access < cache[oldest].last_access) {
+                oldest = i;
+            }
+        }
+        if (cache[oldest].valid) {
+            index.remove(bucket(cache[oldest]), oldest);
+        }
+        cache[oldest] = key;
+        cache[oldest].last_access = now;
+        cache[oldest].valid = true;
+        index.insert(bucket(key), oldest);
+        return oldest;
+    }
+
+    static block grid(int8_t lat, int16_t lon, uint16_t x, uint16_t y) {
+        return block { lat, lon, x, y, 0, false };
+    }
+
+    TerrainCacheIndex index;
+    block cache[64] {};
+    uint16_t cache_size = 0;
+    uint32_t now = 0;
+    uint32_t hits = 0;
+};
+
+TEST_F(TerrainCacheTest, Hit)
+{
+    init(12);
+    const uint16_t a = find(grid(-35, 149, 10, 20));
+    const uint16_t b = find(grid(-35, 149, 10, 21));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(0U, hits);
+
+    EXPECT_EQ(a, find(grid(-35, 149, 10, 20)));
+    EXPECT_EQ(b, find(grid(-35, 149, 10, 21)));
+    EXPECT_EQ(2U, hits);
+
+    // differs only in degrees
+    EXPECT_EQ(TerrainCacheIndex::NONE, lookup(grid(-34, 149, 10, 20)));
+    EXPECT_EQ(TerrainCacheIndex::NONE, lookup(grid(-35, 150, 10, 20)));
+}
+
+TEST_F(TerrainCacheTest, EvictsLeastRecentlyUsed)
+{
+    init(4);
+    for (uint16_t y=0; y<4; y++) {
+        find(grid(10, 20, 0, y));
+    }
+    // touch the oldest so the second oldest is evicted next
+    find(grid(10, 20, 0, 0));
+    const uint16_t evicted = lookup(grid(10, 20, 0, 1));
+    EXPECT_EQ(evicted, find(grid(10, 20, 5, 5)));
+
+    EXPECT_EQ(TerrainCacheIndex::NONE, lookup(grid(10, 20, 0, 1)));
+    EXPECT_NE(TerrainCacheIndex::NONE, lookup(grid(10, 20, 0, 0)));
+    EXPECT_NE(TerrainCacheIndex::NONE, lookup(grid(10, 20, 0, 2)));
+    EXPECT_NE(TerrainCacheIndex::NONE, lookup(grid(10, 20, 0, 3)));
+    EXPECT_NE(TerrainCacheIndex::NONE, lookup(grid(10, 20, 5, 5)));
+}
+
+/*
+  with many more blocks than buckets the chains are long, and
+  removing entries from the middle of them must not lose the rest
+ */
+TEST_F(TerrainCacheTest, ChainsSurviveEviction)
+{
+    init(64);
+    for (uint16_t pass=0; pass<20; pass++) {
+        for (uint16_t x=0; x<8; x++) {
+            for (uint16_t y=0; y<8; y++) {
+                find(grid(-35, 149, x + pass*3, y));
+            }
+        }
+        // every valid entry is reachable through the index, and no
+        // entry is reachable from more than one place
+        uint16_t reachable = 0;
+        for (uint16_t i=0; i<cache_size; i++) {
+            if (cache[i].valid) {
+                EXPECT_EQ(i, lookup(cache[i]));
+                reachable++;
+            }
+        }
+        EXPECT_EQ(cache_size, reachable);
+    }
+    // the overlap between passes was hit
+    EXPECT_GT(hits, 0U);
+}
+
+TEST_F(TerrainCacheTest, RemoveMissingIsHarmless)
+{
+    init(12);
+    const uint16_t a = find(grid(1, 2, 3, 4));
+    index.remove(bucket(grid(1, 2, 3, 4)), 7);
+    EXPECT_EQ(a, lookup(grid(1, 2, 3, 4)));
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,188 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_Trace.h"
+
+#if HAL_TRACE_ENABLED
+
+#include <AP_Logger/AP_Logger.h>
+#include <string.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+#elif CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+#include "ch.h"
+#endif
+
+extern const AP_HAL::HAL& hal;
+
+AP_Trace *AP_Trace::_singleton;
+
+AP_Trace::AP_Trace()
+{
+    if (_singleton) {
+        AP_HAL::panic("Too many AP_Trace instances");
+    }
+    _singleton = this;
+}
+
+/*
+  allocate the ring. Events recorded before this are dropped
+ */
+void AP_Trace::init(void)
+{
+    if (!_events.set_size(HAL_TRACE_BUFFER_SIZE)) {
+        hal.console->printf("Unable to allocate trace buffer\n");
+        return;
+    }
+    _dropped = 0;
+    hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_Trace::io_timer, void));
+}
+
+void AP_Trace::span(const char *name, uint64_t start_us, uint32_t duration_us)
+{
+    push(name, start_us, MIN(duration_us, (uint32_t)INT32_MAX), EventType::SPAN);
+}
+
+void AP_Trace::instant(const char *name)
+{
+    push(name, AP_HAL::micros64(), 0, EventType::INSTANT);
+}
+
+void AP_Trace::counter(const char *name, int32_t value)
+{
+    push(name, AP_HAL::micros64(), value, EventType::COUNTER);
+}
+
+void AP_Trace::push(const char *name, uint64_t time_us, int32_t value, EventType type)
+{
+    const Event event {
+        name,
+        time_us,
+        value,
+        thread_id(),
+        type,
+    };
+    if (!_events.push(event)) {
+        _dropped++;
+    }
+}
+
+/*
+  a number identifying the calling thread. ChibiOS threads are
+  identified by priority, which is unique to each of the HAL's threads
+ */
+uint32_t AP_Trace::thread_id(void)
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    return (uint32_t)(uintptr_t)pthread_self();
+#elif CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+    return chThdGetPriorityX();
+#else
+    return 0;
+#endif
+}
+
+/*
+  drain the events that are in the ring now, events recorded while
+  writing them out wait for the next call
+ */
+void AP_Trace::io_timer(void)
+{
+    const uint32_t dropped = _dropped;
+    if (dropped != _dropped_reported) {
+        counter("TraceDropped", dropped);
+        _dropped_reported = dropped;
+    }
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    if (_file == nullptr) {
+        const uint32_t now_ms = AP_HAL::millis();
+        if (_last_open_ms != 0 && now_ms - _last_open_ms < 1000) {
+            return;
+        }
+        _last_open_ms = now_ms;
+        _file = fopen(HAL_TRACE_FILE, "w");
+        if (_file == nullptr) {
+            return;
+        }
+        // the JSON array format allows the closing bracket to be left
+        // off, so the file is usable however the process exits
+        fprintf(_file, "[\n");
+    }
+#endif
+
+    uint32_t n = _events.available();
+    if (n == 0) {
+        return;
+    }
+    Event event;
+    while (n-- > 0 && _events.pop(event)) {
+        write_event(event);
+    }
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    fflush(_file);
+#endif
+}
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+/*
+  write an event in the Chrome trace event format
+ */
+void AP_Trace::write_event(const Event &event)
+{
+    const unsigned pid = getpid();
+    switch (event.type) {
+    case EventType::SPAN:
+        fprintf(_file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%" PRIu64 ",\"dur\":%d,\"pid\":%u,\"tid\":%u},\n",
+                event.name, event.time_us, (int)event.value, pid, (unsigned)event.thread);
+        break;
+    case EventType::INSTANT:
+        fprintf(_file, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%" PRIu64 ",\"pid\":%u,\"tid\":%u},\n",
+                event.name, event.time_us, pid, (unsigned)event.thread);
+        break;
+    case EventType::COUNTER:
+        fprintf(_file, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%" PRIu64 ",\"pid\":%u,\"args\":{\"value\":%d}},\n",
+                event.name, event.time_us, pid, (int)event.value);
+        break;
+    }
+}
+#else
+/*
+  write an event as a TRCE log message
+ */
+void AP_Trace::write_event(const Event &event)
+{
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr) {
+        return;
+    }
+    struct log_Trace pkt {
+        LOG_PACKET_HEADER_INIT(LOG_TRACE_MSG),
+        time_us : event.time_us,
+        value   : event.value,
+        type    : (uint8_t)event.type,
+        thread  : (uint8_t)event.thread,
+        name    : {},
+    };
+    strncpy(pkt.name, event.name, sizeof(pkt.name));
+    logger->WriteBlock(&pkt, sizeof(pkt));
+}
+#endif
+
+#endif // HAL_TRACE_ENABLED
@@ -0,0 +1,164 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  timing traces of hot code paths
+
+  Code is instrumented with the macros below, which expand to nothing
+  unless the build defines HAL_TRACE_ENABLED:
+
+    AP_TRACE_SCOPE("EKF3")          time from here to the end of the scope
+    AP_TRACE_POINT("GPS fix")       an instant in time
+    AP_TRACE_COUNTER("Queue", n)    the value of a counter
+
+  Names must be string literals, only the pointer is kept, and must
+  not need escaping in JSON. The arguments are not evaluated when
+  tracing is disabled.
+
+  Events are pushed to a lock free ring from any thread and drained by
+  the IO thread. On Linux and SITL they are appended to HAL_TRACE_FILE
+  in the Chrome trace event format, which can be opened in Perfetto or
+  chrome://tracing. On other boards they are written to the log as
+  TRCE messages.
+ */
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+#ifndef HAL_TRACE_ENABLED
+#define HAL_TRACE_ENABLED 0
+#endif
+
+#if HAL_TRACE_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/RingBuffer.h>
+#include <atomic>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#include <stdio.h>
+#endif
+
+#ifndef HAL_TRACE_BUFFER_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#define HAL_TRACE_BUFFER_SIZE 8192
+#else
+#define HAL_TRACE_BUFFER_SIZE 512
+#endif
+#endif
+
+#ifndef HAL_TRACE_FILE
+#define HAL_TRACE_FILE HAL_BOARD_LOG_DIRECTORY "/trace.json"
+#endif
+
+class AP_Trace {
+public:
+    AP_Trace();
+
+    /* Do not allow copies */
+    AP_Trace(const AP_Trace &other) = delete;
+    AP_Trace &operator=(const AP_Trace&) = delete;
+
+    static AP_Trace *get_singleton() { return _singleton; }
+
+    // allocate the ring and start draining it
+    void init(void);
+
+    // record a span of time, an instant or a counter value
+    void span(const char *name, uint64_t start_us, uint32_t duration_us);
+    void instant(const char *name);
+    void counter(const char *name, int32_t value);
+
+    // times from construction to destruction, see AP_TRACE_SCOPE
+    class Scope {
+    public:
+        Scope(const char *name) :
+            _trace(AP_Trace::get_singleton()),
+            _name(name),
+            _start_us(_trace != nullptr ? AP_HAL::micros64() : 0) {}
+        ~Scope() {
+            if (_trace != nullptr) {
+                _trace->span(_name, _start_us, AP_HAL::micros64() - _start_us);
+            }
+        }
+        Scope(const Scope &other) = delete;
+        Scope &operator=(const Scope&) = delete;
+    private:
+        AP_Trace *_trace;
+        const char *_name;
+        uint64_t _start_us;
+    };
+
+private:
+    static AP_Trace *_singleton;
+
+    enum class EventType : uint8_t {
+        SPAN = 0,
+        INSTANT = 1,
+        COUNTER = 2,
+    };
+
+    struct Event {
+        const char *name;
+        uint64_t time_us;
+        // duration of a span or value of a counter
+        int32_t value;
+        uint32_t thread;
+        EventType type;
+    };
+
+    void push(const char *name, uint64_t time_us, int32_t value, EventType type);
+    static uint32_t thread_id(void);
+
+    // drain the ring, called from the IO thread
+    void io_timer(void);
+    void write_event(const Event &event);
+
+    ObjectBuffer_LF<Event> _events;
+    std::atomic<uint32_t> _dropped;
+    uint32_t _dropped_reported;
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    FILE *_file;
+    uint32_t _last_open_ms;
+#endif
+};
+
+#define AP_TRACE_CONCAT2(a, b) a ## b
+#define AP_TRACE_CONCAT(a, b) AP_TRACE_CONCAT2(a, b)
+
+#define AP_TRACE_SCOPE(name) AP_Trace::Scope AP_TRACE_CONCAT(_ap_trace_scope_, __LINE__)(name)
+
+#define AP_TRACE_POINT(name) do {                           \
+        AP_Trace *_ap_trace = AP_Trace::get_singleton();    \
+        if (_ap_trace != nullptr) {                         \
+            _ap_trace->instant(name);                       \
+        }                                                   \
+    } while (0)
+
+#define AP_TRACE_COUNTER(name, value) do {                  \
+        AP_Trace *_ap_trace = AP_Trace::get_singleton();    \
+        if (_ap_trace != nullptr) {                         \
+            _ap_trace->counter(name, value);                \
+        }                                                   \
+    } while (0)
+
+#else // HAL_TRACE_ENABLED
+
+#define AP_TRACE_SCOPE(name)
+#define AP_TRACE_POINT(name) do {} while (0)
+#define AP_TRACE_COUNTER(name, value) do {} while (0)
+
+#endif // HAL_TRACE_ENABLED
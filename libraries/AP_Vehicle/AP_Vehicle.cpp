@@ -66,6 +66,12 @@ void AP_Vehicle::setup()
 
     load_parameters();
 
+#if HAL_TRACE_ENABLED
+    // start tracing before the libraries are initialised so their
+    // startup can be traced too
+    trace.init();
+#endif
+
     // initialise the main loop scheduler
     const AP_Scheduler::Task *tasks;
     uint8_t task_count;
@@ -43,6 +43,7 @@
 #include <AP_VisualOdom/AP_VisualOdom.h>
 #include <AP_RCTelemetry/AP_VideoTX.h>
 #include <AP_MSP/AP_MSP.h>
+#include <AP_Trace/AP_Trace.h>
 
 class AP_Vehicle : public AP_HAL::HAL::Callbacks {
 
@@ -279,6 +280,10 @@ protected:
     AP_Generator_RichenPower generator;
 #endif
 
+#if HAL_TRACE_ENABLED
+    AP_Trace trace;
+#endif
+
     static const struct AP_Param::GroupInfo var_info[];
     static const struct AP_Scheduler::Task scheduler_tasks[];
 
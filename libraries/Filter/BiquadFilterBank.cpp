@@ -0,0 +1,239 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BiquadFilterBank.h"
+
+#include <string.h>
+
+#if defined(__SSE__) || defined(__ARM_NEON)
+/*
+  x, y and z in one vector register, the compiler emits SSE or NEON
+  for the operators
+ */
+typedef float lanes __attribute__((vector_size(16)));
+
+static inline lanes load(const float *p)
+{
+    return *(const lanes *)p;
+}
+
+static inline void store(float *p, const lanes &v)
+{
+    *(lanes *)p = v;
+}
+
+static inline lanes broadcast(float f)
+{
+    return lanes{f, f, f, f};
+}
+
+static inline lanes from_vector(const Vector3f &v)
+{
+    return lanes{v.x, v.y, v.z, 0};
+}
+
+static inline Vector3f to_vector(const lanes &v)
+{
+    return Vector3f(v[0], v[1], v[2]);
+}
+#else
+/*
+  scalar fallback, three floats with the same arithmetic
+ */
+struct lanes {
+    float x, y, z;
+};
+
+static inline lanes operator+(const lanes &a, const lanes &b)
+{
+    return lanes{a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+static inline lanes operator-(const lanes &a, const lanes &b)
+{
+    return lanes{a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static inline lanes operator*(const lanes &a, const lanes &b)
+{
+    return lanes{a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+static inline lanes load(const float *p)
+{
+    return lanes{p[0], p[1], p[2]};
+}
+
+static inline void store(float *p, const lanes &v)
+{
+    p[0] = v.x;
+    p[1] = v.y;
+    p[2] = v.z;
+}
+
+static inline lanes broadcast(float f)
+{
+    return lanes{f, f, f};
+}
+
+static inline lanes from_vector(const Vector3f &v)
+{
+    return lanes{v.x, v.y, v.z};
+}
+
+static inline Vector3f to_vector(const lanes &v)
+{
+    return Vector3f(v.x, v.y, v.z);
+}
+#endif
+
+BiquadFilterBank::BiquadFilterBank()
+{
+    memset(_delay, 0, sizeof(_delay));
+    _num_stages = 0;
+}
+
+void BiquadFilterBank::set_num_stages(uint8_t num_stages)
+{
+    num_stages = MIN(num_stages, BIQUAD_FILTER_BANK_MAX_STAGES);
+    for (uint8_t i = _num_stages; i < num_stages; i++) {
+        _stages[i].type = StageType::DISABLED;
+    }
+    _num_stages = num_stages;
+}
+
+void BiquadFilterBank::set_notch(uint8_t stage, const NotchFilter<Vector3f> &filter)
+{
+    if (stage >= _num_stages) {
+        return;
+    }
+    stage_t &s = _stages[stage];
+    if (!filter.initialised) {
+        s.type = StageType::NOTCH_PASS_THRU;
+        return;
+    }
+    s.b0 = filter.b0;
+    s.b1 = filter.b1;
+    s.b2 = filter.b2;
+    s.a1 = filter.a1;
+    s.a2 = filter.a2;
+    s.a0_inv = filter.a0_inv;
+    s.type = StageType::NOTCH;
+}
+
+void BiquadFilterBank::set_low_pass(uint8_t stage, const LowPassFilter2p<Vector3f> &filter)
+{
+    if (stage >= _num_stages) {
+        return;
+    }
+    stage_t &s = _stages[stage];
+    const auto &params = filter._params;
+    if (is_zero(params.cutoff_freq) || is_zero(params.sample_freq)) {
+        // zero cutoff means pass-thru
+        s.type = StageType::DISABLED;
+        return;
+    }
+    s.b0 = params.b0;
+    s.b1 = params.b1;
+    s.b2 = params.b2;
+    s.a1 = params.a1;
+    s.a2 = params.a2;
+    s.type = StageType::LOW_PASS;
+}
+
+void BiquadFilterBank::set_harmonic_notch(uint8_t first_stage, uint8_t num_stages, const HarmonicNotchFilter<Vector3f> &filter)
+{
+    const uint8_t num_enabled = filter._initialised ? filter._num_enabled_filters : 0;
+    for (uint8_t i = 0; i < num_stages; i++) {
+        if (i < num_enabled) {
+            set_notch(first_stage + i, filter._filters[i]);
+        } else {
+            disable(first_stage + i);
+        }
+    }
+}
+
+void BiquadFilterBank::disable(uint8_t stage)
+{
+    if (stage < _num_stages) {
+        _stages[stage].type = StageType::DISABLED;
+    }
+}
+
+/*
+  apply a sample to each stage in turn and return the output
+ */
+Vector3f BiquadFilterBank::apply(const Vector3f &sample)
+{
+    lanes v = from_vector(sample);
+
+    for (uint8_t i = 0; i < _num_stages; i++) {
+        const stage_t &s = _stages[i];
+        float (&d)[4][4] = _delay[i];
+
+        switch (s.type) {
+        case StageType::DISABLED:
+            break;
+
+        case StageType::NOTCH: {
+            const lanes x1 = load(d[0]);
+            const lanes x2 = load(d[1]);
+            const lanes y1 = load(d[2]);
+            const lanes y2 = load(d[3]);
+            const lanes out = (v*broadcast(s.b0) + x1*broadcast(s.b1) + x2*broadcast(s.b2)
+                               - y1*broadcast(s.a1) - y2*broadcast(s.a2)) * broadcast(s.a0_inv);
+            store(d[1], x1);
+            store(d[0], v);
+            store(d[3], y1);
+            store(d[2], out);
+            v = out;
+            break;
+        }
+
+        case StageType::NOTCH_PASS_THRU:
+            store(d[1], load(d[0]));
+            store(d[0], v);
+            store(d[3], load(d[2]));
+            store(d[2], v);
+            break;
+
+        case StageType::LOW_PASS: {
+            const lanes d1 = load(d[0]);
+            const lanes d2 = load(d[1]);
+            const lanes d0 = v - d1*broadcast(s.a1) - d2*broadcast(s.a2);
+            v = d0*broadcast(s.b0) + d1*broadcast(s.b1) + d2*broadcast(s.b2);
+            store(d[1], d1);
+            store(d[0], d0);
+            break;
+        }
+        }
+    }
+
+    return to_vector(v);
+}
+
+/*
+  reset the delay elements. As with NotchFilter::reset() the last input
+  to a notch is kept
+ */
+void BiquadFilterBank::reset(void)
+{
+    for (uint8_t i = 0; i < BIQUAD_FILTER_BANK_MAX_STAGES; i++) {
+        memset(_delay[i][1], 0, sizeof(_delay[i]) - sizeof(_delay[i][0]));
+        if (_stages[i].type == StageType::LOW_PASS) {
+            memset(_delay[i][0], 0, sizeof(_delay[i][0]));
+        }
+    }
+}
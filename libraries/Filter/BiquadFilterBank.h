@@ -0,0 +1,92 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  a cascade of biquad filters applied to all three axes of a sample
+  together
+
+  Each stage takes its coefficients from a NotchFilter or
+  LowPassFilter2p, which remain responsible for the filter design, and
+  keeps its own delay elements. The x, y and z axes are held in one
+  vector register where SIMD is available, so each stage costs a
+  handful of vector operations rather than a call per filter. The
+  arithmetic is done in the same order as the source filters so the
+  output matches a chain of those filters to within rounding. It is
+  not bit-identical where the compiler contracts multiplies and adds
+  into FMA instructions differently for the two.
+ */
+
+#include <AP_Math/AP_Math.h>
+#include "NotchFilter.h"
+#include "HarmonicNotchFilter.h"
+#include "LowPassFilter2p.h"
+
+#ifndef BIQUAD_FILTER_BANK_MAX_STAGES
+#define BIQUAD_FILTER_BANK_MAX_STAGES (HNF_MAX_FILTERS + 2)
+#endif
+
+class BiquadFilterBank {
+public:
+    BiquadFilterBank();
+
+    // set the number of stages, new stages start disabled
+    void set_num_stages(uint8_t num_stages);
+    uint8_t num_stages(void) const { return _num_stages; }
+
+    // take the coefficients for a stage from a filter, keeping the
+    // stage's delay elements
+    void set_notch(uint8_t stage, const NotchFilter<Vector3f> &filter);
+    void set_low_pass(uint8_t stage, const LowPassFilter2p<Vector3f> &filter);
+
+    // take the coefficients for num_stages stages from a harmonic
+    // notch, disabling any stages it isn't using
+    void set_harmonic_notch(uint8_t first_stage, uint8_t num_stages, const HarmonicNotchFilter<Vector3f> &filter);
+
+    // skip a stage, leaving its delay elements untouched
+    void disable(uint8_t stage);
+
+    // apply a sample to each stage in turn
+    Vector3f apply(const Vector3f &sample);
+
+    // reset the delay elements of all stages
+    void reset(void);
+
+private:
+    enum class StageType : uint8_t {
+        DISABLED = 0,
+        // direct form I notch, see NotchFilter::apply()
+        NOTCH,
+        // uninitialised notch, passes the sample through but updates
+        // the delay elements
+        NOTCH_PASS_THRU,
+        // direct form II low pass, see DigitalBiquadFilter::apply()
+        LOW_PASS,
+    };
+
+    struct stage_t {
+        float b0, b1, b2;
+        float a1, a2;
+        float a0_inv;
+        StageType type;
+    } _stages[BIQUAD_FILTER_BANK_MAX_STAGES];
+
+    // delay elements for each stage, each of x, y, z and a spare lane
+    // so a row fills a vector register. A notch uses all four rows
+    // for its last two inputs and outputs, a low pass only the first two
+    float _delay[BIQUAD_FILTER_BANK_MAX_STAGES][4][4] __attribute__((aligned(16)));
+
+    uint8_t _num_stages;
+};
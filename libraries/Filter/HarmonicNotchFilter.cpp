@@ -16,7 +16,6 @@
 #include "HarmonicNotchFilter.h"
 #include <GCS_MAVLink/GCS.h>
 
-#define HNF_MAX_FILTERS 6 // must be even for double-notch filters
 #define HNF_MAX_HARMONICS 8
 
 // table of user settable parameters
@@ -55,7 +54,7 @@ const AP_Param::GroupInfo HarmonicNotchFilterParams::var_info[] = {
 
     // @Param: HMNCS
     // @DisplayName: Harmonic Notch Filter harmonics
-    // @Description: Bitmask of harmonic frequencies to apply Harmonic Notch Filter to. This option takes effect on the next reboot. A maximum of 3 harmonics can be used at any one time.
+    // @Description: Bitmask of harmonic frequencies to apply Harmonic Notch Filter to. This option takes effect on the next reboot. With the dynamic harmonic option these harmonics are applied to each motor's frequency, if there are too many notches in total the higher harmonics are dropped.
     // @Bitmask: 0:1st harmonic,1:2nd harmonic,2:3rd harmonic,3:4th hamronic,4:5th harmonic,5:6th harmonic,6:7th harmonic,7:8th harmonic
     // @User: Advanced
     // @RebootRequired: True
@@ -79,7 +78,7 @@ const AP_Param::GroupInfo HarmonicNotchFilterParams::var_info[] = {
 
     // @Param: OPTS
     // @DisplayName: Harmonic Notch Filter options
-    // @Description: Harmonic Notch Filter options.
+    // @Description: Harmonic Notch Filter options. Dynamic harmonic places a set of notches on each motor's frequency, as reported by ESC telemetry, or on each noise peak found by the dynamic FFT, rather than on a single fundamental.
     // @Bitmask: 0:Double notch,1:Dynamic harmonic
     // @User: Advanced
     // @RebootRequired: True
@@ -133,21 +132,24 @@ void HarmonicNotchFilter<T>::init(float sample_freq_hz, float center_freq_hz, fl
 }
 
 /*
-  allocate a collection of, at most HNF_MAX_FILTERS, notch filters to be managed by this harmonic notch filter
+  allocate a collection of notch filters to be managed by this harmonic notch filter, one
+  for each harmonic of each center frequency. At most HNF_MAX_FILTERS are allocated, when
+  there are more notches than that the higher harmonics are dropped
  */
 template <class T>
-void HarmonicNotchFilter<T>::allocate_filters(uint8_t harmonics, bool double_notch)
+void HarmonicNotchFilter<T>::allocate_filters(uint8_t num_centers, uint8_t harmonics, bool double_notch)
 {
     _double_notch = double_notch;
 
-    for (uint8_t i = 0; i < HNF_MAX_HARMONICS && _num_filters < HNF_MAX_FILTERS; i++) {
+    uint8_t num_harmonics = 0;
+    for (uint8_t i = 0; i < HNF_MAX_HARMONICS; i++) {
         if ((1U<<i) & harmonics) {
-            _num_filters++;
-            if (_double_notch) {
-                _num_filters++;
-            }
+            num_harmonics++;
         }
     }
+    const uint16_t num_filters = num_centers * num_harmonics * (_double_notch ? 2 : 1);
+    _num_filters = MIN(num_filters, HNF_MAX_FILTERS);
+
     if (_num_filters > 0) {
         _filters = new NotchFilter<T>[_num_filters];
         if (_filters == nullptr) {
@@ -166,39 +168,7 @@ void HarmonicNotchFilter<T>::allocate_filters(uint8_t harmonics, bool double_not
 template <class T>
 void HarmonicNotchFilter<T>::update(float center_freq_hz)
 {
-    if (!_initialised) {
-        return;
-    }
-
-    // adjust the fundamental center frequency to be in the allowable range
-    const float nyquist_limit = _sample_freq_hz * 0.48f;
-    center_freq_hz = constrain_float(center_freq_hz, 1.0f, nyquist_limit);
-
-    _num_enabled_filters = 0;
-    // update all of the filters using the new center frequency and existing A & Q
-    for (uint8_t i = 0; i < HNF_MAX_HARMONICS && _num_enabled_filters < _num_filters; i++) {
-        if ((1U<<i) & _harmonics) {
-            const float notch_center = center_freq_hz * (i+1);
-            if (!_double_notch) {
-                // only enable the filter if its center frequency is below the nyquist frequency
-                if (notch_center < nyquist_limit) {
-                    _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q);
-                }
-            } else {
-                float notch_center_double;
-                // only enable the filter if its center frequency is below the nyquist frequency
-                notch_center_double = notch_center * (1.0 - _notch_spread);
-                if (notch_center_double < nyquist_limit) {
-                    _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-                }
-                // only enable the filter if its center frequency is below the nyquist frequency
-                notch_center_double = notch_center * (1.0 + _notch_spread);
-                if (notch_center_double < nyquist_limit) {
-                    _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-                }
-            }
-        }
-    }
+    update(1, &center_freq_hz);
 }
 
 /*
@@ -216,26 +186,43 @@ void HarmonicNotchFilter<T>::update(uint8_t num_centers, const float center_freq
     const float nyquist_limit = _sample_freq_hz * 0.48f;
 
     _num_enabled_filters = 0;
-    // update all of the filters using the new center frequencies and existing A & Q
-    for (uint8_t i = 0; i < HNF_MAX_HARMONICS && i < num_centers && _num_enabled_filters < _num_filters; i++) {
-        const float notch_center = constrain_float(center_freq_hz[i], 1.0f, nyquist_limit);
-        if (!_double_notch) {
-            // only enable the filter if its center frequency is below the nyquist frequency
-            if (notch_center < nyquist_limit) {
-                _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q);
-            }
-        } else {
-            float notch_center_double;
-            // only enable the filter if its center frequency is below the nyquist frequency
-            notch_center_double = notch_center * (1.0 - _notch_spread);
-            if (notch_center_double < nyquist_limit) {
-                _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-            }
-            // only enable the filter if its center frequency is below the nyquist frequency
-            notch_center_double = notch_center * (1.0 + _notch_spread);
-            if (notch_center_double < nyquist_limit) {
-                _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
-            }
+    // update all of the filters using the new center frequencies and existing A & Q. The
+    // fundamental of every center is placed before any second harmonic and so on, so if
+    // there are too few filters it is the higher harmonics that are dropped
+    for (uint8_t i = 0; i < HNF_MAX_HARMONICS && _num_enabled_filters < _num_filters; i++) {
+        if (!((1U<<i) & _harmonics)) {
+            continue;
+        }
+        for (uint8_t c = 0; c < num_centers && _num_enabled_filters < _num_filters; c++) {
+            const float notch_center = constrain_float(center_freq_hz[c], 1.0f, nyquist_limit) * (i+1);
+            enable_notch(notch_center, nyquist_limit);
+        }
+    }
+}
+
+/*
+  enable the next filter, or pair of filters for a double-notch, at the given frequency
+ */
+template <class T>
+void HarmonicNotchFilter<T>::enable_notch(float notch_center, float nyquist_limit)
+{
+    if (!_double_notch) {
+        // only enable the filter if its center frequency is below the nyquist frequency
+        if (notch_center < nyquist_limit) {
+            _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center, _A, _Q);
+        }
+    } else {
+        float notch_center_double;
+        // only enable the filter if its center frequency is below the nyquist frequency
+        notch_center_double = notch_center * (1.0 - _notch_spread);
+        if (notch_center_double < nyquist_limit) {
+            _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
+        }
+        // only enable the filter if its center frequency is below the nyquist frequency, an earlier
+        // pair may have only had room for one filter below nyquist so check there is still space
+        notch_center_double = notch_center * (1.0 + _notch_spread);
+        if (notch_center_double < nyquist_limit && _num_enabled_filters < _num_filters) {
+            _filters[_num_enabled_filters++].init_with_A_and_Q(_sample_freq_hz, notch_center_double, _A, _Q);
         }
     }
 }
@@ -20,7 +20,16 @@
 #include "NotchFilter.h"
 
 #define HNF_MAX_HARMONICS 8
-#define HNF_MAX_HMNC_BITSET 0xF
+
+// the most notches of any harmonic notch, bounding the cost of a
+// notch set per motor. Must be even for double-notch filters
+#ifndef HNF_MAX_FILTERS
+#if HAL_MINIMIZE_FEATURES
+#define HNF_MAX_FILTERS 6
+#else
+#define HNF_MAX_FILTERS 16
+#endif
+#endif
 
 /*
   a filter that manages a set of notch filters targetted at a fundamental center frequency
@@ -28,15 +37,17 @@
  */
 template <class T>
 class HarmonicNotchFilter {
+    friend class BiquadFilterBank;
 public:
     ~HarmonicNotchFilter();
-    // allocate a bank of notch filters for this harmonic notch filter
-    void allocate_filters(uint8_t harmonics, bool double_notch);
+    // allocate a bank of notch filters for this harmonic notch filter,
+    // with the harmonics for each of up to num_centers center frequencies
+    void allocate_filters(uint8_t num_centers, uint8_t harmonics, bool double_notch);
     // initialize the underlying filters using the provided filter parameters
     void init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB);
     // update the underlying filters' center frequencies using center_freq_hz as the fundamental
     void update(float center_freq_hz);
-    // update all o fthe underlying center frequencies individually
+    // update the underlying filters' center frequencies with the harmonics of each of the center frequencies
     void update(uint8_t num_centers, const float center_freq_hz[]);
     // apply a sample to each of the underlying filters in turn
     T apply(const T &sample);
@@ -44,6 +55,9 @@ public:
     void reset();
 
 private:
+    // enable the next one or two filters at notch_center
+    void enable_notch(float notch_center, float nyquist_limit);
+
     // underlying bank of notch filters
     NotchFilter<T>*  _filters;
     // sample frequency for each filter
@@ -88,7 +102,7 @@ public:
     // set the fundamental center frequency of the harmonic notch
     void set_center_freq_hz(float center_freq) { _center_freq_hz.set(center_freq); }
     // harmonics enabled on the harmonic notch
-    uint8_t harmonics(void) const { return hasOption(Options::DynamicHarmonic) ? HNF_MAX_HMNC_BITSET : _harmonics; }
+    uint8_t harmonics(void) const { return _harmonics; }
     // reference value of the harmonic notch
     float reference(void) const { return _reference; }
     // notch options
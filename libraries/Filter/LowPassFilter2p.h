@@ -48,6 +48,7 @@ private:
 
 template <class T>
 class LowPassFilter2p {
+    friend class BiquadFilterBank;
 public:
     LowPassFilter2p();
     // constructor
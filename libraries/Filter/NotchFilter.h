@@ -28,6 +28,7 @@
 
 template <class T>
 class NotchFilter {
+    friend class BiquadFilterBank;
 public:
     // set parameters
     void init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB);
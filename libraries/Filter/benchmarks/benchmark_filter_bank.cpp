@@ -0,0 +1,75 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <Filter/BiquadFilterBank.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  cost of filtering a gyro sample through the notch, harmonic notch
+  and low pass filters, comparing the filters applied one at a time
+  against the filter bank. The arguments are the harmonics bitmask,
+  whether to use double notches and the number of motors with their
+  own notch set
+ */
+struct GyroFilters {
+    GyroFilters(uint8_t harmonics, bool double_notch, uint8_t num_motors) {
+        const float sample_rate = 1000;
+        notch.init(sample_rate, 45, 10, 40);
+        // each motor needs at least one notch, so there can't be more
+        // motors with notches than filters
+        float motors[HNF_MAX_FILTERS];
+        num_motors = MIN(num_motors, ARRAY_SIZE(motors));
+        harmonic.allocate_filters(num_motors, harmonics, double_notch);
+        harmonic.init(sample_rate, 80, 40, 30);
+        for (uint8_t i = 0; i < num_motors; i++) {
+            motors[i] = 80 + 3*i;
+        }
+        harmonic.update(num_motors, motors);
+        low_pass.set_cutoff_frequency(sample_rate, 100);
+
+        bank.set_num_stages(HNF_MAX_FILTERS + 2);
+        bank.set_notch(0, notch);
+        bank.set_harmonic_notch(1, HNF_MAX_FILTERS, harmonic);
+        bank.set_low_pass(HNF_MAX_FILTERS + 1, low_pass);
+    }
+
+    NotchFilterVector3f notch;
+    HarmonicNotchFilterVector3f harmonic;
+    LowPassFilter2pVector3f low_pass;
+    BiquadFilterBank bank;
+};
+
+static void BM_FilterChain(benchmark::State& state)
+{
+    // the filters rely on zeroed memory
+    GyroFilters *f = new GyroFilters(state.range(0), state.range(1), state.range(2));
+    Vector3f sample(0.1f, -0.2f, 0.3f);
+
+    while (state.KeepRunning()) {
+        Vector3f v = f->notch.apply(sample);
+        v = f->harmonic.apply(v);
+        v = f->low_pass.apply(v);
+        gbenchmark_escape(&v);
+        sample.x = -sample.x;
+    }
+    delete f;
+}
+
+static void BM_FilterBank(benchmark::State& state)
+{
+    GyroFilters *f = new GyroFilters(state.range(0), state.range(1), state.range(2));
+    Vector3f sample(0.1f, -0.2f, 0.3f);
+
+    while (state.KeepRunning()) {
+        Vector3f v = f->bank.apply(sample);
+        gbenchmark_escape(&v);
+        sample.x = -sample.x;
+    }
+    delete f;
+}
+
+BENCHMARK(BM_FilterChain)->Args({1, 0, 1})->Args({3, 0, 1})->Args({7, 0, 1})->Args({7, 1, 1})->Args({1, 0, 4})->Args({3, 0, 8});
+BENCHMARK(BM_FilterBank)->Args({1, 0, 1})->Args({3, 0, 1})->Args({7, 0, 1})->Args({7, 1, 1})->Args({1, 0, 4})->Args({3, 0, 8});
+
+BENCHMARK_MAIN();
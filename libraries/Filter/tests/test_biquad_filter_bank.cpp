@@ -0,0 +1,203 @@
+#include <AP_gtest.h>
+
+#include <Filter/BiquadFilterBank.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const float sample_rate = 1000;
+
+// a test signal with a different mix of frequencies on each axis
+static Vector3f test_sample(uint16_t i)
+{
+    const float t = i / sample_rate;
+    return Vector3f(sinf(2*M_PI*80*t) + 0.3f*sinf(2*M_PI*160*t),
+                    0.5f*sinf(2*M_PI*120*t) + 0.1f*cosf(2*M_PI*400*t),
+                    cosf(2*M_PI*45*t) - 0.2f*sinf(2*M_PI*240*t));
+}
+
+static void expect_same(const Vector3f &expected, const Vector3f &v)
+{
+    EXPECT_EQ(expected.x, v.x);
+    EXPECT_EQ(expected.y, v.y);
+    EXPECT_EQ(expected.z, v.z);
+}
+
+// the compiler may contract multiplies and adds into FMA instructions
+// differently for the bank and the filters, so they only agree to
+// within rounding
+static void expect_close(const Vector3f &expected, const Vector3f &v)
+{
+    const float tolerance = 1.0e-5f;
+    EXPECT_NEAR(expected.x, v.x, tolerance);
+    EXPECT_NEAR(expected.y, v.y, tolerance);
+    EXPECT_NEAR(expected.z, v.z, tolerance);
+}
+
+/*
+  the filters as applied one at a time by AP_InertialSensor, next to
+  the bank configured from them in the same way. The filters rely on
+  zeroed memory so this must be created with new
+ */
+class FilterChain {
+public:
+    FilterChain(uint8_t harmonics, bool double_notch, uint8_t num_centers = 1) {
+        harmonic.allocate_filters(num_centers, harmonics, double_notch);
+        bank.set_num_stages(HNF_MAX_FILTERS + 2);
+    }
+
+    void configure(bool notch_enabled, bool harmonic_enabled) {
+        _notch_enabled = notch_enabled;
+        _harmonic_enabled = harmonic_enabled;
+        if (notch_enabled) {
+            bank.set_notch(0, notch);
+        } else {
+            bank.disable(0);
+        }
+        if (harmonic_enabled) {
+            bank.set_harmonic_notch(1, HNF_MAX_FILTERS, harmonic);
+        } else {
+            for (uint8_t i = 0; i < HNF_MAX_FILTERS; i++) {
+                bank.disable(1 + i);
+            }
+        }
+        bank.set_low_pass(HNF_MAX_FILTERS + 1, low_pass);
+    }
+
+    Vector3f apply(const Vector3f &sample) {
+        Vector3f v = sample;
+        if (_notch_enabled) {
+            v = notch.apply(v);
+        }
+        if (_harmonic_enabled) {
+            v = harmonic.apply(v);
+        }
+        return low_pass.apply(v);
+    }
+
+    void reset() {
+        low_pass.reset();
+        notch.reset();
+        harmonic.reset();
+        bank.reset();
+    }
+
+    // run both for a number of samples, checking they agree
+    void run(uint16_t start, uint16_t count) {
+        for (uint16_t i = start; i < start + count; i++) {
+            const Vector3f sample = test_sample(i);
+            const Vector3f expected = apply(sample);
+            expect_close(expected, bank.apply(sample));
+        }
+    }
+
+    NotchFilterVector3f notch;
+    HarmonicNotchFilterVector3f harmonic;
+    LowPassFilter2pVector3f low_pass;
+    BiquadFilterBank bank;
+
+private:
+    bool _notch_enabled;
+    bool _harmonic_enabled;
+};
+
+TEST(BiquadFilterBankTest, LowPassOnly)
+{
+    FilterChain *chain = new FilterChain(0, false);
+    chain->low_pass.set_cutoff_frequency(sample_rate, 20);
+    chain->configure(false, false);
+    chain->run(0, 500);
+    delete chain;
+}
+
+TEST(BiquadFilterBankTest, PassThru)
+{
+    FilterChain *chain = new FilterChain(0, false);
+    chain->configure(false, false);
+    for (uint16_t i = 0; i < 10; i++) {
+        const Vector3f sample = test_sample(i);
+        expect_same(sample, chain->bank.apply(sample));
+    }
+    delete chain;
+}
+
+TEST(BiquadFilterBankTest, UninitialisedNotch)
+{
+    // an uninitialised notch passes samples through but keeps its
+    // delay elements up to date
+    FilterChain *chain = new FilterChain(1, false);
+    chain->low_pass.set_cutoff_frequency(sample_rate, 100);
+    chain->configure(true, true);
+    chain->run(0, 100);
+
+    chain->notch.init(sample_rate, 80, 20, 40);
+    chain->harmonic.init(sample_rate, 120, 40, 30);
+    chain->configure(true, true);
+    chain->run(100, 400);
+    delete chain;
+}
+
+TEST(BiquadFilterBankTest, HarmonicNotch)
+{
+    const uint8_t harmonics[] { 1, 3, 7, 0xF };
+    for (const uint8_t h : harmonics) {
+        for (uint8_t double_notch = 0; double_notch < 2; double_notch++) {
+            FilterChain *chain = new FilterChain(h, double_notch);
+            chain->notch.init(sample_rate, 45, 10, 40);
+            chain->harmonic.init(sample_rate, 80, 40, 30);
+            chain->low_pass.set_cutoff_frequency(sample_rate, 100);
+            chain->configure(true, true);
+            chain->run(0, 300);
+
+            // move the harmonics, keeping the filter state
+            chain->harmonic.update(120);
+            chain->configure(true, true);
+            chain->run(300, 300);
+
+            // move the harmonics so some are above nyquist
+            chain->harmonic.update(200);
+            chain->configure(true, true);
+            chain->run(600, 300);
+            delete chain;
+        }
+    }
+}
+
+TEST(BiquadFilterBankTest, PerMotorNotch)
+{
+    // an octocopter with a notch set on each motor, using all of the filters
+    const float motors[] { 80, 83, 86, 90, 95, 99, 104, 110 };
+    FilterChain *chain = new FilterChain(3, false, ARRAY_SIZE(motors));
+    chain->harmonic.init(sample_rate, 80, 20, 30);
+    chain->harmonic.update(ARRAY_SIZE(motors), motors);
+    chain->low_pass.set_cutoff_frequency(sample_rate, 100);
+    chain->configure(false, true);
+    chain->run(0, 300);
+
+    const float faster[] { 90, 93, 96, 100, 105, 109, 114, 120 };
+    chain->harmonic.update(ARRAY_SIZE(faster), faster);
+    chain->configure(false, true);
+    chain->run(300, 300);
+    delete chain;
+}
+
+TEST(BiquadFilterBankTest, EnableAndReset)
+{
+    FilterChain *chain = new FilterChain(3, false);
+    chain->notch.init(sample_rate, 45, 10, 40);
+    chain->harmonic.init(sample_rate, 80, 40, 30);
+    chain->low_pass.set_cutoff_frequency(sample_rate, 100);
+    chain->configure(true, false);
+    chain->run(0, 200);
+
+    chain->configure(false, true);
+    chain->run(200, 200);
+
+    chain->configure(true, true);
+    chain->run(400, 200);
+
+    chain->reset();
+    chain->run(600, 200);
+    delete chain;
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,76 @@
+#include <AP_gtest.h>
+
+#include <Filter/HarmonicNotchFilter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const float sample_rate = 1000;
+
+// ratio of the output to the input amplitude of a sine wave at freq_hz,
+// once the filter has settled
+static float gain(HarmonicNotchFilterVector3f &filter, float freq_hz)
+{
+    filter.reset();
+    float in_sq = 0, out_sq = 0;
+    for (uint16_t i = 0; i < 2000; i++) {
+        const float x = sinf(2*M_PI*freq_hz*i/sample_rate);
+        const Vector3f out = filter.apply(Vector3f(x, x, x));
+        if (i >= 1000) {
+            in_sq += x*x;
+            out_sq += out.x*out.x;
+        }
+    }
+    return sqrtf(out_sq / in_sq);
+}
+
+TEST(HarmonicNotchFilterTest, PerMotorNotches)
+{
+    // an octocopter with each motor at a different speed
+    const float motors[] { 50, 54, 58, 62, 66, 70, 74, 78 };
+    HarmonicNotchFilterVector3f *filter = new HarmonicNotchFilterVector3f();
+    filter->allocate_filters(ARRAY_SIZE(motors), 1, false);
+    filter->init(sample_rate, 50, 10, 30);
+    filter->update(ARRAY_SIZE(motors), motors);
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(motors) && i < HNF_MAX_FILTERS; i++) {
+        EXPECT_LT(gain(*filter, motors[i]), 0.1f);
+    }
+    // well away from the motors
+    EXPECT_GT(gain(*filter, 200), 0.9f);
+    delete filter;
+}
+
+TEST(HarmonicNotchFilterTest, HarmonicsPerMotor)
+{
+    // with more notches than filters the highest harmonics are dropped
+    const float motors[] { 50, 54, 58, 62, 66, 70, 74, 78 };
+    HarmonicNotchFilterVector3f *filter = new HarmonicNotchFilterVector3f();
+    filter->allocate_filters(ARRAY_SIZE(motors), 7, false);
+    filter->init(sample_rate, 50, 10, 30);
+    filter->update(ARRAY_SIZE(motors), motors);
+
+    if (HNF_MAX_FILTERS >= 2*ARRAY_SIZE(motors)) {
+        for (const float f : motors) {
+            EXPECT_LT(gain(*filter, 2*f), 0.1f);
+        }
+    }
+    if (HNF_MAX_FILTERS < 3*ARRAY_SIZE(motors)) {
+        EXPECT_GT(gain(*filter, 3*motors[ARRAY_SIZE(motors)-1]), 0.9f);
+    }
+    delete filter;
+}
+
+TEST(HarmonicNotchFilterTest, SingleCenter)
+{
+    // one center frequency has a notch on each harmonic
+    HarmonicNotchFilterVector3f *filter = new HarmonicNotchFilterVector3f();
+    filter->allocate_filters(1, 3, false);
+    filter->init(sample_rate, 60, 10, 30);
+
+    EXPECT_LT(gain(*filter, 60), 0.1f);
+    EXPECT_LT(gain(*filter, 120), 0.1f);
+    EXPECT_GT(gain(*filter, 180), 0.9f);
+    delete filter;
+}
+
+AP_GTEST_MAIN()
@@ -84,6 +84,9 @@ public:
 
     // saveable rate of each stream
     AP_Int16        streamRates[GCS_MAVLINK_NUM_STREAM_RATES];
+
+    // bitmask of streams which are slowed down last when the link is congested
+    AP_Int16        priority_streams;
 };
 
 ///
@@ -367,6 +370,9 @@ protected:
     // saveable rate of each stream
     AP_Int16        *streamRates;
 
+    // bitmask of streams which are slowed down last when the link is congested
+    AP_Int16        *priority_streams;
+
     virtual bool persist_streamrates() const { return false; }
     void handle_request_data_stream(const mavlink_message_t &msg);
 
@@ -607,6 +613,7 @@ private:
         Bitmask<MSG_LAST> ap_message_ids;
         uint16_t interval_ms;
         uint16_t last_sent_ms; // from AP_HAL::millis16()
+        bool priority;         // holds messages from priority streams
     };
     deferred_message_bucket_t deferred_message_bucket[10];
     static const uint8_t no_bucket_to_send = -1;
@@ -657,6 +664,32 @@ private:
     // the interval specified in "deferred"
     uint16_t get_reschedule_interval_ms(const deferred_message_bucket_t &deferred) const;
 
+    // returns true if id is in one of the streams in priority_streams
+    bool is_priority_message(const ap_message id) const;
+    // priority_streams the deferred message buckets were filled with
+    uint16_t bucketed_priority_streams;
+    // move messages to buckets of the right priority if priority_streams has changed
+    void update_message_priorities();
+
+    // adaptive stream scheduling. The link bandwidth is estimated from
+    // how fast the UART drains, and bucket intervals are scaled up
+    // while messages are being dropped or the transmit buffer is
+    // mostly full. Priority streams are only slowed down once the
+    // other streams have been slowed as far as they go, and are the
+    // first to speed up again
+    struct {
+        uint32_t last_update_ms;
+        uint32_t drained_bytes;     // bytes sent by the UART this period
+        uint32_t bandwidth_Bps;     // filtered estimate of bytes sent per second
+        uint16_t last_out_of_space_count;
+        uint16_t last_txspace;      // txspace at the end of the last update_send
+        uint16_t min_txspace;       // smallest txspace seen this period
+        uint16_t max_txspace;       // largest txspace seen, estimate of the buffer size
+        float scale = 1;            // interval scale for normal streams
+        float priority_scale = 1;   // interval scale for priority streams
+    } link_congestion;
+    void update_link_congestion();
+
     bool do_try_send_message(const ap_message id);
 
     // time when we missed sending a parameter for GCS
@@ -765,6 +798,26 @@ private:
         int16_t current_session;
         uint32_t last_send_ms;
         uint8_t need_banner_send_mask;
+
+        // burst read being streamed into the reply queue by the worker,
+        // interleaved with servicing re-requests for missed chunks
+        struct {
+            pending_ftp reply;      // template for the next chunk
+            uint32_t offset;        // file offset of the next chunk
+            uint16_t remaining;     // chunks left in this burst
+            uint8_t max_read;       // chunk size
+            bool need_seek;         // file offset was moved by another request
+            bool active;
+        } burst;
+
+        // read throughput statistics for the current session
+        struct {
+            uint32_t start_ms;
+            uint32_t last_ms;
+            uint32_t bytes;
+            uint16_t rereads;       // single chunk reads during a burst download
+            bool burst_used;
+        } stats;
     };
     static struct ftp_state ftp;
 
@@ -777,6 +830,9 @@ private:
     void send_ftp_replies(void);
     void ftp_worker(void);
     void ftp_push_replies(pending_ftp &reply);
+    bool ftp_burst_step(void);
+    void ftp_close_file(void);
+    void ftp_read_stats(uint32_t bytes);
 
     void send_distance_sensor(const class AP_RangeFinder_Backend *sensor, const uint8_t instance) const;
 
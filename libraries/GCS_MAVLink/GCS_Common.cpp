@@ -93,6 +93,7 @@ GCS_MAVLINK::GCS_MAVLINK(GCS_MAVLINK_Parameters &parameters,
     _port = &uart;
 
     streamRates = parameters.streamRates;
+    priority_streams = &parameters.priority_streams;
 }
 
 bool GCS_MAVLINK::init(uint8_t instance)
@@ -867,6 +868,9 @@ uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t
 
     interval_ms += stream_slowdown_ms;
 
+    // slow messages down to fit the link, priority streams last
+    interval_ms = uint32_t(interval_ms * (deferred.priority ? link_congestion.priority_scale : link_congestion.scale));
+
     // slow most messages down if we're transfering parameters or
     // waypoints:
     if (_queued_parameter) {
@@ -1056,6 +1060,9 @@ void GCS_MAVLINK::update_send()
         AP::logger().handle_log_send();
     }
 
+    // estimate the link state before FTP replies use up the txspace
+    update_link_congestion();
+
     send_ftp_replies();
 
     if (!deferred_messages_initialised) {
@@ -1063,6 +1070,8 @@ void GCS_MAVLINK::update_send()
         deferred_messages_initialised = true;
     }
 
+    update_message_priorities();
+
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     uint32_t retry_deferred_body_start = AP_HAL::micros();
 #endif
@@ -1161,6 +1170,99 @@ void GCS_MAVLINK::update_send()
         send_packet_count += uint8_t(status->current_tx_seq - last_tx_seq);
         last_tx_seq = status->current_tx_seq;
     }
+
+    link_congestion.last_txspace = txspace();
+}
+
+// maximum scaling of stream intervals when the link is congested
+#define GCS_LINK_SCALE_MAX 8.0f
+#define GCS_LINK_PRIORITY_SCALE_MAX 4.0f
+
+/*
+  estimate the link bandwidth and how congested it is, adjusting the
+  scaling of stream intervals to suit
+ */
+void GCS_MAVLINK::update_link_congestion()
+{
+    const uint16_t space = txspace();
+
+    // anything above the space we left at the end of the last
+    // update_send has been sent by the UART since
+    if (space > link_congestion.last_txspace) {
+        link_congestion.drained_bytes += space - link_congestion.last_txspace;
+    }
+    link_congestion.last_txspace = space;
+    link_congestion.min_txspace = MIN(link_congestion.min_txspace, space);
+    link_congestion.max_txspace = MAX(link_congestion.max_txspace, space);
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (link_congestion.last_update_ms == 0) {
+        // first call, start the first period
+        link_congestion.last_update_ms = now_ms;
+        link_congestion.min_txspace = space;
+        return;
+    }
+    const uint32_t dt_ms = now_ms - link_congestion.last_update_ms;
+    if (dt_ms < 200) {
+        return;
+    }
+
+    const uint32_t bandwidth_Bps = link_congestion.drained_bytes * 1000U / dt_ms;
+    link_congestion.bandwidth_Bps = (link_congestion.bandwidth_Bps * 3 + bandwidth_Bps) / 4;
+
+    const uint16_t drops = out_of_space_to_send_count - link_congestion.last_out_of_space_count;
+    const uint16_t max_space = link_congestion.max_txspace;
+    const bool mostly_full = link_congestion.min_txspace < max_space / 4;
+    const bool mostly_empty = link_congestion.min_txspace > (max_space / 4) * 3;
+
+    if (drops > 0 || mostly_full) {
+        // slow down, normal streams first
+        if (link_congestion.scale < GCS_LINK_SCALE_MAX) {
+            link_congestion.scale = MIN(link_congestion.scale * 1.25f, GCS_LINK_SCALE_MAX);
+        } else {
+            link_congestion.priority_scale = MIN(link_congestion.priority_scale * 1.25f, GCS_LINK_PRIORITY_SCALE_MAX);
+        }
+    } else if (mostly_empty) {
+        // speed up, priority streams first
+        if (link_congestion.priority_scale > 1) {
+            link_congestion.priority_scale = MAX(link_congestion.priority_scale * 0.9f, 1.0f);
+        } else {
+            link_congestion.scale = MAX(link_congestion.scale * 0.9f, 1.0f);
+        }
+    }
+
+    link_congestion.last_update_ms = now_ms;
+    link_congestion.last_out_of_space_count = out_of_space_to_send_count;
+    link_congestion.drained_bytes = 0;
+    link_congestion.min_txspace = space;
+}
+
+/*
+  messages are kept in buckets of the same stream priority, so move
+  them when the priority streams are changed
+ */
+void GCS_MAVLINK::update_message_priorities()
+{
+    const uint16_t prio = priority_streams->get();
+    if (prio == bucketed_priority_streams) {
+        return;
+    }
+    bucketed_priority_streams = prio;
+
+    for (uint8_t i=0; i<MSG_LAST; i++) {
+        const ap_message id = (ap_message)i;
+        for (uint8_t j=0; j<ARRAY_SIZE(deferred_message_bucket); j++) {
+            const deferred_message_bucket_t &bucket = deferred_message_bucket[j];
+            if (!bucket.ap_message_ids.get(id)) {
+                continue;
+            }
+            if (bucket.priority != is_priority_message(id)) {
+                // re-setting the interval picks a bucket of the right priority
+                set_ap_message_interval(id, bucket.interval_ms);
+            }
+            break;
+        }
+    }
 }
 
 void GCS_MAVLINK::remove_message_from_bucket(int8_t bucket, ap_message id)
@@ -1217,9 +1319,15 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
         return true;
     }
 
-    // see which bucket has the closest interval:
+    // priority stream messages are kept in separate buckets so they
+    // can be scaled separately when the link is congested
+    const bool priority = is_priority_message(id);
+
+    // see which bucket of the same priority has the closest interval:
     int8_t closest_bucket = -1;
     uint16_t closest_bucket_interval_delta = UINT16_MAX;
+    int8_t closest_any_bucket = -1;
+    uint16_t closest_any_bucket_interval_delta = UINT16_MAX;
     int8_t in_bucket = -1;
     int8_t empty_bucket_id = -1;
     for (uint8_t i=0; i<ARRAY_SIZE(deferred_message_bucket); i++) {
@@ -1240,6 +1348,13 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
             in_bucket = i;
         }
         const uint16_t interval_delta = abs(bucket.interval_ms - interval_ms);
+        if (interval_delta < closest_any_bucket_interval_delta) {
+            closest_any_bucket = i;
+            closest_any_bucket_interval_delta = interval_delta;
+        }
+        if (bucket.priority != priority) {
+            continue;
+        }
         if (interval_delta < closest_bucket_interval_delta) {
             closest_bucket = i;
             closest_bucket_interval_delta = interval_delta;
@@ -1270,6 +1385,12 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
         }
     }
 
+    if (closest_bucket == -1 && empty_bucket_id == -1) {
+        // no bucket of the same priority, share the closest one
+        closest_bucket = closest_any_bucket;
+        closest_bucket_interval_delta = closest_any_bucket_interval_delta;
+    }
+
     if (closest_bucket == -1 && empty_bucket_id == -1) {
         // gah?!
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -1284,6 +1405,7 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
         // allocate a bucket for this interval
         deferred_message_bucket[empty_bucket_id].interval_ms = interval_ms;
         deferred_message_bucket[empty_bucket_id].last_sent_ms = AP_HAL::millis16();
+        deferred_message_bucket[empty_bucket_id].priority = priority;
         closest_bucket = empty_bucket_id;
     }
 
@@ -1555,6 +1677,9 @@ void GCS_MAVLINK::log_mavlink_stats()
     flags                  : flags,
     stream_slowdown_ms     : stream_slowdown_ms,
     times_full             : out_of_space_to_send_count,
+    bandwidth              : link_congestion.bandwidth_Bps,
+    stream_scale           : uint16_t(link_congestion.scale * 100),
+    priority_scale         : uint16_t(link_congestion.priority_scale * 100),
     };
 
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
@@ -4857,6 +4982,20 @@ void GCS_MAVLINK::initialise_message_intervals_from_streamrates()
     set_mavlink_message_id_interval(MAVLINK_MSG_ID_HEARTBEAT, 1000);
 }
 
+bool GCS_MAVLINK::is_priority_message(const ap_message id) const
+{
+    // find which stream this ap_message is in
+    for (uint8_t i=0; all_stream_entries[i].ap_message_ids != nullptr; i++) {
+        const GCS_MAVLINK::stream_entries &entries = all_stream_entries[i];
+        for (uint8_t j=0; j<entries.num_ap_message_ids; j++) {
+            if (entries.ap_message_ids[j] == id) {
+                return (priority_streams->get() & (1U<<entries.stream_id)) != 0;
+            }
+        }
+    }
+    return false;
+}
+
 bool GCS_MAVLINK::get_default_interval_for_ap_message(const ap_message id, uint16_t &interval) const
 {
     if (id == MSG_HEARTBEAT) {
@@ -28,6 +28,13 @@ struct GCS_MAVLINK::ftp_state GCS_MAVLINK::ftp;
 // timeout for session inactivity
 #define FTP_SESSION_TIMEOUT 3000
 
+// number of chunks sent in response to a burst read request
+#define FTP_BURST_SIZE 100
+
+// reply queue slots kept free by burst reads so re-requests can be
+// answered while a burst is streaming
+#define FTP_BURST_REPLY_RESERVE 4
+
 bool GCS_MAVLINK::ftp_init(void) {
     // we can simply check if we allocated everything we need
     if (ftp.requests != nullptr) {
@@ -163,6 +170,103 @@ void GCS_MAVLINK::ftp_push_replies(pending_ftp &reply)
     }
 }
 
+// read and queue the next chunk of the active burst read, returns
+// false if there was nothing that could be sent
+bool GCS_MAVLINK::ftp_burst_step(void)
+{
+    if (!ftp.burst.active) {
+        return false;
+    }
+    if (ftp.replies->space() <= FTP_BURST_REPLY_RESERVE) {
+        // wait for the reply queue to drain
+        return false;
+    }
+
+    pending_ftp &reply = ftp.burst.reply;
+
+    if (ftp.burst.need_seek) {
+        if (AP::FS().lseek(ftp.fd, ftp.burst.offset, SEEK_SET) == -1) {
+            ftp_error(reply, FTP_ERROR::FailErrno);
+            ftp.burst.active = false;
+            ftp_push_replies(reply);
+            return true;
+        }
+        ftp.burst.need_seek = false;
+    }
+
+    // fill the buffer
+    const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, ftp.burst.max_read);
+    if (read_bytes == -1) {
+        ftp_error(reply, FTP_ERROR::FailErrno);
+        ftp.burst.active = false;
+        ftp_push_replies(reply);
+        return true;
+    }
+
+    if (read_bytes != sizeof(reply.data)) {
+        // don't send any old data
+        memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
+    }
+
+    reply.offset = ftp.burst.offset;
+
+    if (read_bytes == 0) {
+        ftp_error(reply, FTP_ERROR::EndOfFile);
+        ftp.burst.active = false;
+        ftp_push_replies(reply);
+        return true;
+    }
+
+    ftp.burst.remaining--;
+    reply.opcode = FTP_OP::Ack;
+    reply.burst_complete = (ftp.burst.remaining == 0);
+    reply.size = (uint8_t)read_bytes;
+
+    ftp_push_replies(reply);
+    ftp_read_stats(read_bytes);
+
+    // prep the reply to be used again
+    reply.seq_number++;
+    ftp.burst.offset += read_bytes;
+    if (ftp.burst.remaining == 0) {
+        ftp.burst.active = false;
+    }
+
+    return true;
+}
+
+// accumulate the number of bytes read by the GCS in this session
+void GCS_MAVLINK::ftp_read_stats(uint32_t bytes)
+{
+    const uint32_t now = AP_HAL::millis();
+    if (ftp.stats.bytes == 0) {
+        ftp.stats.start_ms = now;
+    }
+    ftp.stats.bytes += bytes;
+    ftp.stats.last_ms = now;
+}
+
+// close the file of the current session, reporting the achieved
+// throughput if it was read from
+void GCS_MAVLINK::ftp_close_file(void)
+{
+    ftp.burst.active = false;
+    if (ftp.fd == -1) {
+        return;
+    }
+    AP::FS().close(ftp.fd);
+    ftp.fd = -1;
+
+    if (ftp.mode == FTP_FILE_MODE::Read && ftp.stats.bytes > 0) {
+        const uint32_t dt_ms = MAX(ftp.stats.last_ms - ftp.stats.start_ms, 1U);
+        gcs().send_text(MAV_SEVERITY_DEBUG, "FTP: read %u bytes at %u B/s, %u rereads",
+                        (unsigned)ftp.stats.bytes,
+                        (unsigned)(uint64_t(ftp.stats.bytes) * 1000U / dt_ms),
+                        (unsigned)ftp.stats.rereads);
+    }
+    memset(&ftp.stats, 0, sizeof(ftp.stats));
+}
+
 void GCS_MAVLINK::ftp_worker(void) {
     pending_ftp request;
     pending_ftp reply = {};
@@ -172,8 +276,12 @@ void GCS_MAVLINK::ftp_worker(void) {
         bool skip_push_reply = false;
 
         while (!ftp.requests->pop(request)) {
-            // nothing to handle, delay ourselves a bit then check again. Ideally we'd use conditional waits here
-            hal.scheduler->delay(2);
+            // no new requests, read ahead the next chunk of any active
+            // burst. Otherwise delay ourselves a bit then check
+            // again. Ideally we'd use conditional waits here
+            if (!ftp_burst_step()) {
+                hal.scheduler->delay(2);
+            }
         }
 
         // if it's a rerequest and we still have the last response then send it
@@ -218,8 +326,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                 // if a new session appears and the old session has
                 // been idle for more than the timeout then force
                 // close the old session
-                AP::FS().close(ftp.fd);
-                ftp.fd = -1;
+                ftp_close_file();
                 ftp.current_session = -1;
             }
             // dispatch the command as needed
@@ -230,10 +337,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                 case FTP_OP::TerminateSession:
                 case FTP_OP::ResetSessions:
                     // we already handled this, just listed for completeness
-                    if (ftp.fd != -1) {
-                        AP::FS().close(ftp.fd);
-                        ftp.fd = -1;
-                    }
+                    ftp_close_file();
                     ftp.current_session = -1;
                     reply.opcode = FTP_OP::Ack;
                     break;
@@ -247,8 +351,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                             // no activity for 3s, assume client has
                             // timed out receiving open reply, close
                             // the file
-                            AP::FS().close(ftp.fd);
-                            ftp.fd = -1;
+                            ftp_close_file();
                             ftp.current_session = -1;
                         }
                         if (ftp.fd != -1) {
@@ -281,6 +384,7 @@ void GCS_MAVLINK::ftp_worker(void) {
                         }
                         ftp.mode = FTP_FILE_MODE::Read;
                         ftp.current_session = request.session;
+                        memset(&ftp.stats, 0, sizeof(ftp.stats));
 
                         reply.opcode = FTP_OP::Ack;
                         reply.size = sizeof(uint32_t);
@@ -306,7 +410,9 @@ void GCS_MAVLINK::ftp_worker(void) {
                             break;
                         }
 
-                        // seek to requested offset
+                        // seek to requested offset, any active burst
+                        // carries on from its own offset afterwards
+                        ftp.burst.need_seek = true;
                         if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
@@ -326,6 +432,10 @@ void GCS_MAVLINK::ftp_worker(void) {
                         reply.opcode = FTP_OP::Ack;
                         reply.offset = request.offset;
                         reply.size = (uint8_t)read_bytes;
+                        if (ftp.stats.burst_used) {
+                            ftp.stats.rereads++;
+                        }
+                        ftp_read_stats(read_bytes);
                         break;
                     }
                 case FTP_OP::Ack:
@@ -489,52 +599,22 @@ void GCS_MAVLINK::ftp_worker(void) {
                             break;
                         }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        const uint32_t transfer_size = 100;
-                        for (uint32_t i = 0; (i < transfer_size); i++) {
-                            // fill the buffer
-                            const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, max_read);
-                            if (read_bytes == -1) {
-                                ftp_error(reply, FTP_ERROR::FailErrno);
-                                break;
-                            }
-
-                            if (read_bytes != sizeof(reply.data)) {
-                                // don't send any old data
-                                memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
-                            }
-
-                            if (read_bytes == 0) {
-                                ftp_error(reply, FTP_ERROR::EndOfFile);
-                                break;
-                            }
-
-                            reply.opcode = FTP_OP::Ack;
-                            reply.offset = request.offset + i * max_read;
-                            reply.burst_complete = (i == (transfer_size - 1));
-                            reply.size = (uint8_t)read_bytes;
-
-                            ftp_push_replies(reply);
-
-                            if (read_bytes < max_read) {
-                                // ensure the NACK which we send next is at the right offset
-                                reply.offset += read_bytes;
-                            }
-
-                            // prep the reply to be used again
-                            reply.seq_number++;
-                        }
-
-                        if (reply.opcode != FTP_OP::Nack) {
-                            // prevent a duplicate packet send for
-                            // normal replies of burst reads
-                            skip_push_reply = true;
-                        }
+                        // a new burst replaces any burst still in progress
+                        // and is streamed out by ftp_burst_step() so that
+                        // re-requests for missed chunks can be serviced
+                        // while it is in flight
+                        reply.opcode = FTP_OP::Ack;
+                        ftp.burst.reply = reply;
+                        ftp.burst.offset = request.offset;
+                        ftp.burst.remaining = FTP_BURST_SIZE;
+                        ftp.burst.max_read = max_read;
+                        ftp.burst.need_seek = true;
+                        ftp.burst.active = true;
+                        ftp.stats.burst_used = true;
+
+                        // the burst replies are not available for re-sending
+                        reply.session = -1;
+                        skip_push_reply = true;
                         break;
                     }
                 case FTP_OP::TruncateFile:
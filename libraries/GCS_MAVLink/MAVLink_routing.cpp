@@ -26,8 +26,18 @@ extern const AP_HAL::HAL& hal;
 
 #define ROUTING_DEBUG 0
 
+// route_none marks the end of a hash bucket, so must not be a route index
+static_assert(MAVLINK_MAX_ROUTES < 255, "MAVLINK_MAX_ROUTES must be less than 255");
+
 // constructor
-MAVLink_routing::MAVLink_routing(void) : num_routes(0) {}
+MAVLink_routing::MAVLink_routing(void) :
+    num_routes(0),
+    route_channel_mask(0),
+    entry_cache(),
+    no_route_mask(0)
+{
+    memset(route_hash, route_none, sizeof(route_hash));
+}
 
 /*
   forward a MAVLink message to the right port. This also
@@ -139,34 +149,68 @@ bool MAVLink_routing::check_and_forward(mavlink_channel_t in_channel, const mavl
         return true;
     }
 
+    // fast path, no other channel has a route so there is nothing
+    // to forward
+    const uint16_t in_mask = 1U<<(in_channel-MAVLINK_COMM_0);
+    if ((route_channel_mask & ~in_mask) == 0) {
+        return match_system;
+    }
+
     // forward on any channels matching the targets
     bool forwarded = false;
     bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS];
     memset(sent_to_chan, 0, sizeof(sent_to_chan));
-    for (uint8_t i=0; i<num_routes; i++) {
+    sent_to_chan[in_channel-MAVLINK_COMM_0] = true;
 
-        if (broadcast_system || (target_system == routes[i].sysid &&
-                                 (broadcast_component || 
-                                  target_component == routes[i].compid ||
-                                  !match_system))) {
-
-            if (in_channel != routes[i].channel && !sent_to_chan[routes[i].channel]) {
-                
-                if (comm_get_txspace(routes[i].channel) >= ((uint16_t)msg.len) +
-                    GCS_MAVLINK::packet_overhead_chan(routes[i].channel)) {
+    if (broadcast_system) {
+        // every channel with a route gets the message
+        for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+            if (!(route_channel_mask & (1U<<i)) || sent_to_chan[i]) {
+                continue;
+            }
+            const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+            if (comm_get_txspace(channel) >= ((uint16_t)msg.len) +
+                GCS_MAVLINK::packet_overhead_chan(channel)) {
+#if ROUTING_DEBUG
+                ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
+                         msg.msgid,
+                         (unsigned)in_channel,
+                         (unsigned)channel,
+                         (int)target_system,
+                         (int)target_component);
+#endif
+                _mavlink_resend_uart(channel, &msg);
+            }
+            sent_to_chan[i] = true;
+            forwarded = true;
+        }
+    } else {
+        // only routes for the target system need to be checked
+        for (uint8_t i=route_hash[route_bucket(target_system)]; i != route_none; i=routes[i].next) {
+            if (target_system != routes[i].sysid ||
+                !(broadcast_component ||
+                  target_component == routes[i].compid ||
+                  !match_system)) {
+                continue;
+            }
+            const mavlink_channel_t channel = routes[i].channel;
+            if (sent_to_chan[channel-MAVLINK_COMM_0]) {
+                continue;
+            }
+            if (comm_get_txspace(channel) >= ((uint16_t)msg.len) +
+                GCS_MAVLINK::packet_overhead_chan(channel)) {
 #if ROUTING_DEBUG
-                    ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
-                             msg.msgid,
-                             (unsigned)in_channel,
-                             (unsigned)routes[i].channel,
-                             (int)target_system,
-                             (int)target_component);
+                ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
+                         msg.msgid,
+                         (unsigned)in_channel,
+                         (unsigned)channel,
+                         (int)target_system,
+                         (int)target_component);
 #endif
-                    _mavlink_resend_uart(routes[i].channel, &msg);
-                }
-                sent_to_chan[routes[i].channel] = true;
-                forwarded = true;
+                _mavlink_resend_uart(channel, &msg);
             }
+            sent_to_chan[channel-MAVLINK_COMM_0] = true;
+            forwarded = true;
         }
     }
 
@@ -196,7 +240,7 @@ void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entr
     bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS] {};
 
     // check learned routes
-    for (uint8_t i=0; i<num_routes; i++) {
+    for (uint8_t i=route_hash[route_bucket(mavlink_system.sysid)]; i != route_none; i=routes[i].next) {
         if (routes[i].sysid != mavlink_system.sysid) {
             // our system ID hasn't been seen on this link
             continue;
@@ -258,36 +302,108 @@ bool MAVLink_routing::find_by_mavtype(uint8_t mavtype, uint8_t &sysid, uint8_t &
 */
 void MAVLink_routing::learn_route(mavlink_channel_t in_channel, const mavlink_message_t &msg)
 {
-    uint8_t i;
     if (msg.sysid == 0 ||
         (msg.sysid == mavlink_system.sysid &&
          msg.compid == mavlink_system.compid)) {
         return;
     }
-    for (i=0; i<num_routes; i++) {
+    const uint32_t now_ms = AP_HAL::millis();
+    for (uint8_t i=route_hash[route_bucket(msg.sysid)]; i != route_none; i=routes[i].next) {
         if (routes[i].sysid == msg.sysid &&
             routes[i].compid == msg.compid &&
             routes[i].channel == in_channel) {
             if (routes[i].mavtype == 0 && msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
                 routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
             }
-            break;
+            routes[i].last_seen_ms = now_ms;
+            return;
         }
     }
-    if (i == num_routes && i<MAVLINK_MAX_ROUTES) {
-        routes[i].sysid = msg.sysid;
-        routes[i].compid = msg.compid;
-        routes[i].channel = in_channel;
-        if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-            routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+    uint8_t i;
+    if (!route_alloc(i)) {
+        return;
+    }
+    routes[i].sysid = msg.sysid;
+    routes[i].compid = msg.compid;
+    routes[i].channel = in_channel;
+    routes[i].mavtype = 0;
+    if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+    }
+    routes[i].last_seen_ms = now_ms;
+    route_link(i);
+    update_route_channel_mask();
+#if ROUTING_DEBUG
+    ::printf("learned route %u %u via %u\n",
+             (unsigned)msg.sysid,
+             (unsigned)msg.compid,
+             (unsigned)in_channel);
+#endif
+}
+
+/*
+  find a slot for a new route. If the table is full then the route
+  which has gone unseen the longest is replaced, provided it has not
+  been seen for MAVLINK_ROUTE_TIMEOUT_MS
+*/
+bool MAVLink_routing::route_alloc(uint8_t &i)
+{
+    if (num_routes < MAVLINK_MAX_ROUTES) {
+        i = num_routes++;
+        return true;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    uint32_t oldest_ms = MAVLINK_ROUTE_TIMEOUT_MS;
+    bool found = false;
+    for (uint8_t j=0; j<num_routes; j++) {
+        const uint32_t age_ms = now_ms - routes[j].last_seen_ms;
+        if (age_ms >= oldest_ms) {
+            oldest_ms = age_ms;
+            i = j;
+            found = true;
         }
-        num_routes++;
+    }
+    if (!found) {
+        return false;
+    }
 #if ROUTING_DEBUG
-        ::printf("learned route %u %u via %u\n",
-                 (unsigned)msg.sysid,
-                 (unsigned)msg.compid,
-                 (unsigned)in_channel);
+    ::printf("expired route %u %u via %u\n",
+             (unsigned)routes[i].sysid,
+             (unsigned)routes[i].compid,
+             (unsigned)routes[i].channel);
 #endif
+    route_unlink(i);
+    return true;
+}
+
+// add a route to the front of its hash bucket
+void MAVLink_routing::route_link(uint8_t i)
+{
+    const uint8_t b = route_bucket(routes[i].sysid);
+    routes[i].next = route_hash[b];
+    route_hash[b] = i;
+}
+
+// remove a route from its hash bucket
+void MAVLink_routing::route_unlink(uint8_t i)
+{
+    uint8_t *p = &route_hash[route_bucket(routes[i].sysid)];
+    while (*p != route_none) {
+        if (*p == i) {
+            *p = routes[i].next;
+            break;
+        }
+        p = &routes[*p].next;
+    }
+    routes[i].next = route_none;
+}
+
+// update the mask of channels which have at least one route
+void MAVLink_routing::update_route_channel_mask()
+{
+    route_channel_mask = 0;
+    for (uint8_t i=0; i<num_routes; i++) {
+        route_channel_mask |= 1U<<(routes[i].channel-MAVLINK_COMM_0);
     }
 }
 
@@ -309,7 +425,7 @@ void MAVLink_routing::handle_heartbeat(mavlink_channel_t in_channel, const mavli
     mask &= ~no_route_mask;
     
     // mask out channels that are known sources for this sysid/compid
-    for (uint8_t i=0; i<num_routes; i++) {
+    for (uint8_t i=route_hash[route_bucket(msg.sysid)]; i != route_none; i=routes[i].next) {
         if (routes[i].sysid == msg.sysid && routes[i].compid == msg.compid) {
             mask &= ~(1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0)));
         }
@@ -347,9 +463,16 @@ void MAVLink_routing::handle_heartbeat(mavlink_channel_t in_channel, const mavli
 */
 void MAVLink_routing::get_targets(const mavlink_message_t &msg, int16_t &sysid, int16_t &compid)
 {
-    const mavlink_msg_entry_t *msg_entry = mavlink_get_msg_entry(msg.msgid);
-    if (msg_entry == nullptr) {
-        return;
+    // the same few messages make up most traffic, so keep their
+    // entries to avoid searching the message table for every packet
+    const mavlink_msg_entry_t *&cached = entry_cache[msg.msgid % MAVLINK_ROUTE_ENTRY_CACHE_SIZE];
+    const mavlink_msg_entry_t *msg_entry = cached;
+    if (msg_entry == nullptr || msg_entry->msgid != msg.msgid) {
+        msg_entry = mavlink_get_msg_entry(msg.msgid);
+        if (msg_entry == nullptr) {
+            return;
+        }
+        cached = msg_entry;
     }
     if (msg_entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) {
         sysid = _MAV_RETURN_uint8_t(&msg,  msg_entry->target_system_ofs);
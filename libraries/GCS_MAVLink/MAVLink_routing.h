@@ -6,9 +6,31 @@
 #include <AP_Common/AP_Common.h>
 #include "GCS_MAVLink.h"
 
-// 20 routes should be enough for now. This may need to increase as
-// we make more extensive use of MAVLink forwarding
+// number of routes, sized for boards which may be used as routing
+// hubs for many components. Must be less than 255
+#ifndef MAVLINK_MAX_ROUTES
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_1000
+#define MAVLINK_MAX_ROUTES 64
+#elif HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define MAVLINK_MAX_ROUTES 32
+#else
 #define MAVLINK_MAX_ROUTES 20
+#endif
+#endif
+
+// number of hash buckets for routes, indexed by sysid. Must be a power of 2
+#ifndef MAVLINK_ROUTE_HASH_SIZE
+#define MAVLINK_ROUTE_HASH_SIZE 32
+#endif
+
+// a route which has not been seen for this long may be replaced by a
+// new route when the table is full
+#ifndef MAVLINK_ROUTE_TIMEOUT_MS
+#define MAVLINK_ROUTE_TIMEOUT_MS 30000
+#endif
+
+// number of cached message entries used to find target fields
+#define MAVLINK_ROUTE_ENTRY_CACHE_SIZE 16
 
 /*
   object to handle MAVLink packet routing
@@ -45,22 +67,48 @@ public:
     bool find_by_mavtype(uint8_t mavtype, uint8_t &sysid, uint8_t &compid, mavlink_channel_t &channel);
 
 private:
-    // a simple linear routing table. We don't expect to have a lot of
-    // routes, so a scalable structure isn't worthwhile yet.
+    // the routing table. Routes are chained into hash buckets by
+    // sysid so that learning and forwarding only look at routes for
+    // the sysid of interest
+    static constexpr uint8_t route_none = 0xFF;
     uint8_t num_routes;
     struct route {
         uint8_t sysid;
         uint8_t compid;
         mavlink_channel_t channel;
         uint8_t mavtype;
+        uint8_t next;           // next route in the same hash bucket
+        uint32_t last_seen_ms;
     } routes[MAVLINK_MAX_ROUTES];
-    
+    uint8_t route_hash[MAVLINK_ROUTE_HASH_SIZE];
+
+    // mask of channels which have at least one route
+    uint16_t route_channel_mask;
+
+    // recently used message entries, indexed by msgid
+    const mavlink_msg_entry_t *entry_cache[MAVLINK_ROUTE_ENTRY_CACHE_SIZE];
+
     // a channel mask to block routing as required
     uint8_t no_route_mask;
     
     // learn new routes
     void learn_route(mavlink_channel_t in_channel, const mavlink_message_t &msg);
 
+    // hash bucket for a sysid
+    static uint8_t route_bucket(uint8_t sysid) {
+        return sysid & (MAVLINK_ROUTE_HASH_SIZE-1);
+    }
+
+    // add and remove routes from the hash buckets
+    void route_link(uint8_t i);
+    void route_unlink(uint8_t i);
+
+    // find a slot for a new route, replacing the oldest stale route if the table is full
+    bool route_alloc(uint8_t &i);
+
+    // update the mask of channels with routes
+    void update_route_channel_mask();
+
     // extract target sysid and compid from a message
     void get_targets(const mavlink_message_t &msg, int16_t &sysid, int16_t &compid);
 
@@ -0,0 +1,75 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <GCS_MAVLink/GCS.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+#include <AP_SerialManager/AP_SerialManager.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+AP_SerialManager _serialmanager;
+GCS_Dummy _gcs;
+
+const AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+/*
+  per-packet routing cost with a hub of state.range(0) components
+  spread over three links. Packets arrive on channel 0 and the links
+  have no transmit space, so this measures the routing decision and
+  not the cost of sending
+ */
+static const uint8_t num_links = 3;
+
+static void learn_routes(MAVLink_routing &routing, uint8_t num_components)
+{
+    mavlink_message_t msg;
+    mavlink_heartbeat_t heartbeat {};
+    for (uint8_t i=0; i<num_components; i++) {
+        mavlink_msg_heartbeat_encode(10 + i/4, 1 + i%4, &msg, &heartbeat);
+        routing.check_and_forward((mavlink_channel_t)(MAVLINK_COMM_1 + i%num_links), msg);
+    }
+}
+
+static void BM_RoutingTargeted(benchmark::State& state)
+{
+    MAVLink_routing routing;
+    const uint8_t num_components = state.range(0);
+    learn_routes(routing, num_components);
+
+    mavlink_message_t msg[16];
+    mavlink_param_set_t param_set {};
+    for (uint8_t i=0; i<ARRAY_SIZE(msg); i++) {
+        const uint8_t c = (i * 7) % num_components;
+        param_set.target_system = 10 + c/4;
+        param_set.target_component = 1 + c%4;
+        mavlink_msg_param_set_encode(255, 190, &msg[i], &param_set);
+    }
+
+    uint8_t i = 0;
+    while (state.KeepRunning()) {
+        bool local = routing.check_and_forward(MAVLINK_COMM_0, msg[i++ % ARRAY_SIZE(msg)]);
+        gbenchmark_escape(&local);
+    }
+}
+
+static void BM_RoutingBroadcast(benchmark::State& state)
+{
+    MAVLink_routing routing;
+    learn_routes(routing, state.range(0));
+
+    mavlink_message_t msg;
+    mavlink_attitude_t attitude {};
+    mavlink_msg_attitude_encode(255, 190, &msg, &attitude);
+
+    while (state.KeepRunning()) {
+        bool local = routing.check_and_forward(MAVLINK_COMM_0, msg);
+        gbenchmark_escape(&local);
+    }
+}
+
+BENCHMARK(BM_RoutingTargeted)->Arg(4)->Arg(16)->Arg(MAVLINK_MAX_ROUTES);
+BENCHMARK(BM_RoutingBroadcast)->Arg(4)->Arg(16)->Arg(MAVLINK_MAX_ROUTES);
+
+BENCHMARK_MAIN();
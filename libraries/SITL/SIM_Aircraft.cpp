@@ -257,6 +257,10 @@ void Aircraft::adjust_frame_time(float new_rate)
 void Aircraft::sync_frame_time(void)
 {
     frame_counter++;
+    if (target_speedup <= 0) {
+        // as fast as possible, never wait for the wall clock
+        return;
+    }
     uint64_t now = get_wall_time_us();
     uint64_t dt_us = now - last_wall_time_us;
 
@@ -443,7 +447,7 @@ void Aircraft::fill_fdm(struct sitl_fdm &fdm)
         sitl->speedup = get_speedup();
     }
     
-    if (!is_equal(last_speedup, float(sitl->speedup)) && sitl->speedup > 0) {
+    if (!is_equal(last_speedup, float(sitl->speedup)) && sitl->speedup >= 0) {
         set_speedup(sitl->speedup);
         last_speedup = sitl->speedup;
     }
@@ -288,6 +288,23 @@ void Frame::init(float _mass, float _hover_throttle, float _terminal_velocity, f
 
     terminal_velocity = _terminal_velocity;
     terminal_rotation_rate = _terminal_rotation_rate;
+
+    /*
+      an untilted motor at speed s gives thrust (0, 0, -s) at arm
+      (cos(angle), sin(angle), 0), so its rotational acceleration is
+      just a per-motor constant times s
+     */
+    fixed_motors = num_motors <= max_motors;
+    for (uint8_t i=0; i<num_motors && fixed_motors; i++) {
+        const Motor &m = motors[i];
+        if (m.is_tilting()) {
+            fixed_motors = false;
+        }
+        motor_servo[i] = m.servo;
+        roll_arm[i] = -Motor::arm_scale * sinf(radians(m.angle));
+        pitch_arm[i] = Motor::arm_scale * cosf(radians(m.angle));
+        yaw_torque[i] = m.yaw_factor * Motor::yaw_scale;
+    }
 }
 
 /*
@@ -318,14 +335,13 @@ void Frame::calculate_forces(const Aircraft &aircraft,
     // scale thrust for altitude
     float scaling = thrust_scale * AP::baro().get_air_density_ratio();
 
-    for (uint8_t i=0; i<num_motors; i++) {
-        Vector3f mraccel, mthrust;
-        motors[i].calculate_forces(input, scaling, motor_offset, mraccel, mthrust);
-        rot_accel += mraccel;
-        thrust += mthrust;
-        // simulate motor rpm
-        if (!is_zero(AP::sitl()->vibe_motor)) {
-            rpm[i] = sqrtf(mthrust.length() / scaling) * AP::sitl()->vibe_motor * 60.0f;
+    float motor_speed[max_motors];
+    calculate_motor_forces(input, scaling, rot_accel, thrust, motor_speed);
+
+    // simulate motor rpm
+    if (!is_zero(AP::sitl()->vibe_motor)) {
+        for (uint8_t i=0; i<num_motors; i++) {
+            rpm[i] = sqrtf(motor_speed[i]) * AP::sitl()->vibe_motor * 60.0f;
         }
     }
 
@@ -357,6 +373,42 @@ void Frame::calculate_forces(const Aircraft &aircraft,
                            aircraft.rand_normal(0, 1)) * accel_noise * noise_scale;
 }
 
+/*
+  sum the rotational acceleration and thrust of all motors
+ */
+void Frame::calculate_motor_forces(const struct sitl_input &input, float thrust_scaling,
+                                   Vector3f &rot_accel, Vector3f &thrust, float *motor_speed)
+{
+    rot_accel.zero();
+    thrust.zero();
+
+    if (!fixed_motors) {
+        // tilting motors need the full per-motor calculation
+        for (uint8_t i=0; i<num_motors; i++) {
+            Vector3f mraccel, mthrust;
+            motors[i].calculate_forces(input, thrust_scaling, motor_offset, mraccel, mthrust);
+            rot_accel += mraccel;
+            thrust += mthrust;
+            motor_speed[i] = mthrust.length() / thrust_scaling;
+        }
+        return;
+    }
+
+    for (uint8_t i=0; i<num_motors; i++) {
+        motor_speed[i] = constrain_float((input.servos[motor_offset+motor_servo[i]]-1100)/900.0f, 0, 1);
+    }
+
+    float roll = 0, pitch = 0, yaw = 0, total = 0;
+    for (uint8_t i=0; i<num_motors; i++) {
+        roll += roll_arm[i] * motor_speed[i];
+        pitch += pitch_arm[i] * motor_speed[i];
+        yaw += yaw_torque[i] * motor_speed[i];
+        total += motor_speed[i];
+    }
+
+    rot_accel = Vector3f(roll, pitch, yaw);
+    thrust = Vector3f(0, 0, -total * thrust_scaling);
+}
 
 // calculate current and voltage
 void Frame::current_and_voltage(const struct sitl_input &input, float &voltage, float &current)
@@ -50,7 +50,15 @@ public:
     void calculate_forces(const Aircraft &aircraft,
                           const struct sitl_input &input,
                           Vector3f &rot_accel, Vector3f &body_accel, float* rpm);
-    
+
+    // sum the rotational acceleration and thrust of all motors,
+    // filling in the speed of each motor from 0 to 1
+    void calculate_motor_forces(const struct sitl_input &input, float thrust_scaling,
+                                Vector3f &rot_accel, Vector3f &thrust, float *motor_speed);
+
+    // largest number of motors on a frame
+    static constexpr uint8_t max_motors = 12;
+
     float terminal_velocity;
     float terminal_rotation_rate;
     float thrust_scale;
@@ -58,5 +66,17 @@ public:
 
     // calculate current and voltage
     void current_and_voltage(const struct sitl_input &input, float &voltage, float &current);
+
+private:
+    /*
+      geometry of each motor, precomputed by init() as arrays so the
+      forces of all motors are summed in straight line loops the
+      compiler can vectorise. Only used when no motor can tilt
+     */
+    bool fixed_motors;
+    uint8_t motor_servo[max_motors];
+    float roll_arm[max_motors];
+    float pitch_arm[max_motors];
+    float yaw_torque[max_motors];
 };
 }
@@ -28,12 +28,8 @@ void Motor::calculate_forces(const struct sitl_input &input,
                              Vector3f &rot_accel,
                              Vector3f &thrust)
 {
-    // fudge factors
-    const float arm_scale = radians(5000);
-    const float yaw_scale = radians(400);
-
     // get motor speed from 0 to 1
-    float motor_speed = constrain_float((input.servos[motor_offset+servo]-1100)/900.0, 0, 1);
+    const float motor_speed = get_speed(input, motor_offset);
 
     // the yaw torque of the motor
     Vector3f rotor_torque(0, 0, yaw_factor * motor_speed * yaw_scale);
@@ -115,7 +111,7 @@ void Motor::current_and_voltage(const struct sitl_input &input, float &voltage,
                                 uint8_t motor_offset)
 {
     // get motor speed from 0 to 1
-    float motor_speed = constrain_float((input.servos[motor_offset+servo]-1100)/900.0, 0, 1);
+    const float motor_speed = get_speed(input, motor_offset);
 
     // assume 10A per motor at full speed
     current = 10 * motor_speed;
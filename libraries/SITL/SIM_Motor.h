@@ -32,6 +32,10 @@ public:
     uint8_t servo;
     uint8_t display_order;
 
+    // fudge factors from motor speed to rotational acceleration
+    static constexpr float arm_scale = radians(5000);
+    static constexpr float yaw_scale = radians(400);
+
     // support for tilting motors
     int8_t roll_servo = -1;
     float roll_min, roll_max;
@@ -75,6 +79,14 @@ public:
                           Vector3f &rot_accel, // rad/sec
                           Vector3f &body_thrust); // Z is down
 
+    // true if this motor can be tilted by a servo
+    bool is_tilting() const { return roll_servo >= 0 || pitch_servo >= 0; }
+
+    // get motor speed from 0 to 1
+    float get_speed(const struct sitl_input &input, uint8_t motor_offset) const {
+        return constrain_float((input.servos[motor_offset+servo]-1100)/900.0f, 0, 1);
+    }
+
     uint16_t update_servo(uint16_t demand, uint64_t time_usec, float &last_value);
 
     // calculate current and voltage
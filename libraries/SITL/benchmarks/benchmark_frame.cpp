@@ -0,0 +1,63 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <SITL/SIM_Frame.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+using namespace SITL;
+
+/*
+  cost of summing the motor forces of a frame, comparing the per-motor
+  calculation against the precomputed arrays used for untilted frames
+ */
+static Frame *setup_frame(const char *name, struct sitl_input &input)
+{
+    Frame *frame = Frame::find_frame(name);
+    frame->init(1.5, 0.5, 15, 4*radians(360));
+    for (uint8_t i=0; i<ARRAY_SIZE(input.servos); i++) {
+        input.servos[i] = 1500 + i*10;
+    }
+    return frame;
+}
+
+static void BM_MotorForces(benchmark::State& state, const char *name)
+{
+    struct sitl_input input {};
+    Frame *frame = setup_frame(name, input);
+
+    while (state.KeepRunning()) {
+        Vector3f rot_accel, thrust;
+        for (uint8_t i=0; i<frame->num_motors; i++) {
+            Vector3f mraccel, mthrust;
+            frame->motors[i].calculate_forces(input, frame->thrust_scale, 0, mraccel, mthrust);
+            rot_accel += mraccel;
+            thrust += mthrust;
+        }
+        gbenchmark_escape(&rot_accel);
+        gbenchmark_escape(&thrust);
+    }
+}
+
+static void BM_FrameForces(benchmark::State& state, const char *name)
+{
+    struct sitl_input input {};
+    Frame *frame = setup_frame(name, input);
+
+    while (state.KeepRunning()) {
+        Vector3f rot_accel, thrust;
+        float motor_speed[Frame::max_motors];
+        frame->calculate_motor_forces(input, frame->thrust_scale, rot_accel, thrust, motor_speed);
+        gbenchmark_escape(&rot_accel);
+        gbenchmark_escape(&thrust);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_MotorForces, quad, "x");
+BENCHMARK_CAPTURE(BM_FrameForces, quad, "x");
+BENCHMARK_CAPTURE(BM_MotorForces, hexa, "hexax");
+BENCHMARK_CAPTURE(BM_FrameForces, hexa, "hexax");
+BENCHMARK_CAPTURE(BM_MotorForces, octa, "octa");
+BENCHMARK_CAPTURE(BM_FrameForces, octa, "octa");
+
+BENCHMARK_MAIN();